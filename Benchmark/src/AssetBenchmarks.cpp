@@ -0,0 +1,148 @@
+#include "Benchmarks.h"
+
+#include <Seidon.h>
+
+#include <memory>
+
+namespace Seidon
+{
+	static constexpr int SUBMESH_COUNT = 4;
+	static constexpr int VERTICES_PER_SUBMESH = 65536;
+
+	static constexpr int COMPONENT_COUNT = 10000;
+
+	static Mesh* CreateSyntheticMesh()
+	{
+		Mesh* mesh = new Mesh();
+		mesh->name = "Benchmark Mesh";
+
+		for (int i = 0; i < SUBMESH_COUNT; i++)
+		{
+			Submesh* submesh = new Submesh();
+			submesh->name = "Submesh " + std::to_string(i);
+
+			submesh->vertices.resize(VERTICES_PER_SUBMESH);
+			for (int j = 0; j < VERTICES_PER_SUBMESH; j++)
+			{
+				Vertex& vertex = submesh->vertices[j];
+				vertex.position = glm::vec3(j % 256, j / 256, i);
+				vertex.normal = glm::vec3(0, 1, 0);
+				vertex.tangent = glm::vec3(1, 0, 0);
+				vertex.texCoords = glm::vec2((j % 256) / 255.0f, (j / 256) / 255.0f);
+			}
+
+			submesh->indices.resize(VERTICES_PER_SUBMESH * 3 / 2);
+			for (int j = 0; j < submesh->indices.size(); j++)
+				submesh->indices[j] = (j * 7) % VERTICES_PER_SUBMESH;
+
+			mesh->subMeshes.push_back(submesh);
+		}
+
+		return mesh;
+	}
+
+	// Meshes don't own their submeshes
+	static void DeleteMesh(Mesh* mesh)
+	{
+		if (!mesh) return;
+
+		for (Submesh* submesh : mesh->subMeshes)
+			delete submesh;
+
+		delete mesh;
+	}
+
+	void RegisterAssetBenchmarks(BenchmarkRunner& runner)
+	{
+		struct State
+		{
+			Mesh* mesh = nullptr;
+			std::vector<TransformComponent> components;
+		};
+
+		std::shared_ptr<State> state = std::make_shared<State>();
+		std::string meshPath = BenchmarkRunner::GetTemporaryPath("Mesh.sdmesh");
+		std::string componentsPath = BenchmarkRunner::GetTemporaryPath("Components.bin");
+
+		auto deleteMesh = [state]()
+		{
+			DeleteMesh(state->mesh);
+			state->mesh = nullptr;
+		};
+
+		runner.Add("Mesh Save", SUBMESH_COUNT * VERTICES_PER_SUBMESH,
+			[state, meshPath]()
+			{
+				BinaryWriter out(meshPath);
+				state->mesh->Save(out);
+			},
+			[state]() { state->mesh = CreateSyntheticMesh(); },
+			deleteMesh
+		);
+
+		runner.Add("Mesh Load", SUBMESH_COUNT * VERTICES_PER_SUBMESH,
+			[state, meshPath]()
+			{
+				state->mesh = new Mesh();
+				state->mesh->Load(meshPath);
+			},
+			[meshPath]()
+			{
+				Mesh* mesh = CreateSyntheticMesh();
+
+				BinaryWriter out(meshPath);
+				mesh->Save(out);
+
+				DeleteMesh(mesh);
+			},
+			deleteMesh
+		);
+
+		auto createComponents = [state]()
+		{
+			state->components.resize(COMPONENT_COUNT);
+
+			for (int i = 0; i < COMPONENT_COUNT; i++)
+			{
+				TransformComponent& transform = state->components[i];
+				transform.position = glm::vec3(i, i * 2, i * 3);
+				transform.children = { UUID(), UUID() };
+			}
+		};
+
+		runner.Add("MetaType Save", COMPONENT_COUNT,
+			[state, componentsPath]()
+			{
+				ComponentMetaType metaType = Application::Get()->GetComponentMetaTypeByName(typeid(TransformComponent).name());
+				BinaryWriter out(componentsPath);
+
+				for (TransformComponent& transform : state->components)
+					metaType.Save(out, (byte*)&transform);
+			},
+			createComponents,
+			[state]() { state->components.clear(); }
+		);
+
+		runner.Add("MetaType Load", COMPONENT_COUNT,
+			[state, componentsPath]()
+			{
+				ComponentMetaType metaType = Application::Get()->GetComponentMetaTypeByName(typeid(TransformComponent).name());
+				BinaryReader in(componentsPath);
+
+				for (TransformComponent& transform : state->components)
+					metaType.Load(in, (byte*)&transform);
+			},
+			[state, componentsPath, createComponents]()
+			{
+				createComponents();
+
+				ComponentMetaType metaType = Application::Get()->GetComponentMetaTypeByName(typeid(TransformComponent).name());
+				BinaryWriter out(componentsPath);
+
+				for (TransformComponent& transform : state->components)
+					metaType.Save(out, (byte*)&transform);
+			},
+			[state]() { state->components.clear(); }
+		);
+	}
+}
\ No newline at end of file
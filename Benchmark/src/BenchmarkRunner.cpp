@@ -0,0 +1,122 @@
+#include "BenchmarkRunner.h"
+
+#include <chrono>
+#include <ctime>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+namespace Seidon
+{
+	void BenchmarkRunner::Add(const std::string& name, size_t itemCount, const Function& run,
+		const Function& setup, const Function& teardown)
+	{
+		benchmarks.push_back({ name, itemCount, run, setup, teardown });
+	}
+
+	void BenchmarkRunner::Run(const std::string& filter, int iterations)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		iterations = std::max(iterations, 1);
+
+		for (Benchmark& benchmark : benchmarks)
+		{
+			if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) continue;
+
+			std::vector<double> times;
+
+			for (int i = 0; i <= iterations; i++)
+			{
+				if (benchmark.setup) benchmark.setup();
+
+				Clock::time_point start = Clock::now();
+				benchmark.run();
+				double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+				if (benchmark.teardown) benchmark.teardown();
+
+				// The first run only warms up caches and allocators
+				if (i > 0) times.push_back(elapsed);
+			}
+
+			std::sort(times.begin(), times.end());
+
+			BenchmarkResult result;
+			result.name = benchmark.name;
+			result.iterations = iterations;
+			result.itemCount = benchmark.itemCount;
+			result.minMs = times.front();
+			result.maxMs = times.back();
+			result.medianMs = times.size() % 2 ? times[times.size() / 2] : (times[times.size() / 2 - 1] + times[times.size() / 2]) / 2;
+
+			for (double time : times)
+				result.meanMs += time;
+			result.meanMs /= times.size();
+
+			std::cout << std::left << std::setw(32) << result.name << std::right << std::fixed << std::setprecision(3)
+				<< " mean " << std::setw(10) << result.meanMs << " ms"
+				<< " | min " << std::setw(10) << result.minMs << " ms"
+				<< " | max " << std::setw(10) << result.maxMs << " ms" << std::endl;
+
+			results.push_back(result);
+		}
+	}
+
+	bool BenchmarkRunner::WriteReport(const std::string& path)
+	{
+		std::ofstream out(path, std::ios::out);
+
+		if (!out)
+		{
+			std::cerr << "Error opening benchmark report: " << path << std::endl;
+			return false;
+		}
+
+#if defined(SD_DEBUG)
+		const char* configuration = "Checked";
+#elif defined(_DEBUG)
+		const char* configuration = "Debug";
+#else
+		const char* configuration = "Release";
+#endif
+
+		out << std::fixed << std::setprecision(6);
+
+		out << "{\n";
+		out << "\t\"configuration\": \"" << configuration << "\",\n";
+		out << "\t\"timestamp\": " << (long long)std::time(nullptr) << ",\n";
+		out << "\t\"hardwareThreads\": " << std::thread::hardware_concurrency() << ",\n";
+		out << "\t\"benchmarks\": [\n";
+
+		for (int i = 0; i < results.size(); i++)
+		{
+			BenchmarkResult& result = results[i];
+			double itemsPerSecond = result.meanMs > 0 ? result.itemCount / (result.meanMs / 1000.0) : 0;
+
+			out << "\t\t{ ";
+			out << "\"name\": \"" << result.name << "\", ";
+			out << "\"iterations\": " << result.iterations << ", ";
+			out << "\"items\": " << result.itemCount << ", ";
+			out << "\"minMs\": " << result.minMs << ", ";
+			out << "\"meanMs\": " << result.meanMs << ", ";
+			out << "\"medianMs\": " << result.medianMs << ", ";
+			out << "\"maxMs\": " << result.maxMs << ", ";
+			out << "\"itemsPerSecond\": " << itemsPerSecond;
+			out << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+		}
+
+		out << "\t]\n";
+		out << "}\n";
+
+		return true;
+	}
+
+	std::string BenchmarkRunner::GetTemporaryPath(const std::string& name)
+	{
+		return (std::filesystem::temp_directory_path() / ("SeidonBenchmark_" + name)).string();
+	}
+}
\ No newline at end of file
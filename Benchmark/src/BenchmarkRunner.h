@@ -0,0 +1,58 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace Seidon
+{
+	struct BenchmarkResult
+	{
+		std::string name;
+		int iterations = 0;
+
+		// Items processed by one iteration (entities, vertices...), used for the throughput
+		size_t itemCount = 0;
+
+		double minMs = 0;
+		double meanMs = 0;
+		double medianMs = 0;
+		double maxMs = 0;
+	};
+
+	/*
+	* Every benchmark runs once to warm up, then once per timed iteration. Setup and teardown
+	* run around each iteration and are not timed.
+	*/
+	class BenchmarkRunner
+	{
+	public:
+		using Function = std::function<void()>;
+
+	private:
+		struct Benchmark
+		{
+			std::string name;
+			size_t itemCount;
+			Function run;
+			Function setup;
+			Function teardown;
+		};
+
+		std::vector<Benchmark> benchmarks;
+		std::vector<BenchmarkResult> results;
+
+	public:
+		void Add(const std::string& name, size_t itemCount, const Function& run,
+			const Function& setup = nullptr, const Function& teardown = nullptr);
+
+		// Runs the benchmarks whose name contains filter, all of them if it's empty
+		void Run(const std::string& filter, int iterations);
+
+		bool WriteReport(const std::string& path);
+
+		inline const std::vector<BenchmarkResult>& GetResults() { return results; }
+
+		// Scratch file for benchmarks that need to go through the file system
+		static std::string GetTemporaryPath(const std::string& name);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+#include "BenchmarkRunner.h"
+
+namespace Seidon
+{
+	void RegisterSceneBenchmarks(BenchmarkRunner& runner);
+	void RegisterAssetBenchmarks(BenchmarkRunner& runner);
+	void RegisterMathBenchmarks(BenchmarkRunner& runner);
+
+	// Compares the SIMD math kernels against plain glm, returns the number of mismatching kernels
+	int CheckMathKernels();
+
+	// Checks that components written in place by a system reach PhysX, returns 1 on failure
+	int CheckPhysicsSync();
+
+	// Checks that IterateChanged and snapshots skip the transforms of a scene with the engine systems once it stops moving,
+	// returns the number of failed checks
+	int CheckStaticSceneChanges();
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include <Seidon.h>
+
+#include "BenchmarkRunner.h"
+#include "Benchmarks.h"
+
+/*
+* Usage: Benchmark [--output report.json] [--filter name] [--iterations count]
+* Runs without a window or GL context, so only CPU side engine code can be measured.
+*/
+int main(int argc, char** argv)
+{
+	Seidon::Application app;
+	app.SetArguments(argc, argv);
+	app.AppInitHeadless();
+
+	std::string output = app.GetArgumentValue("--output");
+	if (output.empty()) output = "BenchmarkReport.json";
+
+	std::string iterations = app.GetArgumentValue("--iterations");
+
+	// Timings of code that computes wrong results are meaningless
+	int failures = Seidon::CheckMathKernels();
+	failures += Seidon::CheckPhysicsSync();
+	failures += Seidon::CheckStaticSceneChanges();
+	if (failures > 0)
+	{
+		app.AppDestroy();
+		return 1;
+	}
+
+	Seidon::BenchmarkRunner runner;
+	Seidon::RegisterSceneBenchmarks(runner);
+	Seidon::RegisterAssetBenchmarks(runner);
+	Seidon::RegisterMathBenchmarks(runner);
+
+	runner.Run(app.GetArgumentValue("--filter"), iterations.empty() ? 10 : std::stoi(iterations));
+
+	bool written = runner.WriteReport(output);
+
+	app.AppDestroy();
+
+	return written ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,207 @@
+#include "Benchmarks.h"
+
+#include <Seidon.h>
+
+#include <memory>
+#include <random>
+#include <iostream>
+
+namespace Seidon
+{
+	static constexpr int TRANSFORM_COUNT = 100000;
+	static constexpr int HIERARCHY_DEPTH = 8;
+
+	struct MathData
+	{
+		std::vector<glm::vec3> positions;
+		std::vector<glm::quat> rotations;
+		std::vector<glm::vec3> scales;
+		std::vector<glm::mat4> a;
+		std::vector<glm::mat4> b;
+		std::vector<glm::mat4> out;
+		std::vector<int> parents;
+		std::vector<Aabb> boxes;
+		std::vector<Aabb> outBoxes;
+	};
+
+	// Same seed every run, so that results are comparable between reports
+	static std::shared_ptr<MathData> CreateMathData(int count)
+	{
+		std::shared_ptr<MathData> data = std::make_shared<MathData>();
+
+		std::mt19937 generator(42);
+		std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+		std::uniform_real_distribution<float> scaleDistribution(0.1f, 4.0f);
+
+		for (int i = 0; i < count; i++)
+		{
+			data->positions.push_back(glm::vec3(distribution(generator), distribution(generator), distribution(generator)));
+			data->rotations.push_back(glm::quat(glm::vec3(distribution(generator), distribution(generator), distribution(generator))));
+			data->scales.push_back(glm::vec3(scaleDistribution(generator), scaleDistribution(generator), scaleDistribution(generator)));
+			data->parents.push_back(i % HIERARCHY_DEPTH == 0 ? -1 : i - 1);
+
+			glm::vec3 center = data->positions.back();
+			data->boxes.push_back({ center - data->scales.back(), center + data->scales.back() });
+		}
+
+		data->a.resize(count);
+		data->b.resize(count);
+		data->out.resize(count);
+		data->outBoxes.resize(count);
+
+		ComposeTransforms(data->positions.data(), data->rotations.data(), data->scales.data(), data->a.data(), count);
+		for (int i = 0; i < count; i++)
+			data->b[i] = data->a[(i + 1) % count];
+
+		return data;
+	}
+
+	static glm::mat4 ComposeReference(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+	{
+		return glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.0f), scale);
+	}
+
+	static Aabb TransformAabbReference(const Aabb& box, const glm::mat4& matrix)
+	{
+		Aabb result;
+		result.min = glm::vec3(std::numeric_limits<float>::max());
+		result.max = glm::vec3(-std::numeric_limits<float>::max());
+
+		for (int i = 0; i < 8; i++)
+		{
+			glm::vec3 corner(i & 1 ? box.max.x : box.min.x, i & 2 ? box.max.y : box.min.y, i & 4 ? box.max.z : box.min.z);
+			glm::vec3 transformed = matrix * glm::vec4(corner, 1.0f);
+
+			result.min = glm::min(result.min, transformed);
+			result.max = glm::max(result.max, transformed);
+		}
+
+		return result;
+	}
+
+	static float RelativeError(const glm::mat4& a, const glm::mat4& b)
+	{
+		float error = 0;
+		for (int i = 0; i < 4; i++)
+			for (int j = 0; j < 4; j++)
+				error = std::max(error, std::abs(a[i][j] - b[i][j]) / std::max(1.0f, std::abs(b[i][j])));
+
+		return error;
+	}
+
+	static float RelativeError(const glm::vec3& a, const glm::vec3& b)
+	{
+		float error = 0;
+		for (int i = 0; i < 3; i++)
+			error = std::max(error, std::abs(a[i] - b[i]) / std::max(1.0f, std::abs(b[i])));
+
+		return error;
+	}
+
+	static int ReportMismatch(const std::string& kernel, int index, float error)
+	{
+		std::cerr << kernel << " differs from glm at index " << index << " (relative error " << error << ")" << std::endl;
+		return 1;
+	}
+
+	int CheckMathKernels()
+	{
+		// Odd count so that the scalar tail of the 4-wide kernels is covered too
+		constexpr int count = 1027;
+		constexpr float tolerance = 1e-4f;
+
+		std::shared_ptr<MathData> data = CreateMathData(count);
+		int failures = 0;
+
+		ComposeTransforms(data->positions.data(), data->rotations.data(), data->scales.data(), data->out.data(), count);
+		for (int i = 0; i < count; i++)
+		{
+			float error = RelativeError(data->out[i], ComposeReference(data->positions[i], data->rotations[i], data->scales[i]));
+			if (error > tolerance) { failures += ReportMismatch("ComposeTransforms", i, error); break; }
+		}
+
+		MultiplyMatrices(data->a.data(), data->b.data(), data->out.data(), count);
+		for (int i = 0; i < count; i++)
+		{
+			float error = RelativeError(data->out[i], data->a[i] * data->b[i]);
+			if (error > tolerance) { failures += ReportMismatch("MultiplyMatrices", i, error); break; }
+		}
+
+		std::vector<glm::mat4> reference(count);
+		for (int i = 0; i < count; i++)
+			reference[i] = data->parents[i] >= 0 ? reference[data->parents[i]] * data->a[i] : data->a[i];
+
+		MultiplyHierarchy(data->a.data(), data->parents.data(), data->out.data(), count);
+		for (int i = 0; i < count; i++)
+		{
+			float error = RelativeError(data->out[i], reference[i]);
+			if (error > tolerance) { failures += ReportMismatch("MultiplyHierarchy", i, error); break; }
+		}
+
+		TransformAabbs(data->boxes.data(), data->a.data(), data->outBoxes.data(), count);
+		for (int i = 0; i < count; i++)
+		{
+			Aabb expected = TransformAabbReference(data->boxes[i], data->a[i]);
+			float error = std::max(RelativeError(data->outBoxes[i].min, expected.min), RelativeError(data->outBoxes[i].max, expected.max));
+			if (error > tolerance) { failures += ReportMismatch("TransformAabbs", i, error); break; }
+		}
+
+		return failures;
+	}
+
+	void RegisterMathBenchmarks(BenchmarkRunner& runner)
+	{
+		std::shared_ptr<MathData> data = CreateMathData(TRANSFORM_COUNT);
+
+		runner.Add("Compose Transforms", TRANSFORM_COUNT,
+			[data]()
+			{
+				ComposeTransforms(data->positions.data(), data->rotations.data(), data->scales.data(), data->out.data(), TRANSFORM_COUNT);
+			}
+		);
+
+		runner.Add("Compose Transforms glm", TRANSFORM_COUNT,
+			[data]()
+			{
+				for (int i = 0; i < TRANSFORM_COUNT; i++)
+					data->out[i] = ComposeReference(data->positions[i], data->rotations[i], data->scales[i]);
+			}
+		);
+
+		runner.Add("Multiply Matrices", TRANSFORM_COUNT,
+			[data]() { MultiplyMatrices(data->a.data(), data->b.data(), data->out.data(), TRANSFORM_COUNT); }
+		);
+
+		runner.Add("Multiply Matrices glm", TRANSFORM_COUNT,
+			[data]()
+			{
+				for (int i = 0; i < TRANSFORM_COUNT; i++)
+					data->out[i] = data->a[i] * data->b[i];
+			}
+		);
+
+		runner.Add("Multiply Hierarchy", TRANSFORM_COUNT,
+			[data]() { MultiplyHierarchy(data->a.data(), data->parents.data(), data->out.data(), TRANSFORM_COUNT); }
+		);
+
+		runner.Add("Multiply Hierarchy glm", TRANSFORM_COUNT,
+			[data]()
+			{
+				for (int i = 0; i < TRANSFORM_COUNT; i++)
+					data->out[i] = data->parents[i] >= 0 ? data->out[data->parents[i]] * data->a[i] : data->a[i];
+			}
+		);
+
+		runner.Add("Transform Aabbs", TRANSFORM_COUNT,
+			[data]() { TransformAabbs(data->boxes.data(), data->a.data(), data->outBoxes.data(), TRANSFORM_COUNT); }
+		);
+
+		runner.Add("Transform Aabbs glm", TRANSFORM_COUNT,
+			[data]()
+			{
+				for (int i = 0; i < TRANSFORM_COUNT; i++)
+					data->outBoxes[i] = TransformAabbReference(data->boxes[i], data->a[i]);
+			}
+		);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,531 @@
+#include "Benchmarks.h"
+
+#include <Seidon.h>
+#include <Animation/AnimationSystem.h>
+
+#include <memory>
+#include <iostream>
+
+namespace Seidon
+{
+	static constexpr int ENTITY_COUNT = 10000;
+	static constexpr int HIERARCHY_DEPTH = 8;
+
+	static constexpr int ANIMATED_ENTITY_COUNT = 1000;
+	static constexpr int BONE_COUNT = 64;
+	static constexpr int KEYS_PER_CHANNEL = 30;
+
+	// Entities with the default components and a different transform each
+	static Scene* CreateSyntheticScene(int entityCount)
+	{
+		Scene* scene = new Scene("Benchmark Scene");
+
+		for (int i = 0; i < entityCount; i++)
+		{
+			Entity e = scene->CreateEntity("Entity " + std::to_string(i));
+
+			TransformComponent& transform = e.GetComponent<TransformComponent>();
+			transform.position = glm::vec3(i % 100, (i / 100) % 100, i / 10000);
+			transform.rotation = glm::quat(glm::vec3(0.1f * i, 0.2f * i, 0.3f * i));
+		}
+
+		return scene;
+	}
+
+	// Chains of HIERARCHY_DEPTH entities, each one parented to the previous
+	static Scene* CreateHierarchyScene(int entityCount)
+	{
+		Scene* scene = new Scene("Benchmark Hierarchy");
+
+		Entity parent;
+		for (int i = 0; i < entityCount; i++)
+		{
+			Entity e = scene->CreateEntity();
+
+			TransformComponent& transform = e.GetComponent<TransformComponent>();
+			transform.position = glm::vec3(1, 0, 0);
+			transform.rotation = glm::quat(glm::vec3(0, 0.1f, 0));
+
+			if (i % HIERARCHY_DEPTH != 0)
+				e.SetParent(parent);
+
+			parent = e;
+		}
+
+		return scene;
+	}
+
+	// Edits the rigidbodies in place like gameplay systems do, without marking them changed
+	class RigidbodyEditSystem : public System
+	{
+	public:
+		bool kinematic = true;
+
+		void Update(float deltaTime) override
+		{
+			scene->CreateViewAndIterate<DynamicRigidbodyComponent>([&](EntityId id, DynamicRigidbodyComponent& rigidbody)
+				{
+					rigidbody.kinematic = kinematic;
+				}
+			);
+		}
+	};
+
+	// RenderSystem needs a GL context, this one only takes its place in the schedule with the same access
+	class RenderStandInSystem : public System
+	{
+	public:
+		void Update(float deltaTime) override {}
+	};
+
+	static void RegisterRenderStandIn(Application& app)
+	{
+		SystemMetaType render = app.GetSystemMetaType<RenderSystem>();
+
+		SystemMetaType& standIn = app.RegisterSystem<RenderStandInSystem>();
+		standIn.readComponents = render.readComponents;
+		standIn.writtenComponents = render.writtenComponents;
+		standIn.accessDeclared = render.accessDeclared;
+		standIn.mainThreadOnly = render.mainThreadOnly;
+		standIn.executionOrder = render.executionOrder;
+	}
+
+	// Not registered, so it runs exclusively without declaring what it accesses
+	class UndeclaredSystem : public System
+	{
+	public:
+		void Update(float deltaTime) override {}
+	};
+
+	// Counts the transforms IterateChanged visits on each update
+	class ChangedTransformCountSystem : public System
+	{
+	public:
+		uint32_t lastChangeVersion = 0;
+		int visited = 0;
+
+		void Update(float deltaTime) override
+		{
+			uint32_t sinceVersion = lastChangeVersion;
+			lastChangeVersion = scene->CaptureChangeVersion();
+
+			visited = 0;
+			scene->IterateChanged<TransformComponent>(sinceVersion, [&](EntityId id, TransformComponent& transform) { visited++; });
+		}
+	};
+
+	// Runs frames with the systems of a rendered scene, so that what snapshots share depends on what the systems declare
+	static void UpdateWithEngineSystems(Scene* scene, int frameCount)
+	{
+		if (!scene->HasSystem<RenderStandInSystem>())
+		{
+			scene->AddSystem<AnimationSystem>();
+			scene->AddSystem<RenderStandInSystem>();
+			scene->AddSystem<UndeclaredSystem>();
+		}
+
+		for (int i = 0; i < frameCount; i++)
+			scene->Update(1.0f / 60.0f);
+	}
+
+	// Root with HIERARCHY_DEPTH children, instantiated ENTITY_COUNT / (HIERARCHY_DEPTH + 1) times
+	static Prefab* CreateSyntheticPrefab()
+	{
+		Scene scene("Benchmark Prefab");
+
+		Entity root = scene.CreateEntity("Root");
+		for (int i = 0; i < HIERARCHY_DEPTH; i++)
+		{
+			Entity child = scene.CreateEntity("Child " + std::to_string(i));
+			child.GetComponent<TransformComponent>().position = glm::vec3(i, 0, 0);
+			child.SetParent(root);
+		}
+
+		Prefab* prefab = new Prefab();
+		prefab->MakeFromEntity(root);
+
+		return prefab;
+	}
+
+	static SkinnedMesh* CreateSyntheticSkinnedMesh()
+	{
+		SkinnedMesh* mesh = new SkinnedMesh();
+		mesh->name = "Benchmark Skinned Mesh";
+
+		mesh->armature.bones.resize(BONE_COUNT);
+		for (int i = 0; i < BONE_COUNT; i++)
+		{
+			BoneData& bone = mesh->armature.bones[i];
+			bone.name = "Bone " + std::to_string(i);
+			bone.id = i;
+			bone.parentId = i > 0 ? i - 1 : 0;
+			bone.inverseBindPoseMatrix = glm::identity<glm::mat4>();
+		}
+
+		return mesh;
+	}
+
+	static Animation* CreateSyntheticAnimation()
+	{
+		Animation* animation = new Animation();
+		animation->name = "Benchmark Animation";
+		animation->duration = KEYS_PER_CHANNEL - 1;
+		animation->ticksPerSecond = 24;
+
+		animation->channels.resize(BONE_COUNT);
+		for (int i = 0; i < BONE_COUNT; i++)
+		{
+			AnimationChannel& channel = animation->channels[i];
+			channel.boneName = "Bone " + std::to_string(i);
+			channel.boneId = i;
+
+			channel.positionKeys.resize(KEYS_PER_CHANNEL);
+			channel.rotationKeys.resize(KEYS_PER_CHANNEL);
+			channel.scalingKeys.resize(KEYS_PER_CHANNEL);
+
+			for (int j = 0; j < KEYS_PER_CHANNEL; j++)
+			{
+				channel.positionKeys[j].time = j;
+				channel.positionKeys[j].value = glm::vec3(j, i, 0);
+
+				channel.rotationKeys[j].time = j;
+				channel.rotationKeys[j].value = glm::quat(glm::vec3(0.1f * j, 0, 0.05f * i));
+
+				channel.scalingKeys[j].time = j;
+				channel.scalingKeys[j].value = glm::vec3(1 + 0.01f * j);
+			}
+		}
+
+		return animation;
+	}
+
+	int CheckPhysicsSync()
+	{
+		Application& app = *Application::Get();
+
+		app.RegisterSystem<RigidbodyEditSystem>()
+			.Writes<DynamicRigidbodyComponent>();
+
+		Scene scene("Physics Check");
+
+		// Kinematic bodies don't move, so only the rigidbody edit can get it synced again
+		Entity e = scene.CreateEntity();
+		e.AddComponent<CubeColliderComponent>();
+		e.AddComponent<DynamicRigidbodyComponent>().kinematic = true;
+
+		scene.AddSystem<PhysicSystem>();
+		RigidbodyEditSystem& editSystem = scene.AddSystem<RigidbodyEditSystem>();
+
+		// The first steps sync every body, the edit has to be picked up by a later one
+		for (int i = 0; i < 3; i++)
+			scene.Update(1.0f / 60.0f);
+
+		editSystem.kinematic = false;
+
+		for (int i = 0; i < 3; i++)
+			scene.Update(1.0f / 60.0f);
+
+		DynamicRigidbodyComponent& rigidbody = e.GetComponent<DynamicRigidbodyComponent>();
+		bool kinematic = rigidbody.actor.GetInternalActor()->getRigidBodyFlags() & physx::PxRigidBodyFlag::eKINEMATIC;
+
+		scene.Destroy();
+		app.UnregisterSystem<RigidbodyEditSystem>();
+
+		if (!kinematic) return 0;
+
+		std::cerr << "PhysicSystem didn't sync a rigidbody edited in place by another system" << std::endl;
+		return 1;
+	}
+
+	int CheckStaticSceneChanges()
+	{
+		Application& app = *Application::Get();
+
+		RegisterRenderStandIn(app);
+		app.RegisterSystem<ChangedTransformCountSystem>()
+			.Reads<TransformComponent>();
+
+		Scene* scene = CreateHierarchyScene(ENTITY_COUNT / 10);
+
+		Entity ground = scene->CreateEntity();
+		ground.AddComponent<CubeColliderComponent>();
+		ground.AddComponent<StaticRigidbodyComponent>();
+
+		scene->AddSystem<PhysicSystem>();
+		ChangedTransformCountSystem& countSystem = scene->AddSystem<ChangedTransformCountSystem>();
+
+		// The first updates visit everything, once nothing moves there is nothing left to visit
+		UpdateWithEngineSystems(scene, 3);
+		int visited = countSystem.visited;
+
+		// Nor is there anything to copy again for a snapshot
+		SceneSnapshot baseline = scene->Snapshot();
+		UpdateWithEngineSystems(scene, 2);
+		SceneSnapshot snapshot = scene->Snapshot(&baseline);
+
+		const std::string transformName = typeid(TransformComponent).name();
+		bool shared = snapshot.columns[transformName] == baseline.columns[transformName];
+
+		delete scene;
+
+		app.UnregisterSystem<ChangedTransformCountSystem>();
+		app.UnregisterSystem<RenderStandInSystem>();
+
+		int failures = 0;
+
+		if (visited > 0)
+		{
+			std::cerr << "IterateChanged visited " << visited << " transforms of a scene where nothing moved" << std::endl;
+			failures++;
+		}
+
+		if (!shared)
+		{
+			std::cerr << "Snapshot copied the transforms of a scene where nothing moved" << std::endl;
+			failures++;
+		}
+
+		return failures;
+	}
+
+	void RegisterSceneBenchmarks(BenchmarkRunner& runner)
+	{
+		RegisterRenderStandIn(*Application::Get());
+
+		struct State
+		{
+			Scene* scene = nullptr;
+			Scene* result = nullptr;
+			std::vector<Entity> entities;
+
+			SceneSnapshot snapshot;
+
+			Prefab* prefab = nullptr;
+			std::vector<TransformComponent> transforms;
+
+			SkinnedMesh* mesh = nullptr;
+			Animation* animation = nullptr;
+		};
+
+		std::shared_ptr<State> state = std::make_shared<State>();
+		std::string scenePath = BenchmarkRunner::GetTemporaryPath("Scene.sdscene");
+
+		auto deleteScenes = [state]()
+		{
+			delete state->scene;
+			delete state->result;
+			delete state->prefab;
+
+			state->scene = nullptr;
+			state->result = nullptr;
+			state->prefab = nullptr;
+			state->entities.clear();
+			state->transforms.clear();
+			state->snapshot = SceneSnapshot();
+		};
+
+		runner.Add("Entity Create", ENTITY_COUNT,
+			[state]()
+			{
+				for (int i = 0; i < ENTITY_COUNT; i++)
+					state->scene->CreateEntity();
+			},
+			[state]() { state->scene = new Scene(); },
+			deleteScenes
+		);
+
+		runner.Add("Entity Destroy", ENTITY_COUNT,
+			[state]()
+			{
+				for (Entity& e : state->entities)
+					state->scene->DestroyEntity(e);
+			},
+			[state]()
+			{
+				state->scene = CreateSyntheticScene(ENTITY_COUNT);
+				state->scene->CreateViewAndIterate<IDComponent>([&](EntityId id, IDComponent&)
+					{
+						state->entities.push_back(state->scene->GetEntityByEntityId(id));
+					}
+				);
+			},
+			deleteScenes
+		);
+
+		runner.Add("Scene Save", ENTITY_COUNT,
+			[state, scenePath]()
+			{
+				BinaryWriter out(scenePath);
+				state->scene->Save(out);
+			},
+			[state]() { state->scene = CreateSyntheticScene(ENTITY_COUNT); },
+			deleteScenes
+		);
+
+		runner.Add("Scene Load", ENTITY_COUNT,
+			[state, scenePath]()
+			{
+				state->result = new Scene();
+				state->result->Load(scenePath);
+			},
+			[state, scenePath]()
+			{
+				Scene* scene = CreateSyntheticScene(ENTITY_COUNT);
+
+				BinaryWriter out(scenePath);
+				scene->Save(out);
+
+				delete scene;
+			},
+			deleteScenes
+		);
+
+		runner.Add("Scene Duplicate", ENTITY_COUNT,
+			[state]() { state->result = state->scene->Duplicate(); },
+			[state]() { state->scene = CreateSyntheticScene(ENTITY_COUNT); },
+			deleteScenes
+		);
+
+		runner.Add("Scene Snapshot", ENTITY_COUNT,
+			[state]() { state->snapshot = state->scene->Snapshot(); },
+			[state]() { state->scene = CreateSyntheticScene(ENTITY_COUNT); },
+			deleteScenes
+		);
+
+		// Nothing but the types the systems write changed since the baseline, the other columns are shared
+		runner.Add("Scene Snapshot Baseline", ENTITY_COUNT,
+			[state]()
+			{
+				SceneSnapshot snapshot = state->scene->Snapshot(&state->snapshot);
+			},
+			[state]()
+			{
+				state->scene = CreateSyntheticScene(ENTITY_COUNT);
+				UpdateWithEngineSystems(state->scene, 2);
+
+				state->snapshot = state->scene->Snapshot();
+				UpdateWithEngineSystems(state->scene, 2);
+			},
+			deleteScenes
+		);
+
+		// Every transform moved since the snapshot, the other component types are left untouched
+		runner.Add("Scene Restore", ENTITY_COUNT,
+			[state]() { state->scene->Restore(state->snapshot); },
+			[state]()
+			{
+				state->scene = CreateSyntheticScene(ENTITY_COUNT);
+				UpdateWithEngineSystems(state->scene, 2);
+
+				state->snapshot = state->scene->Snapshot();
+				UpdateWithEngineSystems(state->scene, 2);
+
+				state->scene->CreateViewAndIterate<TransformComponent>([](EntityId id, TransformComponent& transform)
+					{
+						transform.position.y += 1.0f;
+					}
+				);
+			},
+			deleteScenes
+		);
+
+		runner.Add("Prefab Instantiate", ENTITY_COUNT,
+			[state]()
+			{
+				state->scene->InstantiatePrefab(*state->prefab, state->transforms.data(), state->transforms.size());
+			},
+			[state]()
+			{
+				state->scene = new Scene();
+				state->prefab = CreateSyntheticPrefab();
+				state->transforms.resize(ENTITY_COUNT / (HIERARCHY_DEPTH + 1));
+
+				for (int i = 0; i < state->transforms.size(); i++)
+					state->transforms[i].position = glm::vec3(i % 100, i / 100, 0);
+			},
+			deleteScenes
+		);
+
+		// Every root moves, so the whole hierarchy is recomputed
+		runner.Add("Transform Hierarchy", ENTITY_COUNT,
+			[state]()
+			{
+				state->scene->CreateViewAndIterate<TransformComponent>([](EntityId id, TransformComponent& transform)
+					{
+						if (transform.parent == 0) transform.position.y += 0.01f;
+					}
+				);
+
+				state->scene->UpdateTransforms();
+			},
+			[state]()
+			{
+				state->scene = CreateHierarchyScene(ENTITY_COUNT);
+				state->scene->UpdateTransforms();
+			},
+			deleteScenes
+		);
+
+		runner.Add("Transform Hierarchy Static", ENTITY_COUNT,
+			[state]() { state->scene->UpdateTransforms(); },
+			[state]()
+			{
+				state->scene = CreateHierarchyScene(ENTITY_COUNT);
+				state->scene->UpdateTransforms();
+			},
+			deleteScenes
+		);
+
+		// Every entity spawns another one from a parallel loop, through the per-thread command buffers
+		runner.Add("Command Buffer Spawn", ENTITY_COUNT,
+			[state]()
+			{
+				Scene& scene = *state->scene;
+
+				scene.CreateViewAndParallelIterate<TransformComponent>([&](EntityId id, TransformComponent& transform)
+					{
+						CommandBuffer& commands = scene.GetCommandBuffer();
+
+						DeferredEntity spawned = commands.CreateEntity();
+						commands.AddComponent<NameComponent>(spawned, "Spawned");
+					}
+				);
+
+				scene.PlaybackCommands();
+			},
+			[state]() { state->scene = CreateSyntheticScene(ENTITY_COUNT); },
+			deleteScenes
+		);
+
+		runner.Add("Animation Sampling", ANIMATED_ENTITY_COUNT * BONE_COUNT,
+			[state]() { state->scene->Update(1.0f / 60.0f); },
+			[state]()
+			{
+				state->mesh = CreateSyntheticSkinnedMesh();
+				state->animation = CreateSyntheticAnimation();
+				state->scene = new Scene();
+
+				for (int i = 0; i < ANIMATED_ENTITY_COUNT; i++)
+				{
+					Entity e = state->scene->CreateEntity();
+					e.AddComponent<SkinnedRenderComponent>(state->mesh, std::vector<Material*>());
+
+					AnimationComponent& animation = e.AddComponent<AnimationComponent>();
+					animation.animation = state->animation;
+					animation.runtimeTime = i * 0.37f;
+				}
+
+				// The first update after adding a system builds the schedule and runs serially
+				state->scene->AddSystem<AnimationSystem>();
+				state->scene->Update(0);
+			},
+			[state, deleteScenes]()
+			{
+				deleteScenes();
+
+				delete state->mesh;
+				delete state->animation;
+			}
+		);
+	}
+}
\ No newline at end of file
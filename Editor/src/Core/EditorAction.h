@@ -21,14 +21,12 @@ namespace Seidon
 
 		void Do()
 		{
-			void* component = modifiedMetaType.Get(modifiedEntity);
-			modifiedMetaType.ModifyMemberV(modifiedMemberName, component, newValue);
+			modifiedMetaType.ModifyMemberV(modifiedEntity, modifiedMemberName, newValue);
 		}
 
 		void Undo()
 		{
-			void* component = modifiedMetaType.Get(modifiedEntity);
-			modifiedMetaType.ModifyMemberV(modifiedMemberName, component, oldValue);
+			modifiedMetaType.ModifyMemberV(modifiedEntity, modifiedMemberName, oldValue);
 		}
 	};
 
@@ -18,7 +18,7 @@ namespace Seidon
 		void Save(const std::string& path);
 		void Load(const std::string& path);
 
-		void Save(std::ofstream& out) {}
-		void Load(std::ifstream& in) {}
+		void Save(BinaryWriter& out) {}
+		void Load(BinaryReader& in) {}
 	};
 }
\ No newline at end of file
@@ -19,6 +19,7 @@ namespace Seidon
 		panels.push_back(new SystemsPanel(editor));
 		panels.push_back(new InspectorPanel(editor));
         panels.push_back(new StatisticsPanel(editor));
+        panels.push_back(new ProfilerPanel(editor));
 		panels.push_back(new ViewportPanel(editor));
 		panels.push_back(new FileBrowserPanel(editor));
 
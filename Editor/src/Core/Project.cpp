@@ -71,7 +71,7 @@ namespace Seidon
 		std::ofstream outStream(path);
 		outStream << out.c_str();
 
-		std::ofstream fout(assetsDirectory + "\\ResourceRegistry.sdreg", std::ios::out | std::ios::binary);
+		BinaryWriter fout(assetsDirectory + "\\ResourceRegistry.sdreg");
 		Application::Get()->GetResourceManager()->Save(fout);
 	}
 
@@ -98,7 +98,7 @@ namespace Seidon
 
 		if (std::filesystem::exists(assetsDirectory + "\\ResourceRegistry.sdreg"))
 		{
-			std::ifstream in(assetsDirectory + "\\ResourceRegistry.sdreg", std::ios::in | std::ios::binary);
+			BinaryReader in(assetsDirectory + "\\ResourceRegistry.sdreg");
 			Application::Get()->GetResourceManager()->Load(in);
 
 		}
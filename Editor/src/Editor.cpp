@@ -29,6 +29,9 @@ namespace Seidon
         io.Fonts->AddFontFromFileTTF("Resources/Roboto-Regular.ttf", 18);
         
         RegisterSystem<EditorCameraControlSystem>()
+            .RunOnMainThread()
+            .Reads<CameraComponent>()
+            .Writes<TransformComponent>()
             .AddMember("Mouse Sensitivity", &EditorCameraControlSystem::mouseSensitivity)
             .AddMember("Movement Speed", &EditorCameraControlSystem::movementSpeed);
 
@@ -178,13 +181,8 @@ namespace Seidon
 
     void Editor::UpdateEditorSystems()
     {
-        openProject->loadedScene->CreateViewAndIterate<TransformComponent>
-        (
-            [](EntityId id, TransformComponent& transform)
-            {
-                transform.cacheValid = false;
-            }
-        );
+        openProject->loadedScene->AdvanceChangeHistory();
+        openProject->loadedScene->UpdateTransforms();
 
         for (auto& [name, system] : openProject->editorSystems)
             system->Update(window->GetDeltaTime());
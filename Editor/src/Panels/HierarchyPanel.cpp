@@ -39,9 +39,7 @@ namespace Seidon
 
 				Entity entity(entityId, scene);
 
-				UUID parentId = entity.GetComponent<TransformComponent>().parent;
-
-				if (scene->IsIdValid(parentId)) return;
+				if (entity.HasParent()) return;
 
 				DrawEntityNode(entity);
 
@@ -301,13 +299,7 @@ namespace Seidon
 				DrawBoneNode(entity, r.mesh->armature, r.boneTransforms, 0);
 			}
 
-			TransformComponent& t = entity.GetComponent<TransformComponent>();
-
-			for (UUID i : t.children)
-			{
-				Entity e = entity.scene->GetEntityById(i);
-				DrawEntityNode(e);
-			}
+			entity.ForEachChild([&](Entity child) { DrawEntityNode(child); });
 			ImGui::TreePop();
 		}
 
@@ -55,6 +55,12 @@ namespace Seidon
 
     void InspectorPanel::DrawEntity(Entity e)
     {
+        if (e.ID != eulerAnglesEntity)
+        {
+            eulerAngles.clear();
+            eulerAnglesEntity = e.ID;
+        }
+
         auto& name = e.GetComponent<NameComponent>().name;
 
         char buffer[256];
@@ -87,10 +93,12 @@ namespace Seidon
 
             if (metaType.Has(e) && open)
             {
-                ChangeData change = DrawMetaType(metaType.Get(e), metaType);
+                ChangeData change = DrawMetaType(metaType.Get(e), metaType, &eulerAngles[metaType.name]);
 
                 if (change.status == ChangeStatus::CHANGED)
                 {
+                    metaType.MarkChanged(e);
+
                     EditorComponentAction* action = new EditorComponentAction();
                     action->modifiedEntity = e;
                     action->modifiedMetaType = metaType;
@@ -19,5 +19,10 @@ namespace Seidon
 		void DrawEntity(Entity e);
 		void DrawMaterial(Material* m);
 		void DrawBone(BoneSelectionData& boneData);
+
+	private:
+		// Euler angles shown for the quaternions of the selected entity, by component type. Dropped when the selection changes
+		EntityId eulerAnglesEntity = NullEntityId;
+		std::unordered_map<std::string, EulerAnglesCache> eulerAngles;
 	};
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "FileBrowserPanel.h"
 #include "HierarchyPanel.h"
 #include "InspectorPanel.h"
+#include "ProfilerPanel.h"
 #include "SystemsPanel.h"
 #include "StatisticsPanel.h"
 #include "ViewportPanel.h"
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "ProfilerPanel.h"
+
+#include "../Editor.h"
+#include "../Utils/Dialogs.h"
+
+namespace Seidon
+{
+    ProfilerPanel::ProfilerPanel(Editor& editor)
+        : Panel(editor)
+    {
+
+    }
+
+	void ProfilerPanel::Init()
+	{
+
+	}
+
+	void ProfilerPanel::Draw()
+	{
+        if (!ImGui::Begin("Profiler"))
+        {
+            ImGui::End();
+            return;
+        }
+
+#ifndef SD_PROFILE
+        ImGui::Text("Profiling zones are compiled out in this configuration");
+        ImGui::End();
+        return;
+#endif
+
+        if (!paused)
+            hasCapture = Profiler::CaptureLastFrame(capture, frameStart, frameEnd);
+
+        ImGui::Checkbox("Pause", &paused);
+        ImGui::SameLine();
+
+        if (ImGui::Button("Export Trace"))
+        {
+            std::string filepath = SaveFile("Chrome Trace (*.json)\0*.json\0");
+
+            if (!filepath.empty())
+                Profiler::ExportChromeTrace(filepath);
+        }
+
+        if (!hasCapture)
+        {
+            ImGui::End();
+            return;
+        }
+
+        float frameDuration = (frameEnd - frameStart) / 1000000.0f;
+        ImGui::SameLine();
+        ImGui::Text("Frame: %.3f ms", frameDuration);
+
+        ImGui::Separator();
+
+        ImGui::BeginChild("Flame View", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
+
+        const float rowHeight = ImGui::GetTextLineHeight() + 4;
+        const float labelWidth = 120;
+
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        float width = std::max(ImGui::GetContentRegionAvail().x - labelWidth, 100.0f);
+        float scale = width / (float)(frameEnd - frameStart);
+
+        float y = origin.y;
+
+        for (ProfileThreadCapture& thread : capture)
+        {
+            int maxDepth = 0;
+            for (ProfileEvent& event : thread.events)
+                maxDepth = std::max(maxDepth, event.depth);
+
+            drawList->AddText(ImVec2(origin.x, y), IM_COL32(255, 255, 255, 255), thread.threadName.c_str());
+
+            for (ProfileEvent& event : thread.events)
+            {
+                // Zones crossing the frame boundaries are clipped to the frame
+                long long start = std::max(event.start, frameStart);
+                long long end = std::min(event.end, frameEnd);
+
+                ImVec2 min(origin.x + labelWidth + (start - frameStart) * scale, y + event.depth * rowHeight);
+                ImVec2 max(std::max(origin.x + labelWidth + (end - frameStart) * scale, min.x + 1), min.y + rowHeight - 1);
+
+                // Same zone name, same color, so that a zone is easy to follow across threads
+                size_t hash = std::hash<std::string>()(event.name);
+                ImU32 color = IM_COL32(80 + hash % 120, 80 + (hash >> 8) % 120, 80 + (hash >> 16) % 120, 255);
+
+                drawList->AddRectFilled(min, max, color);
+
+                drawList->PushClipRect(min, max, true);
+                drawList->AddText(ImVec2(min.x + 2, min.y + 1), IM_COL32(255, 255, 255, 255), event.name);
+                drawList->PopClipRect();
+
+                if (ImGui::IsMouseHoveringRect(min, max))
+                    ImGui::SetTooltip("%s\n%.3f ms", event.name, (event.end - event.start) / 1000000.0f);
+            }
+
+            y += (maxDepth + 1) * rowHeight + 4;
+        }
+
+        ImGui::Dummy(ImVec2(labelWidth + width, y - origin.y));
+
+        ImGui::EndChild();
+        ImGui::End();
+	}
+
+	void ProfilerPanel::Destroy()
+	{
+
+	}
+}
\ No newline at end of file
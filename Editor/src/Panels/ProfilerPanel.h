@@ -0,0 +1,25 @@
+#pragma once
+#include "Panel.h"
+
+#include <Seidon.h>
+
+namespace Seidon
+{
+	class ProfilerPanel : public Panel
+	{
+	public:
+		ProfilerPanel(Editor& editor);
+
+		void Init() override;
+		void Draw() override;
+		void Destroy() override;
+
+	private:
+		bool paused = false;
+		bool hasCapture = false;
+
+		std::vector<ProfileThreadCapture> capture;
+		long long frameStart = 0;
+		long long frameEnd = 0;
+	};
+}
\ No newline at end of file
@@ -42,9 +42,110 @@ namespace Seidon
             ImGui::Text("Object count: %d in %d batches", stats.objectCount, stats.batchCount);
         }
 
+        WorkManager* workManager = editor.GetWorkManager();
+        const MainThreadStats& mainThreadStats = workManager->GetMainThreadStats();
+
+        ImGui::Separator();
+        ImGui::Text("Main thread tasks: %.2f ms (budget %.2f ms)", mainThreadStats.timeSpent, workManager->GetMainThreadBudget());
+
+        const char* priorityNames[] = { "GPU uploads", "Shader compiles", "Callbacks" };
+        for (int i = 0; i < (int)MainThreadPriority::COUNT; i++)
+            ImGui::Text("%s: %d run, %d queued", priorityNames[i], mainThreadStats.executedTasks[i], mainThreadStats.queueDepth[i]);
+
+        if (editor.isPlaying && editor.activeScene)
+            DrawSystemTimings(editor.activeScene);
+
         ImGui::End();
 	}
 
+    void StatisticsPanel::DrawSystemTimings(Scene* scene)
+    {
+        const std::map<std::string, TimingHistory>& timings = scene->GetSystemTimings();
+        if (timings.empty()) return;
+
+        ImGui::Separator();
+        ImGui::Text("System timings (last %d frames)", TimingHistory::DEFAULT_CAPACITY);
+
+        // Every history gets a sample per frame, newer systems just have fewer of them
+        int frameCount = 0;
+        for (auto& [name, history] : timings)
+            frameCount = std::max(frameCount, history.GetCount());
+
+        std::vector<float> frameTotals(frameCount, 0.0f);
+        for (auto& [name, history] : timings)
+            for (int i = 0; i < history.GetCount(); i++)
+                frameTotals[frameCount - history.GetCount() + i] += history.GetSample(i);
+
+        float maxTotal = 1.0f;
+        for (float total : frameTotals)
+            maxTotal = std::max(maxTotal, total);
+
+        auto getColor = [](const std::string& name)
+        {
+            size_t hash = std::hash<std::string>()(name);
+            return IM_COL32(80 + hash % 150, 80 + (hash >> 8) % 150, 80 + (hash >> 16) % 150, 255);
+        };
+
+        // Stacked graph, one column per frame with the newest frame on the right
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        ImVec2 size(std::max(ImGui::GetContentRegionAvail().x, 100.0f), 100.0f);
+        float columnWidth = size.x / TimingHistory::DEFAULT_CAPACITY;
+
+        drawList->AddRectFilled(origin, ImVec2(origin.x + size.x, origin.y + size.y), IM_COL32(30, 30, 30, 255));
+
+        for (int frame = 0; frame < frameCount; frame++)
+        {
+            float x = origin.x + size.x - (frameCount - frame) * columnWidth;
+            float y = origin.y + size.y;
+
+            for (auto& [name, history] : timings)
+            {
+                int index = frame - (frameCount - history.GetCount());
+                if (index < 0) continue;
+
+                float height = history.GetSample(index) / maxTotal * size.y;
+
+                drawList->AddRectFilled(ImVec2(x, y - height), ImVec2(x + columnWidth, y), getColor(name));
+                y -= height;
+            }
+        }
+
+        ImGui::Dummy(size);
+        ImGui::Text("Scale: %.2f ms", maxTotal);
+
+        if (ImGui::BeginTable("System Timings", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+        {
+            ImGui::TableSetupColumn("System");
+            ImGui::TableSetupColumn("Last");
+            ImGui::TableSetupColumn("Min");
+            ImGui::TableSetupColumn("Avg");
+            ImGui::TableSetupColumn("P95");
+            ImGui::TableSetupColumn("Max");
+            ImGui::TableHeadersRow();
+
+            for (auto& [name, history] : timings)
+            {
+                TimingStats stats = history.ComputeStats();
+
+                ImGui::TableNextRow();
+
+                ImGui::TableNextColumn();
+                ImGui::ColorButton(name.c_str(), ImGui::ColorConvertU32ToFloat4(getColor(name)), ImGuiColorEditFlags_NoTooltip, ImVec2(10, 10));
+                ImGui::SameLine();
+                ImGui::TextUnformatted(name.c_str());
+
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", history.GetLast());
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.min);
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.average);
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.p95);
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.max);
+            }
+
+            ImGui::EndTable();
+        }
+    }
+
 	void StatisticsPanel::Destroy()
 	{
 
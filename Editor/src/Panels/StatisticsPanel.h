@@ -1,6 +1,8 @@
 #pragma once
 #include "Panel.h"
 
+#include <Seidon.h>
+
 namespace Seidon
 {
 	class StatisticsPanel : public Panel
@@ -11,5 +13,8 @@ namespace Seidon
 		void Init() override;
 		void Draw() override;
 		void Destroy() override;
+
+	private:
+		void DrawSystemTimings(Scene* scene);
 	};
 }
\ No newline at end of file
@@ -242,16 +242,10 @@ namespace Seidon
 
             if (ImGuizmo::IsUsing())
             {
-                glm::vec3 position, rotation, scale;
                 if (selectedItem.entity.HasParent())
-                    DecomposeTransform(glm::inverse(selectedItem.entity.GetParent().GetGlobalTransformMatrix()) * transform, position, rotation, scale);
+                    entityTransform.SetFromMatrix(glm::inverse(selectedItem.entity.GetParent().GetGlobalTransformMatrix()) * transform);
                 else
-                    DecomposeTransform(transform, position, rotation, scale);
-
-                glm::vec3 deltaRotation = rotation - entityTransform.rotation;
-                entityTransform.position = position;
-                entityTransform.rotation += deltaRotation;
-                entityTransform.scale = scale;
+                    entityTransform.SetFromMatrix(transform);
             }
         }
 
@@ -277,13 +271,7 @@ namespace Seidon
 
             if (ImGuizmo::IsUsing())
             {
-                glm::vec3 position, rotation, scale;
-                DecomposeTransform(transform, position, rotation, scale);
-
-                glm::vec3 deltaRotation = rotation - t.rotation;
-                t.position = position;
-                t.rotation += deltaRotation;
-                t.scale = scale;
+                t.SetFromMatrix(transform);
 
                 (*selectedItem.boneData.transforms)[selectedItem.boneData.id] = glm::inverse(parentTransformWorldSpace) * glm::inverse(selectedItem.boneData.owningEntity.GetGlobalTransformMatrix()) * t.GetTransformMatrix();
             }
@@ -368,7 +356,7 @@ namespace Seidon
                 renderer.SubmitMeshWireframe(semisphere, glm::vec3(0, 1, 0), t1.GetTransformMatrix());
 
                 t1.position.y -= c.colliderHeight;
-                t1.rotation.x = glm::radians(180.0f);
+                t1.rotation = glm::quat(glm::vec3(glm::radians(180.0f), 0.0f, 0.0f));
 
                 renderer.SubmitMeshWireframe(semisphere, glm::vec3(0, 1, 0), t1.GetTransformMatrix());
 
@@ -47,8 +47,7 @@ namespace Seidon
 				if (pitch < -89.0f)
 					pitch = -89.0f;
 
-				cameraTransform.rotation.x = glm::radians(pitch);
-				cameraTransform.rotation.y = glm::radians(yaw);
+				cameraTransform.rotation = glm::quat(glm::radians(glm::vec3(pitch, yaw, 0.0f)));
 			}
 
 			glm::vec3 input = { 0, 0, 0 };
@@ -887,6 +887,10 @@ namespace Seidon
 						*(glm::vec3*)(material->data + m.offset) = glm::vec3(1);
 						break;
 
+					case Types::QUATERNION:
+						*(glm::quat*)(material->data + m.offset) = glm::quat(1, 0, 0, 0);
+						break;
+
 					case Types::TEXTURE:
 						*(Texture**)(material->data + m.offset) = resourceManager.GetOrLoadAsset<Texture>("albedo_default", true);
 						break;
@@ -1146,7 +1150,7 @@ namespace Seidon
 		return ChangeStatus::NO_CHANGE;
 	}
 
-	ChangeData DrawReflectedMember(void* object, MemberData& member)
+	ChangeData DrawReflectedMember(void* object, MemberData& member, EulerAnglesCache* eulerAngles)
 	{
 		ChangeData data;
 		data.status = ChangeStatus::NO_CHANGE;
@@ -1256,6 +1260,34 @@ namespace Seidon
 			memcpy(data.newValue, (glm::vec3*)(obj + member.offset), sizeof(glm::vec3));
 		}
 
+		if (member.type == Types::QUATERNION)
+		{
+			glm::quat& rotation = *(glm::quat*)(obj + member.offset);
+
+			// The angles shown are kept as long as the quaternion doesn't change
+			EulerAnglesCache temporary;
+			EulerAnglesCache& cache = eulerAngles ? *eulerAngles : temporary;
+
+			auto it = cache.find(member.name);
+			if (it == cache.end() || it->second.first != rotation)
+				it = cache.insert_or_assign(member.name, std::make_pair(rotation, glm::degrees(glm::eulerAngles(rotation)))).first;
+
+			glm::vec3 old;
+			glm::vec3& angles = it->second.second;
+			data.status = DrawVec3Control(member.name.c_str(), angles, 0.0f, &old);
+
+			if (data.status != ChangeStatus::NO_CHANGE)
+			{
+				rotation = glm::quat(glm::radians(angles));
+				it->second.first = rotation;
+			}
+
+			glm::quat oldRotation = glm::quat(glm::radians(old));
+
+			memcpy(data.oldValue, &oldRotation, sizeof(glm::quat));
+			memcpy(data.newValue, &rotation, sizeof(glm::quat));
+		}
+
 		if (member.type == Types::VECTOR3_COLOR)
 		{
 			glm::vec3 old;
@@ -1399,7 +1431,7 @@ namespace Seidon
 		return data;
 	}
 
-	ChangeData DrawMetaType(void* object, MetaType& type)
+	ChangeData DrawMetaType(void* object, MetaType& type, EulerAnglesCache* eulerAngles)
 	{
 		ChangeData res;
 		res.status = ChangeStatus::NO_CHANGE;
@@ -1407,7 +1439,7 @@ namespace Seidon
 		for (MemberData& member : type.members)
 		{
 			ChangeData changeData;
-			changeData = DrawReflectedMember(object, member);
+			changeData = DrawReflectedMember(object, member, eulerAngles);
 
 			if ((int)changeData.status) res = changeData;
 		}
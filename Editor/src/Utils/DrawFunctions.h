@@ -41,6 +41,10 @@ namespace Seidon
 	ChangeStatus DrawMeshColliderControl(const std::string& label, MeshCollider** collider, float size = 64, MeshCollider** oldValue = nullptr);
 	ChangeStatus DrawSoundControl(const std::string& label, Sound** sound, float size = 64, Sound** oldValue = nullptr);
 
-	ChangeData DrawReflectedMember(void* object, MemberData& member);
-	ChangeData DrawMetaType(void* object, MetaType& type);
+	// Euler angles last shown for each quaternion member of an object, by member name. Without it the angles
+	// are converted back from the quaternion every frame and jump while being edited
+	typedef std::unordered_map<std::string, std::pair<glm::quat, glm::vec3>> EulerAnglesCache;
+
+	ChangeData DrawReflectedMember(void* object, MemberData& member, EulerAnglesCache* eulerAngles = nullptr);
+	ChangeData DrawMetaType(void* object, MetaType& type, EulerAnglesCache* eulerAngles = nullptr);
 }
\ No newline at end of file
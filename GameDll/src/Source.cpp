@@ -74,7 +74,7 @@ public:
             cameraTransform.position = playerTransform.position + lookDirection * distance;
 
 
-            cameraTransform.rotation = glm::radians(orbitAngles);   
+            cameraTransform.rotation = glm::quat(glm::radians(orbitAngles));   
         }
     }
 };
@@ -135,7 +135,7 @@ public:
             if (glm::length(direction) > 0)
             {
                 direction /= glm::length(direction);
-                playerTransform.rotation.y = std::atan2(direction.x, direction.z);
+                playerTransform.rotation = glm::angleAxis(std::atan2(direction.x, direction.z), glm::vec3(0, 1, 0));
             }
 
             playerComponent.velocity.x = direction.x * playerComponent.speed;
@@ -288,10 +288,21 @@ void Init(Seidon::Application& app)
 
     app.RegisterComponent<AttackerComponent>();
 
-    app.RegisterSystem<PlayerSystem>();
-    app.RegisterSystem<CameraSystem>();
-    app.RegisterSystem<UISystem>();
-    app.RegisterSystem<AttackerSystem>();
+    app.RegisterSystem<PlayerSystem>()
+        .Reads<Seidon::CameraComponent>()
+        .Writes<PlayerComponent, Seidon::TransformComponent, Seidon::CharacterControllerComponent,
+            Seidon::DynamicRigidbodyComponent, DamageableComponent>();
+
+    app.RegisterSystem<CameraSystem>()
+        .Reads<PlayerComponent, Seidon::CameraComponent>()
+        .Writes<Seidon::TransformComponent>();
+
+    app.RegisterSystem<UISystem>()
+        .Reads<UIComponent, Seidon::MouseSelectionComponent, Seidon::RenderComponent>();
+
+    app.RegisterSystem<AttackerSystem>()
+        .Reads<Seidon::TransformComponent>()
+        .Writes<DamageableComponent, Seidon::RenderComponent>();
 }
 
 void Destroy(Seidon::Application& app)
@@ -7,6 +7,11 @@ namespace Seidon
 	{
 	private:
 		Entity selectedEntity;
+
+		// Enabled with --system-timings <file.csv>
+		std::ofstream systemTimingsOut;
+		int frame = 0;
+
 	public:
 		void Init() override
 		{
@@ -15,19 +20,36 @@ namespace Seidon
 			window->EnableMouseCursor(false);
 			window->EnableFullscreen(true);
 
-			std::ifstream in("Assets/ResourceRegistry.sdreg", std::ios::in | std::ios::binary);
+			BinaryReader in("Assets/ResourceRegistry.sdreg");
 			resourceManager->Load(in);
 
 			Scene* scene = new Scene();
-
-			std::ifstream in2("Assets/Test.sdscene", std::ios::in | std::ios::binary);
-			scene->Load(in2);
+			scene->Load("Assets/Test.sdscene");
 
 			sceneManager->SetActiveScene(scene);
+
+			std::string systemTimingsPath = GetArgumentValue("--system-timings");
+			if (!systemTimingsPath.empty())
+			{
+				systemTimingsOut.open(systemTimingsPath, std::ios::out);
+
+				if (systemTimingsOut)
+					systemTimingsOut << "frame,system,milliseconds\n";
+				else
+					std::cerr << "Error opening system timings file: " << systemTimingsPath << std::endl;
+			}
 		}
 
 		void Update() override
 		{
+			// Runs before the scene update, so these are the timings of the previous frame
+			if (systemTimingsOut.is_open() && frame > 0)
+			{
+				for (auto& [name, timings] : sceneManager->GetActiveScene()->GetSystemTimings())
+					systemTimingsOut << frame - 1 << ",\"" << name << "\"," << timings.GetLast() << "\n";
+			}
+
+			frame++;
 		}
 
 		void Destroy() override
@@ -48,6 +48,11 @@ namespace Seidon
 		}
 	};
 
+	// Keys are saved as their time followed by their value, so arrays of them are read and written in one go
+	static_assert(sizeof(PositionKey) == sizeof(float) + sizeof(glm::vec3), "PositionKey must not have padding");
+	static_assert(sizeof(RotationKey) == sizeof(float) + sizeof(glm::quat), "RotationKey must not have padding");
+	static_assert(sizeof(ScalingKey) == sizeof(float) + sizeof(glm::vec3), "ScalingKey must not have padding");
+
 	struct AnimationChannel
 	{
 		std::string boneName;
@@ -71,7 +76,10 @@ namespace Seidon
 		using Asset::Save;
 		using Asset::Load;
 
-		void Save(std::ofstream& out) override;
-		void Load(std::ifstream& in) override;
+		void Save(BinaryWriter& out) override;
+		void Load(BinaryReader& in) override;
+
+		bool SupportsAsyncLoad() override { return true; }
+		void LoadCpuData(BinaryReader& in) override { Load(in); }
 	};
 }
\ No newline at end of file
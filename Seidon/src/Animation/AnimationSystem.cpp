@@ -14,89 +14,90 @@ namespace Seidon
 
 	void AnimationSystem::Update(float deltaTime)
 	{
-		entt::basic_group group = scene->GetRegistry().group<AnimationComponent>(entt::get<SkinnedRenderComponent>);
+		entt::basic_group group = scene->GetRegistry().group<AnimationComponent>(entt::get<SkinnedRenderComponent>, entt::exclude<InactiveComponent>);
 
-		for (entt::entity e : group)
-		{
-			AnimationComponent& a = group.get<AnimationComponent>(e);
-			SkinnedRenderComponent& r = group.get<SkinnedRenderComponent>(e);
-
-			Animation* animation = a.animation;
-			Armature* armature = &r.mesh->armature;
-
-			if (animation->channels.size() > armature->bones.size())
-			{
-				std::cout << animation->channels.size() << " " << armature->bones.size() << std::endl;
-				std::cerr << "Animation " << animation->name << " incompatible with armature " << armature->name << std::endl;
-				return;
-			}
-
-			float duration = animation->duration * animation->ticksPerSecond;
-
-			a.runtimeTime += animation->ticksPerSecond * deltaTime;
-			float timePoint = fmod(a.runtimeTime, animation->duration);
-
-			int channelIndex = 0;
-			for (int i = 0; i < animation->channels.size(); i++)
+		scene->ParallelIterate
+		(
+			group,
+			[&](EntityId e, AnimationComponent& a, SkinnedRenderComponent& r)
 			{
-				AnimationChannel& channel = animation->channels[i];
+				Animation* animation = a.animation;
+				Armature* armature = &r.mesh->armature;
 
-				int keyIndex = GetPositionKeyIndex(channel.positionKeys, timePoint, a.lastPositionKeyIndices[i]);
-
-				glm::mat4 translation;
-				if (channel.positionKeys.size() > 1)
+				if (animation->channels.size() > armature->bones.size())
 				{
-					float currentKeyTime = channel.positionKeys[keyIndex].time;
-					float nextKeyTime = channel.positionKeys[keyIndex + 1].time;
-
-					translation = glm::translate(
-						glm::identity<glm::mat4>(),
-						glm::mix(channel.positionKeys[keyIndex].value, channel.positionKeys[keyIndex + 1].value, (timePoint - currentKeyTime) / (nextKeyTime - currentKeyTime))
-					);
+					std::cout << animation->channels.size() << " " << armature->bones.size() << std::endl;
+					std::cerr << "Animation " << animation->name << " incompatible with armature " << armature->name << std::endl;
+					return;
 				}
-				else
-					translation = glm::translate(glm::identity<glm::mat4>(), channel.positionKeys[keyIndex].value);
 
-				a.lastPositionKeyIndices[i] = keyIndex;
+				float duration = animation->duration * animation->ticksPerSecond;
 
-				keyIndex = GetRotationKeyIndex(channel.rotationKeys, timePoint, a.lastRotationKeyIndices[i]);
+				a.runtimeTime += animation->ticksPerSecond * deltaTime;
+				float timePoint = fmod(a.runtimeTime, animation->duration);
 
-				glm::mat4 rotation;
-				if (channel.rotationKeys.size() > 1)
+				int channelIndex = 0;
+				for (int i = 0; i < animation->channels.size(); i++)
 				{
-					float currentKeyTime = channel.rotationKeys[keyIndex].time;
-					float nextKeyTime = channel.rotationKeys[keyIndex + 1].time;
-
-					 rotation = glm::toMat4(
-						glm::slerp(channel.rotationKeys[keyIndex].value, channel.rotationKeys[keyIndex + 1].value, (timePoint - currentKeyTime) / (nextKeyTime - currentKeyTime))
-					);
+					AnimationChannel& channel = animation->channels[i];
+
+					int keyIndex = GetPositionKeyIndex(channel.positionKeys, timePoint, a.lastPositionKeyIndices[i]);
+
+					glm::mat4 translation;
+					if (channel.positionKeys.size() > 1)
+					{
+						float currentKeyTime = channel.positionKeys[keyIndex].time;
+						float nextKeyTime = channel.positionKeys[keyIndex + 1].time;
+
+						translation = glm::translate(
+							glm::identity<glm::mat4>(),
+							glm::mix(channel.positionKeys[keyIndex].value, channel.positionKeys[keyIndex + 1].value, (timePoint - currentKeyTime) / (nextKeyTime - currentKeyTime))
+						);
+					}
+					else
+						translation = glm::translate(glm::identity<glm::mat4>(), channel.positionKeys[keyIndex].value);
+
+					a.lastPositionKeyIndices[i] = keyIndex;
+
+					keyIndex = GetRotationKeyIndex(channel.rotationKeys, timePoint, a.lastRotationKeyIndices[i]);
+
+					glm::mat4 rotation;
+					if (channel.rotationKeys.size() > 1)
+					{
+						float currentKeyTime = channel.rotationKeys[keyIndex].time;
+						float nextKeyTime = channel.rotationKeys[keyIndex + 1].time;
+
+						 rotation = glm::toMat4(
+							glm::slerp(channel.rotationKeys[keyIndex].value, channel.rotationKeys[keyIndex + 1].value, (timePoint - currentKeyTime) / (nextKeyTime - currentKeyTime))
+						);
+					}
+					else
+						rotation = glm::toMat4(channel.rotationKeys[keyIndex].value);
+
+					a.lastRotationKeyIndices[i] = keyIndex;
+
+					keyIndex = GetScalingKeyIndex(channel.scalingKeys, timePoint, a.lastScalingKeyIndices[i]);
+
+					glm::mat4 scale;
+					if (channel.scalingKeys.size() > 1)
+					{
+						float currentKeyTime = channel.scalingKeys[keyIndex].time;
+						float nextKeyTime = channel.scalingKeys[keyIndex + 1].time;
+
+						scale = glm::scale(
+							glm::identity<glm::mat4>(),
+							glm::mix(channel.scalingKeys[keyIndex].value, channel.scalingKeys[keyIndex + 1].value, (timePoint - currentKeyTime) / (nextKeyTime - currentKeyTime))
+						);
+					}
+					else
+						scale = glm::scale(glm::identity<glm::mat4>(), channel.scalingKeys[keyIndex].value);
+
+					a.lastScalingKeyIndices[i] = keyIndex;
+
+					r.boneTransforms[channel.boneId] = translation * rotation * scale;
 				}
-				else
-					rotation = glm::toMat4(channel.rotationKeys[keyIndex].value);
-
-				a.lastRotationKeyIndices[i] = keyIndex;
-
-				keyIndex = GetScalingKeyIndex(channel.scalingKeys, timePoint, a.lastScalingKeyIndices[i]);
-
-				glm::mat4 scale;
-				if (channel.scalingKeys.size() > 1)
-				{
-					float currentKeyTime = channel.scalingKeys[keyIndex].time;
-					float nextKeyTime = channel.scalingKeys[keyIndex + 1].time;
-
-					scale = glm::scale(
-						glm::identity<glm::mat4>(),
-						glm::mix(channel.scalingKeys[keyIndex].value, channel.scalingKeys[keyIndex + 1].value, (timePoint - currentKeyTime) / (nextKeyTime - currentKeyTime))
-					);
-				}
-				else
-					scale = glm::scale(glm::identity<glm::mat4>(), channel.scalingKeys[keyIndex].value);
-
-				a.lastScalingKeyIndices[i] = keyIndex;
-
-				r.boneTransforms[channel.boneId] = translation * rotation * scale;
 			}
-		}
+		);
 	}
 
 	void AnimationSystem::Destroy()
@@ -31,8 +31,8 @@ namespace Seidon
 		void Save(const std::string& path);
 		void Load(const std::string& path);
 
-		void Save(std::ofstream& out) {}
-		void Load(std::ifstream& in)  {}
+		void Save(BinaryWriter& out) {}
+		void Load(BinaryReader& in)  {}
 	private:
 		SoLoud::Wav* source;
 	};
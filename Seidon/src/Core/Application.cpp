@@ -3,6 +3,7 @@
 #include "../Graphics/RenderSystem.h"
 #include "../Animation/AnimationSystem.h"
 #include "../Physics/PhysicSystem.h"
+#include "../Debug/Profiler.h"
 
 namespace Seidon
 {
@@ -13,6 +14,29 @@ namespace Seidon
 
 	}
 
+	void Application::SetArguments(int argc, char** argv)
+	{
+		arguments.clear();
+
+		for (int i = 1; i < argc; i++)
+			arguments.push_back(argv[i]);
+	}
+
+	bool Application::HasArgument(const std::string& name)
+	{
+		return std::find(arguments.begin(), arguments.end(), name) != arguments.end();
+	}
+
+	std::string Application::GetArgumentValue(const std::string& name)
+	{
+		auto it = std::find(arguments.begin(), arguments.end(), name);
+
+		if (it == arguments.end() || it + 1 == arguments.end())
+			return std::string();
+
+		return *(it + 1);
+	}
+
 	void Application::AppInit()
 	{
 		instance = this;
@@ -22,6 +46,7 @@ namespace Seidon
 		inputManager = new InputManager();
 		resourceManager = new ResourceManager();
 		workManager = new WorkManager();
+		ioManager = new IoManager();
 		physicsApi = new PhysicsApi();
 		soundApi = new SoundApi();
 
@@ -31,11 +56,53 @@ namespace Seidon
 		soundApi->Init();
 		resourceManager->Init();
 		workManager->Init();
+		ioManager->Init(workManager);
+
+		RegisterEngineTypes();
+
+		Init();
+	}
+
+	void Application::AppInitHeadless()
+	{
+		instance = this;
+
+		// Only what scenes, physics and assets need on the CPU: no window, GL context or sound
+		sceneManager = new SceneManager();
+		resourceManager = new ResourceManager();
+		workManager = new WorkManager();
+		ioManager = new IoManager();
+		physicsApi = new PhysicsApi();
+
+		physicsApi->Init();
+		resourceManager->Init(true);
+		workManager->Init();
+		ioManager->Init(workManager);
 
-		RegisterSystem<RenderSystem>();
+		RegisterEngineTypes();
 
-		RegisterSystem<AnimationSystem>();
-		RegisterSystem<PhysicSystem>();
+		Init();
+	}
+
+	void Application::RegisterEngineTypes()
+	{
+		// Rendering touches GL, so it runs on the main thread after every other system, which may have moved entities
+		RegisterSystem<RenderSystem>()
+			.RunOnMainThread()
+			.UpdateTransformsBefore()
+			.Reads<HierarchyComponent, InactiveComponent, DirectionalLightComponent, CubemapComponent, RenderComponent,
+				WireframeRenderComponent, SpriteRenderComponent, TextRenderComponent, UIAnchorComponent, UITextComponent, UISpriteComponent>()
+			.Writes<TransformComponent, CameraComponent, ProceduralSkylightComponent, SkinnedRenderComponent, MouseSelectionComponent>()
+			.SetExecutionOrder(100);
+
+		RegisterSystem<AnimationSystem>()
+			.Writes<AnimationComponent, SkinnedRenderComponent>();
+
+		// Bodies are synced from the transforms moved earlier in the frame
+		RegisterSystem<PhysicSystem>()
+			.Reads<CubeColliderComponent, MeshColliderComponent, StaticRigidbodyComponent>()
+			.Writes<TransformComponent, DynamicRigidbodyComponent, CharacterControllerComponent>()
+			.UpdateTransformsBefore();
 
 		RegisterComponent<IDComponent>()
 			.AddMember("ID", &IDComponent::ID);
@@ -47,7 +114,7 @@ namespace Seidon
 
 		RegisterComponent<TransformComponent>()
 			.AddMember("Position", &TransformComponent::position)
-			.AddMember("Rotation", &TransformComponent::rotation, Types::VECTOR3_ANGLES)
+			.AddMember("Rotation", &TransformComponent::rotation)
 			.AddMember("Scale", &TransformComponent::scale)
 			.AddMember("Parent", &TransformComponent::parent)
 			.AddMember("Children", &TransformComponent::children);
@@ -139,35 +206,48 @@ namespace Seidon
 			.AddMember("Contact Offset", &CharacterControllerComponent::contactOffset)
 			.AddMember("Min Movement Distance", &CharacterControllerComponent::minMoveDistance)
 			.AddMember("Max Slope Angle", &CharacterControllerComponent::maxSlopeAngle);
-
-		Init();
 	}
 
 	void Application::AppUpdate()
 	{
+		SD_PROFILE_FRAME();
+
 		window->BeginFrame();
 		inputManager->Update();
 		soundApi->Update();
 
-		Update();
-		sceneManager->UpdateActiveScene(window->GetDeltaTime());
+		{
+			SD_PROFILE_ZONE("Application Update");
+			Update();
+		}
+
+		{
+			SD_PROFILE_ZONE("Scene Update");
+			sceneManager->UpdateActiveScene(window->GetDeltaTime());
+		}
 		
 		workManager->Update();
-		window->EndFrame();
+
+		{
+			SD_PROFILE_ZONE("End Frame");
+			window->EndFrame();
+		}
 	}
 
 	void Application::AppDestroy()
 	{
 		Destroy();
-		soundApi->Destroy();
-		physicsApi->Destroy();
+		if (soundApi) soundApi->Destroy();
+		if (physicsApi) physicsApi->Destroy();
 		resourceManager->Destroy();
+		ioManager->Destroy();
 		workManager->Destroy();
-		window->Destroy();
+		if (window) window->Destroy();
 
 		delete window;
 		delete resourceManager;
 		delete workManager;
+		delete ioManager;
 		delete inputManager;
 		delete physicsApi;
 		delete soundApi;
@@ -6,6 +6,7 @@
 #include "InputManager.h"
 #include "ResourceManager.h"
 #include "WorkManager.h"
+#include "IoManager.h"
 
 #include "Ecs/Components.h"
 #include "Ecs/SceneManager.h"
@@ -27,6 +28,8 @@ namespace Seidon
 		virtual ~Application();
 
 		void AppInit();
+		// For tools and benchmarks, AppUpdate can't be used without a window
+		void AppInitHeadless();
 		void AppUpdate();
 		void AppDestroy();
 
@@ -34,11 +37,19 @@ namespace Seidon
 		virtual void Update();
 		virtual void Destroy();
 
+		void SetArguments(int argc, char** argv);
+		inline const std::vector<std::string>& GetArguments() { return arguments; }
+
+		bool HasArgument(const std::string& name);
+		// Argument following name (e.g. "--option value"), empty if there is none
+		std::string GetArgumentValue(const std::string& name);
+
 		Window* GetWindow() { return window; }
 
 		inline InputManager* GetInputManager() { return inputManager; }
 		inline ResourceManager* GetResourceManager() { return resourceManager; }
 		inline WorkManager* GetWorkManager() { return workManager; }
+		inline IoManager* GetIoManager() { return ioManager; }
 		inline SceneManager* GetSceneManager() { return sceneManager; }
 		inline PhysicsApi* GetPhysicsApi() { return physicsApi; }
 		inline SoundApi* GetSoundApi() { return soundApi; }
@@ -56,6 +67,15 @@ namespace Seidon
 			t.Remove = &Application::RemoveComponent<Type>;
 			t.Has = &Application::HasComponent<Type>;
 			t.Copy = &Application::CopyComponent<Type>;
+			t.MarkChanged = &Application::MarkComponentChanged<Type>;
+			t.CopyAll = &Application::CopyAllComponents<Type>;
+			t.InstantiateAll = &Application::InstantiateComponents<Type>;
+			t.SnapshotAll = &Application::SnapshotComponents<Type>;
+			t.ClearAll = &Application::ClearComponents<Type>;
+			t.RestoreAll = &Application::RestoreComponents<Type>;
+			t.GetAll = &Application::GetAllComponents<Type>;
+			t.CreateColumn = &Application::CreateComponentColumn<Type>;
+			t.InsertAll = &Application::InsertComponents<Type>;
 
 			registeredComponents.push_back(t);
 			registeredComponentsIndexToName[typeid(Type).name()] = registeredComponents.size() - 1;
@@ -160,14 +180,17 @@ namespace Seidon
 		}
 
 	protected:
-		Window* window;
+		std::vector<std::string> arguments;
+
+		Window* window = nullptr;
 
-		SceneManager* sceneManager;
-		InputManager* inputManager;
-		ResourceManager* resourceManager;
-		WorkManager* workManager;
-		PhysicsApi* physicsApi;
-		SoundApi* soundApi;
+		SceneManager* sceneManager = nullptr;
+		InputManager* inputManager = nullptr;
+		ResourceManager* resourceManager = nullptr;
+		WorkManager* workManager = nullptr;
+		IoManager* ioManager = nullptr;
+		PhysicsApi* physicsApi = nullptr;
+		SoundApi* soundApi = nullptr;
 
 	public:
 		std::vector<SystemMetaType> registeredSystems;
@@ -179,6 +202,8 @@ namespace Seidon
 		static Application* instance;
 
 	private:
+		void RegisterEngineTypes();
+
 		template<typename Type>
 		static Type& GetComponent(Entity entity)
 		{
@@ -210,6 +235,72 @@ namespace Seidon
 			dst.AddComponent<Type>(component);
 		}
 
+		template<typename Type>
+		static void CopyAllComponents(Scene& src, Scene& dst, const std::vector<EntityId>& entityMap)
+		{
+			src.CopyComponentsTo<Type>(dst, entityMap);
+		}
+
+		template<typename Type>
+		static void InstantiateComponents(Scene& prefabScene, Scene& dst, const std::vector<EntityId>& prefabEntities,
+			const std::vector<EntityId>& instances)
+		{
+			dst.InstantiateComponents<Type>(prefabScene, prefabEntities, instances);
+		}
+
+		template<typename Type>
+		static std::shared_ptr<const ComponentColumn> SnapshotComponents(Scene& scene)
+		{
+			return scene.SnapshotComponents<Type>();
+		}
+
+		template<typename Type>
+		static void ClearComponents(Scene& scene)
+		{
+			scene.ClearComponents<Type>();
+		}
+
+		template<typename Type>
+		static void RestoreComponents(Scene& scene, const ComponentColumn& column)
+		{
+			scene.RestoreComponents<Type>(column);
+		}
+
+		template<typename Type>
+		static void GetAllComponents(Scene& scene, std::vector<EntityId>& entities, std::vector<void*>& components)
+		{
+			scene.GetComponents<Type>(entities, components);
+		}
+
+		template<typename Type>
+		static std::shared_ptr<ComponentColumn> CreateComponentColumn(size_t count, std::vector<void*>& components)
+		{
+			std::shared_ptr<TypedComponentColumn<Type>> column = std::make_shared<TypedComponentColumn<Type>>();
+			components.assign(count, nullptr);
+
+			if constexpr (!std::is_empty_v<Type>)
+			{
+				column->components.resize(count);
+
+				for (size_t i = 0; i < count; i++)
+					components[i] = &column->components[i];
+			}
+
+			return column;
+		}
+
+		template<typename Type>
+		static void InsertComponents(Scene& scene, ComponentColumn& column)
+		{
+			scene.InsertComponents<Type>(column);
+		}
+
+		template<typename Type>
+		static void MarkComponentChanged(Entity entity)
+		{
+			entity.scene->MarkComponentChanged<Type>(entity.ID);
+		}
+
 		template<typename Type>
 		static System* InstantiateSystem()
 		{
@@ -1,8 +1,9 @@
 #pragma once
 #include "UUID.h"
+#include "../Utils/BinaryReader.h"
+#include "../Utils/BinaryWriter.h"
 
 #include <string>
-#include <fstream>
 
 namespace Seidon
 {
@@ -12,18 +13,30 @@ namespace Seidon
 		std::string name;
 		std::string path;
 
-		virtual void Save(std::ofstream& out) = 0;
-		virtual void Load(std::ifstream& in) = 0;
+		virtual void Save(BinaryWriter& out) = 0;
+		virtual void Load(BinaryReader& in) = 0;
+
+		/*
+		* Asynchronous loading is split in two steps: LoadCpuData runs on a worker thread and must not
+		* touch GL or other assets, UploadGpuData then runs on the main thread.
+		* Assets that don't support it are always loaded synchronously.
+		*/
+		virtual bool SupportsAsyncLoad() { return false; }
+		virtual void LoadCpuData(BinaryReader& in) {}
+
+		// LoadCpuData gets a reader over the mapped file instead of a copy of its content, for assets using it in place
+		virtual bool SupportsMappedLoad() { return false; }
+		virtual void UploadGpuData() {}
 
 		virtual void Save(const std::string& path)
 		{
-			std::ofstream out(path, std::ios::out | std::ios::binary);
+			BinaryWriter out(path);
 			Save(out);
 		}
 
 		virtual void Load(const std::string& path)
 		{
-			std::ifstream in(path, std::ios::in | std::ios::binary);
+			BinaryReader in(path);
 			Load(in);
 		}
 	};
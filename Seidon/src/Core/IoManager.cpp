@@ -0,0 +1,114 @@
+#include "IoManager.h"
+#include "../Debug/Profiler.h"
+
+#include <fstream>
+#include <iostream>
+
+namespace Seidon
+{
+    void IoManager::Init(WorkManager* workManager, int threadCount)
+    {
+        this->workManager = workManager;
+        running = true;
+
+        for (int i = 0; i < threadCount; i++)
+            threads.push_back(std::thread(&IoManager::IoLoop, this));
+    }
+
+    void IoManager::Destroy()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            running = false;
+        }
+        requestCondition.notify_all();
+
+        // Workers only exit once the queue is empty, so every handle gets signaled
+        for (std::thread& thread : threads)
+            thread.join();
+
+        threads.clear();
+    }
+
+    Task<FileBuffer> IoManager::ReadFileAsync(const std::string& path)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        auto it = pendingReads.find(path);
+        if (it != pendingReads.end())
+            return Task<FileBuffer>(it->second.handle, it->second.buffer);
+
+        capacityCondition.wait(lock, [&]() { return pendingReads.size() < maxQueueDepth; });
+
+        ReadRequest request;
+        request.path = path;
+        request.handle = workManager->CreateSignal();
+        request.buffer = std::make_shared<FileBuffer>();
+
+        pendingReads[path] = request;
+        requests.push_back(request);
+
+        lock.unlock();
+        requestCondition.notify_one();
+
+        return Task<FileBuffer>(request.handle, request.buffer);
+    }
+
+    int IoManager::GetQueueDepth()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return pendingReads.size();
+    }
+
+    void IoManager::IoLoop()
+    {
+        SD_PROFILE_THREAD("I/O");
+
+        // Signal can run continuations on this thread, so it needs its own per-thread data
+        workManager->RegisterThread();
+
+        while (true)
+        {
+            ReadRequest request;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                requestCondition.wait(lock, [&]() { return !requests.empty() || !running; });
+
+                if (requests.empty())
+                    return;
+
+                request = std::move(requests.front());
+                requests.pop_front();
+            }
+
+            ReadFile(request.path, *request.buffer);
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                pendingReads.erase(request.path);
+            }
+            capacityCondition.notify_all();
+
+            workManager->Signal(request.handle);
+        }
+    }
+
+    void IoManager::ReadFile(const std::string& path, FileBuffer& buffer)
+    {
+        SD_PROFILE_FUNCTION();
+
+        std::ifstream in(path, std::ios::in | std::ios::binary | std::ios::ate);
+
+        if (!in)
+        {
+            std::cerr << "Error opening file: " << path << std::endl;
+            return;
+        }
+
+        std::streamsize size = in.tellg();
+        in.seekg(0, std::ios::beg);
+
+        buffer.resize(size);
+        in.read(buffer.data(), size);
+    }
+}
\ No newline at end of file
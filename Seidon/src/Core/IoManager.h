@@ -0,0 +1,59 @@
+#pragma once
+#include "WorkManager.h"
+#include "Task.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+
+namespace Seidon
+{
+	typedef std::vector<char> FileBuffer;
+
+	/*
+	* Small thread pool dedicated to blocking file reads, so that slow disks never stall the WorkManager threads.
+	* Reads of a file that is already queued or being read are coalesced into the same request.
+	*/
+	class IoManager
+	{
+	private:
+		struct ReadRequest
+		{
+			std::string path;
+			JobHandle handle;
+			std::shared_ptr<FileBuffer> buffer;
+		};
+
+		WorkManager* workManager;
+		std::vector<std::thread> threads;
+
+		std::deque<ReadRequest> requests;
+		std::unordered_map<std::string, ReadRequest> pendingReads;
+
+		std::mutex mutex;
+		std::condition_variable requestCondition;
+		std::condition_variable capacityCondition;
+
+		int maxQueueDepth = 64;
+		bool running = false;
+
+	public:
+		void Init(WorkManager* workManager, int threadCount = 2);
+		void Destroy();
+
+		// Blocks while maxQueueDepth reads are already pending, the buffer is empty if the file can't be opened
+		Task<FileBuffer> ReadFileAsync(const std::string& path);
+
+		inline void SetMaxQueueDepth(int depth) { maxQueueDepth = depth; }
+		inline int GetMaxQueueDepth() { return maxQueueDepth; }
+		int GetQueueDepth();
+
+	private:
+		void IoLoop();
+		void ReadFile(const std::string& path, FileBuffer& buffer);
+	};
+}
\ No newline at end of file
@@ -13,6 +13,13 @@
 #include "Animation/Animation.h"
 #include "Physics/MeshCollider.h"
 
+#include "Utils/BinaryReader.h"
+#include "Utils/BinaryWriter.h"
+#include "Utils/MappedFile.h"
+
+#include "Application.h"
+#include "../Debug/Debug.h"
+
 #include <unordered_set>
 
 #include <iostream>
@@ -20,8 +27,25 @@
 
 namespace Seidon
 {
-    void ResourceManager::Init()
+    void ResourceManager::Init(bool headless)
     {
+        Mesh* mesh = new Mesh(9);
+        mesh->name = "Empty Mesh";
+        AddAsset("empty_mesh", mesh);
+
+        SkinnedMesh* skinnedMesh = new SkinnedMesh(10);
+        skinnedMesh->name = "Empty Skinned Mesh";
+        AddAsset("empty_skinned_mesh", skinnedMesh);
+
+        Animation* animation = new Animation(11);
+        animation->name = "Default Animation";
+        animation->duration = 0;
+        animation->ticksPerSecond = 24;
+        AddAsset("default_animation", animation);
+
+        // Everything below needs a GL context
+        if (headless) return;
+
         stbi_set_flip_vertically_on_load(true);
 
         unsigned char white[] = { 255, 255, 255};
@@ -69,20 +93,6 @@ namespace Seidon
         c->CreateFromEquirectangularMap(&t1);
         AddAsset("default_cubemap", c);
 
-        Mesh* mesh = new Mesh(9);
-        mesh->name = "Empty Mesh";
-        AddAsset("empty_mesh", mesh);
-
-        SkinnedMesh* skinnedMesh = new SkinnedMesh(10);
-        skinnedMesh->name = "Empty Skinned Mesh";
-        AddAsset("empty_skinned_mesh", skinnedMesh);
-
-        Animation* animation = new Animation(11);
-        animation->name = "Default Animation";
-        animation->duration = 0;
-        animation->ticksPerSecond = 24;
-        AddAsset("default_animation", animation);
-
         m = new Material(12);
         m->name = "Preetham Sky Material";
 
@@ -121,6 +131,14 @@ namespace Seidon
 
     void ResourceManager::Destroy()
     {
+        // Finishing a load removes it from pendingLoads, so the handles are copied first
+        std::vector<JobHandle> loads;
+        for (auto& [id, load] : pendingLoads)
+            loads.push_back(load.handle);
+
+        for (JobHandle& load : loads)
+            WaitForLoad(load);
+
         for (auto [id, asset] : assets)
             delete asset;
 
@@ -130,37 +148,25 @@ namespace Seidon
         assetPathToId.clear();
     }
 
-    void ResourceManager::Save(std::ofstream& out)
+    void ResourceManager::Save(BinaryWriter& out)
     {
-        size_t size = idToAssetPath.size();
-        out.write((char*)&size, sizeof(size_t));
+        out.Write(idToAssetPath.size());
 
         for (auto& [id, path] : idToAssetPath)
         {
-            out.write((char*)&id, sizeof(UUID));
-
-            size_t lenght = path.length() + 1;
-            out.write((char*)&lenght, sizeof(size_t));
-            out.write(path.c_str(), lenght * sizeof(char));
+            out.Write(id);
+            out.WriteString(path);
         }
     }
 
-    void ResourceManager::Load(std::ifstream& in)
+    void ResourceManager::Load(BinaryReader& in)
     {
-        char buffer[500];
-        size_t size = 0;
+        size_t size = in.ReadCount(sizeof(UUID) + sizeof(size_t) + 1);
 
-        in.read((char*)&size, sizeof(size_t));
-        for (int i = 0; i < size; i++)
+        for (size_t i = 0; i < size && in.IsGood(); i++)
         {
-            UUID id;
-            in.read((char*)&id, sizeof(UUID));
-
-            size_t lenght = 0;
-            in.read((char*)&lenght, sizeof(size_t));
-            in.read(buffer, lenght * sizeof(char));
-
-            std::string path = std::string(buffer);
+            UUID id = in.Read<UUID>();
+            std::string path = in.ReadString();
 
             idToAssetPath[id] = path;
             assetPathToId[path] = id;
@@ -198,4 +204,108 @@ namespace Seidon
         idToAssetPath[asset->id] = name;
         assetPathToId[name] = asset->id;
     }
+
+    void ResourceManager::BeginLoadBatch()
+    {
+        loadBatchDepth++;
+    }
+
+    void ResourceManager::EndLoadBatch()
+    {
+        SD_ASSERT(loadBatchDepth > 0, "No load batch to end");
+
+        if (--loadBatchDepth > 0) return;
+
+        std::vector<JobHandle> loads;
+        loads.swap(batchLoads);
+
+        Application::Get()->GetWorkManager()->Wait(loads);
+
+        std::vector<std::function<void(void)>> callbacks;
+        callbacks.swap(batchCallbacks);
+
+        for (auto& callback : callbacks)
+            callback();
+    }
+
+    void ResourceManager::RunAfterLoadBatch(const std::function<void(void)>& callback)
+    {
+        if (loadBatchDepth > 0)
+            batchCallbacks.push_back(callback);
+        else
+            callback();
+    }
+
+    JobHandle ResourceManager::ScheduleAsyncLoad(Asset* asset, const std::string& path)
+    {
+        WorkManager& workManager = *Application::Get()->GetWorkManager();
+
+        SD_ASSERT(workManager.IsMainThread(), "Assets can only be loaded from the main thread");
+
+        std::string absolutePath = path[1] == ':' ? path : RelativeToAbsolutePath(path);
+
+        // Assets that can't be split are loaded right away, the returned handle is already finished
+        if (!asset->SupportsAsyncLoad())
+        {
+            asset->Load(absolutePath);
+            AddAsset(path, asset);
+
+            return JobHandle();
+        }
+
+        UUID id = asset->id;
+        JobHandle read;
+
+        // Set before the job starts, LoadCpuData only gets a reader and reports errors with it
+        asset->path = absolutePath;
+
+        if (asset->SupportsMappedLoad())
+        {
+            // Mapping doesn't read anything, the pages are read when the asset first touches them
+            read = workManager.Execute([asset, absolutePath]()
+                {
+                    BinaryReader in(std::make_shared<MappedFile>(absolutePath));
+                    if (!in.IsGood()) return;
+
+                    asset->LoadCpuData(in);
+                }
+            );
+        }
+        else
+        {
+            // The blocking read happens on the I/O pool, workers only decode the bytes once they are in memory
+            Task<FileBuffer> file = Application::Get()->GetIoManager()->ReadFileAsync(absolutePath);
+
+            read = workManager.Execute([asset, file]() mutable
+                {
+                    FileBuffer& buffer = file.Get();
+                    if (buffer.empty()) return;
+
+                    BinaryReader in(buffer.data(), buffer.size());
+                    asset->LoadCpuData(in);
+                },
+                { file.GetHandle() }
+            );
+        }
+
+        JobHandle upload = workManager.ExecuteOnMainThread([this, asset, path, id]()
+            {
+                asset->UploadGpuData();
+
+                AddAsset(path, asset);
+                pendingLoads.erase(id);
+            },
+            { read },
+            MainThreadPriority::GPU_UPLOAD
+        );
+
+        pendingLoads[id] = { asset, upload };
+
+        return upload;
+    }
+
+    void ResourceManager::WaitForLoad(const JobHandle& handle)
+    {
+        Application::Get()->GetWorkManager()->Wait(handle);
+    }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "UUID.h"
 #include "Asset.h"
+#include "Task.h"
 
 #include <unordered_map>
 #include <utility>
@@ -11,11 +12,11 @@ namespace Seidon
 	class ResourceManager
 	{
 	public:
-		void Init();
+		void Init(bool headless = false);
 		void Destroy();
 
-		void Save(std::ofstream& out);
-		void Load(std::ifstream& in);
+		void Save(BinaryWriter& out);
+		void Load(BinaryReader& in);
 
 		void SetAssetDirectory(const std::string& path) { assetDirectory = path; }
 		std::string GetAssetDirectory() { return assetDirectory; }
@@ -71,14 +72,54 @@ namespace Seidon
 			return LoadAsset<T>(name, UUID(), absolute);
 		}
 
+		/*
+		* Reads and decodes the asset on a worker thread, then uploads it on the main thread.
+		* Must be called from the main thread, the asset is added to the manager once the task is finished.
+		*/
+		template<typename T>
+		Task<T*> LoadAssetAsync(UUID id)
+		{
+			if (assets.count(id) > 0) return Task<T*>((T*)assets[id]);
+
+			JobHandle handle;
+			T* asset = BeginAsyncLoad<T>(id, handle);
+
+			return Task<T*>(handle, std::make_shared<T*>(asset));
+		}
+
 		template<typename T>
 		T* GetOrLoadAsset(UUID id)
 		{
 			if (assets.count(id) > 0) return (T*)assets[id];
 
+			// Inside a load batch the asset is returned right away and finishes loading in the background
+			if (loadBatchDepth > 0)
+			{
+				JobHandle handle;
+				T* asset = BeginAsyncLoad<T>(id, handle);
+
+				batchLoads.push_back(handle);
+				return asset;
+			}
+
+			if (pendingLoads.count(id) > 0)
+			{
+				JobHandle handle = pendingLoads[id].handle;
+				WaitForLoad(handle);
+
+				return (T*)assets[id];
+			}
+
 			return LoadAsset<T>(id);
 		}
 
+		// Every GetOrLoadAsset(UUID) between these calls loads in parallel, EndLoadBatch waits for all of them
+		void BeginLoadBatch();
+		void EndLoadBatch();
+
+		// Runs the callback once the current load batch is finished, or right away outside of one
+		void RunAfterLoadBatch(const std::function<void(void)>& callback);
+
 		template<typename T>
 		T* GetAsset(UUID id) { return (T*)assets[id]; }
 
@@ -101,11 +142,43 @@ namespace Seidon
 		std::vector<Asset*>	GetAssets();
 
 	private:
+		struct PendingLoad
+		{
+			Asset* asset;
+			JobHandle handle;
+		};
+
 		std::unordered_map<UUID, Asset*> assets;
 		std::unordered_map<std::string, UUID> nameToAssetId;
 		std::unordered_map<UUID, std::string> idToAssetPath;
 		std::unordered_map<std::string, UUID> assetPathToId;
 
 		std::string assetDirectory = "";
+
+		std::unordered_map<UUID, PendingLoad> pendingLoads;
+
+		int loadBatchDepth = 0;
+		std::vector<JobHandle> batchLoads;
+		std::vector<std::function<void(void)>> batchCallbacks;
+
+	private:
+		template<typename T>
+		T* BeginAsyncLoad(UUID id, JobHandle& handle)
+		{
+			if (pendingLoads.count(id) > 0)
+			{
+				handle = pendingLoads[id].handle;
+				return (T*)pendingLoads[id].asset;
+			}
+
+			T* asset = new T();
+			asset->id = id;
+
+			handle = ScheduleAsyncLoad(asset, idToAssetPath[id]);
+			return asset;
+		}
+
+		JobHandle ScheduleAsyncLoad(Asset* asset, const std::string& path);
+		void WaitForLoad(const JobHandle& handle);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+#include "WorkManager.h"
+#include "../Debug/Debug.h"
+
+#include <memory>
+#include <vector>
+
+namespace Seidon
+{
+	/*
+	* Result of an asynchronous operation running on the WorkManager. The value becomes readable once
+	* the job behind the handle is finished: wait on GetHandle() or use it as a dependency of other jobs.
+	*/
+	template<typename T>
+	class Task
+	{
+	private:
+		JobHandle handle;
+		std::shared_ptr<T> result;
+
+	public:
+		Task() : result(std::make_shared<T>()) {}
+		Task(const T& value) : result(std::make_shared<T>(value)) {}
+		Task(const JobHandle& handle, const std::shared_ptr<T>& result) : handle(handle), result(result) {}
+
+		inline bool IsFinished() const { return handle.IsFinished(); }
+		inline const JobHandle& GetHandle() const { return handle; }
+
+		inline T& Get()
+		{
+			SD_ASSERT(IsFinished(), "Task not finished");
+			return *result;
+		}
+	};
+
+	template<typename T>
+	std::vector<JobHandle> GetHandles(const std::vector<Task<T>>& tasks)
+	{
+		std::vector<JobHandle> handles;
+		handles.reserve(tasks.size());
+
+		for (const Task<T>& task : tasks)
+			handles.push_back(task.GetHandle());
+
+		return handles;
+	}
+}
\ No newline at end of file
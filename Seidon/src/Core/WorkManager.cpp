@@ -1,52 +1,360 @@
 #include "WorkManager.h"
+#include "../Debug/Debug.h"
+#include "../Debug/Profiler.h"
+
+#include <chrono>
 
 namespace Seidon
 {
+    // Index of the queue owned by the calling thread, -1 for threads outside the pool
+    static thread_local int currentWorkerIndex = -1;
+
+    // See GetCurrentThreadIndex, -1 for threads that never registered
+    static thread_local int currentThreadIndex = -1;
+
     void WorkManager::Init()
     {
-        auto threadFunction = [&]()
+        int workerCount = std::max((int)std::thread::hardware_concurrency() - 1, 1);
+
+        running = true;
+        mainThreadId = std::this_thread::get_id();
+        currentThreadIndex = 0;
+
+        // The main thread and the workers take the first indices, registered threads come after them
+        nextThreadIndex = workerCount + 1;
+
+        SD_PROFILE_THREAD("Main Thread");
+
+        for (int i = 0; i < workerCount; i++)
+            queues.push_back(std::make_unique<WorkStealingQueue<std::shared_ptr<Job>>>());
+
+        for (int i = 0; i < workerCount; i++)
+            threads.push_back(std::thread(&WorkManager::WorkerLoop, this, i));
+    }
+
+    void WorkManager::Destroy()
+    {
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            running = false;
+        }
+        sleepCondition.notify_all();
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        threads.clear();
+        queues.clear();
+    }
+
+    JobHandle WorkManager::Execute(InlineTask task)
+    {
+        return Submit(std::move(task), {}, false);
+    }
+
+    JobHandle WorkManager::Execute(InlineTask task, const std::vector<JobHandle>& dependencies)
+    {
+        return Submit(std::move(task), dependencies, false);
+    }
+
+    JobHandle WorkManager::ExecuteOnMainThread(InlineTask task, MainThreadPriority priority)
+    {
+        return Submit(std::move(task), {}, true, priority);
+    }
+
+    JobHandle WorkManager::ExecuteOnMainThread(InlineTask task, const std::vector<JobHandle>& dependencies,
+        MainThreadPriority priority)
+    {
+        return Submit(std::move(task), dependencies, true, priority);
+    }
+
+    JobHandle WorkManager::Submit(InlineTask&& task, const std::vector<JobHandle>& dependencies, bool mainThread,
+        MainThreadPriority priority)
+    {
+        std::shared_ptr<Job> job = std::allocate_shared<Job>(PoolAllocator<Job>());
+        job->task = std::move(task);
+        job->mainThread = mainThread;
+        job->priority = priority;
+
+        // The job starts with one extra dependency so it can't be scheduled while still registering
+        for (const JobHandle& dependency : dependencies)
         {
-            while (true)
+            if (!dependency.job) continue;
+
+            std::unique_lock<std::mutex> lock(dependency.job->continuationsMutex);
+            if (dependency.job->finished) continue;
+
+            job->unfinishedDependencies++;
+            job->dependencies.push_back(dependency.job);
+            dependency.job->continuations.push_back(job);
+        }
+
+        if (--job->unfinishedDependencies == 0)
+            Schedule(job);
+
+        return JobHandle(job);
+    }
+
+    JobHandle WorkManager::CreateSignal()
+    {
+        // Never scheduled, the pending dependency is only cleared by Signal
+        return JobHandle(std::allocate_shared<Job>(PoolAllocator<Job>()));
+    }
+
+    void WorkManager::Signal(const JobHandle& handle)
+    {
+        SD_ASSERT(handle.job && !handle.job->task, "Only handles created by CreateSignal can be signaled");
+
+        Run(handle.job);
+    }
+
+    void WorkManager::Wait(const JobHandle& handle)
+    {
+        // The main thread also runs the main thread jobs the handle depends on, otherwise waiting on one would never return.
+        // Running any other would re-enter code that may be in the middle of what's waiting
+        bool mainThread = IsMainThread();
+
+        while (!handle.IsFinished())
+        {
+            if (mainThread)
             {
-                std::function<void(void)> task = tasks.Pop();
-                task();
+                std::shared_ptr<Job> dependency = FindMainThreadDependency(handle.job);
+
+                if (dependency && TryClaim(dependency))
+                {
+                    Run(dependency);
+                    continue;
+                }
             }
-        };
 
-        for (int i = 0; i < std::thread::hardware_concurrency() - 1; i++)
-            threads.push_back(std::thread(threadFunction));
+            if (!TryRunOne())
+                std::this_thread::yield();
+        }
     }
 
-    void WorkManager::Destroy()
+    void WorkManager::Wait(const std::vector<JobHandle>& handles)
     {
-        for (std::thread& thread : threads)
+        for (const JobHandle& handle : handles)
+            Wait(handle);
+    }
+
+    void WorkManager::ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& function)
+    {
+        if (count == 0) return;
+
+        chunkSize = std::max(chunkSize, (size_t)1);
+        size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+        if (chunkCount == 1 || queues.empty())
         {
-            thread.detach();
+            function(0, count);
+            return;
         }
+
+        // Chunk boundaries only depend on count and chunkSize, never on the number of workers
+        std::vector<JobHandle> handles;
+        handles.reserve(chunkCount - 1);
+
+        for (size_t i = 1; i < chunkCount; i++)
+        {
+            size_t begin = i * chunkSize;
+            size_t end = std::min(begin + chunkSize, count);
+
+            handles.push_back(Execute([&function, begin, end]() { function(begin, end); }));
+        }
+
+        function(0, chunkSize);
+
+        Wait(handles);
     }
 
-    void WorkManager::Execute(const std::function<void(void)>& task)
+    void WorkManager::RegisterThread()
     {
-        tasks.Push(task);
+        if (currentThreadIndex >= 0) return;
+
+        int index = nextThreadIndex++;
+        SD_ASSERT(index < GetThreadCount(), "Too many threads registered, increase MAX_EXTERNAL_THREADS");
+
+        currentThreadIndex = index;
     }
 
-    void WorkManager::ExecuteOnMainThread(const std::function<void(void)>& task)
+    int WorkManager::GetCurrentThreadIndex()
     {
-        std::unique_lock<std::mutex> lock(mutex);
-        mainThreadTasks.push(task);
+        // Unregistered threads would share the main thread's data
+        SD_ASSERT(currentThreadIndex >= 0, "Thread outside the WorkManager used per-thread data without calling RegisterThread");
+
+        return std::max(currentThreadIndex, 0);
     }
 
     void WorkManager::Update()
     {
-        std::function<void(void)> task;
-        for (int i = 0; i < mainThreadTasks.size(); i++)
+        SD_PROFILE_ZONE("Main Thread Tasks");
+
+        using Clock = std::chrono::steady_clock;
+
+        Clock::time_point start = Clock::now();
+        float elapsed = 0;
+
+        for (int i = 0; i < (int)MainThreadPriority::COUNT; i++)
+        {
+            int executed = 0;
+            std::shared_ptr<Job> job;
+
+            // The first task of each class always runs so lower priorities can't starve
+            while ((executed == 0 || elapsed < mainThreadBudget) && mainThreadJobs[i].TryPop(job))
+            {
+                // Already run by a Wait
+                if (!TryClaim(job)) continue;
+
+                Run(job);
+                executed++;
+
+                elapsed = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+            }
+
+            mainThreadStats.executedTasks[i] = executed;
+        }
+
+        for (int i = 0; i < (int)MainThreadPriority::COUNT; i++)
+            mainThreadStats.queueDepth[i] = mainThreadJobs[i].GetSize();
+
+        mainThreadStats.timeSpent = elapsed;
+    }
+
+    bool WorkManager::TryClaim(const std::shared_ptr<Job>& job)
+    {
+        return !job->claimed.exchange(true, std::memory_order_acq_rel);
+    }
+
+    std::shared_ptr<Job> WorkManager::FindMainThreadDependency(const std::shared_ptr<Job>& job)
+    {
+        // Depth first through the unfinished part of the graph, jobs reached through several paths are only visited once
+        dependencyStack.clear();
+        visitedJobs.clear();
+
+        dependencyStack.push_back(&job);
+
+        while (!dependencyStack.empty())
+        {
+            const std::shared_ptr<Job>& current = *dependencyStack.back();
+            dependencyStack.pop_back();
+
+            if (current->finished.load(std::memory_order_acquire)) continue;
+            if (std::find(visitedJobs.begin(), visitedJobs.end(), current.get()) != visitedJobs.end()) continue;
+
+            visitedJobs.push_back(current.get());
+
+            // Scheduled and not claimed yet
+            if (current->mainThread && current->unfinishedDependencies.load() == 0 && !current->claimed.load())
+                return current;
+
+            for (const std::shared_ptr<Job>& dependency : current->dependencies)
+                dependencyStack.push_back(&dependency);
+        }
+
+        return nullptr;
+    }
+
+    void WorkManager::WorkerLoop(int index)
+    {
+        currentWorkerIndex = index;
+        currentThreadIndex = index + 1;
+
+        SD_PROFILE_THREAD("Worker " + std::to_string(index + 1));
+
+        while (running)
         {
+            if (TryRunOne()) continue;
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+
+            sleepingWorkers++;
+            sleepCondition.wait(lock, [&]() { return pendingJobs > 0 || !running; });
+            sleepingWorkers--;
+        }
+    }
+
+    void WorkManager::Schedule(const std::shared_ptr<Job>& job)
+    {
+        if (job->mainThread)
+        {
+            mainThreadJobs[(int)job->priority].Push(job);
+            return;
+        }
+
+        int index = currentWorkerIndex;
+
+        if (index < 0)
+            index = nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+        queues[index]->Push(job);
+        pendingJobs++;
+
+        if (sleepingWorkers > 0)
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCondition.notify_one();
+        }
+    }
+
+    void WorkManager::Run(const std::shared_ptr<Job>& job)
+    {
+        if (job->task)
+        {
+            SD_PROFILE_ZONE("Job");
+            job->task();
+        }
+
+        // Release the captures now, handles can keep the job alive for a long time
+        job->task.Reset();
+
+        std::vector<std::shared_ptr<Job>> continuations;
+        {
+            std::unique_lock<std::mutex> lock(job->continuationsMutex);
+            job->finished.store(true, std::memory_order_release);
+            continuations.swap(job->continuations);
+        }
+
+        for (std::shared_ptr<Job>& continuation : continuations)
+            if (--continuation->unfinishedDependencies == 0)
+                Schedule(continuation);
+    }
+
+    bool WorkManager::TryRunOne()
+    {
+        std::shared_ptr<Job> job;
+
+        if (!TryGetJob(job))
+            return false;
+
+        Run(job);
+        return true;
+    }
+
+    bool WorkManager::TryGetJob(std::shared_ptr<Job>& job)
+    {
+        if (queues.empty()) return false;
+
+        int index = currentWorkerIndex;
+
+        if (index >= 0 && queues[index]->TryPop(job))
+        {
+            pendingJobs--;
+            return true;
+        }
+
+        int start = index >= 0 ? index + 1 : 0;
+        for (int i = 0; i < queues.size(); i++)
+        {
+            int victim = (start + i) % queues.size();
+
+            if (victim != index && queues[victim]->TrySteal(job))
             {
-                std::unique_lock<std::mutex> lock(mutex);
-                task = mainThreadTasks.front();
-                mainThreadTasks.pop();
+                pendingJobs--;
+                return true;
             }
-            task();
         }
+
+        return false;
     }
 }
\ No newline at end of file
@@ -1,26 +1,184 @@
 #pragma once
 #include <thread>
+#include <algorithm>
 #include <vector>
+#include <queue>
+#include <mutex>
+#include <atomic>
+#include <memory>
 #include <functional>
+#include <condition_variable>
 
-#include "Utils/BlockingQueue.h"
+#include "Utils/WorkStealingQueue.h"
+#include "Utils/MpscQueue.h"
+#include "Utils/InlineTask.h"
+#include "Utils/BlockPool.h"
 
 namespace Seidon
 {
+	// Main thread work runs in this order, each class gets at least one task per frame
+	enum class MainThreadPriority
+	{
+		GPU_UPLOAD = 0,
+		SHADER_COMPILE,
+		CALLBACKS,
+		COUNT
+	};
+
+	struct MainThreadStats
+	{
+		int queueDepth[(int)MainThreadPriority::COUNT] = {};
+		int executedTasks[(int)MainThreadPriority::COUNT] = {};
+
+		// Milliseconds spent running main thread tasks during the last Update
+		float timeSpent = 0;
+	};
+
+	// Allocated through PoolAllocator, jobs are created and released at a high rate from every thread
+	struct Job
+	{
+		InlineTask task;
+
+		std::atomic<int> unfinishedDependencies{ 1 };
+		std::atomic<bool> finished{ false };
+
+		// Main thread jobs are run by Update, or by a Wait on the main thread for a job that depends on them
+		bool mainThread = false;
+		MainThreadPriority priority = MainThreadPriority::CALLBACKS;
+
+		// Set by whichever of Update and Wait runs a main thread job first, the other one skips it
+		std::atomic<bool> claimed{ false };
+
+		// Dependencies still unfinished at submission, for Wait to find the main thread jobs it has to run
+		std::vector<std::shared_ptr<Job>> dependencies;
+
+		std::mutex continuationsMutex;
+		std::vector<std::shared_ptr<Job>> continuations;
+	};
+
+	class JobHandle
+	{
+	private:
+		std::shared_ptr<Job> job;
+
+	public:
+		JobHandle() = default;
+		JobHandle(const std::shared_ptr<Job>& job) : job(job) {}
+
+		inline bool IsValid() const { return job != nullptr; }
+		inline bool IsFinished() const { return !job || job->finished.load(std::memory_order_acquire); }
+
+		friend class WorkManager;
+	};
+
 	class WorkManager
 	{
-	private: 
+	private:
 		std::vector<std::thread> threads;
-		BlockingQueue<std::function<void(void)>> tasks;
-		std::queue<std::function<void(void)>> mainThreadTasks;
-		
-		std::mutex mutex;
+		std::vector<std::unique_ptr<WorkStealingQueue<std::shared_ptr<Job>>>> queues;
+
+		std::atomic<bool> running{ false };
+		std::atomic<int> pendingJobs{ 0 };
+		std::atomic<int> sleepingWorkers{ 0 };
+		std::atomic<unsigned int> nextQueue{ 0 };
+
+		std::mutex sleepMutex;
+		std::condition_variable sleepCondition;
+
+		MpscQueue<std::shared_ptr<Job>> mainThreadJobs[(int)MainThreadPriority::COUNT];
+
+		// Scratch of FindMainThreadDependency, only used by the main thread. Dependencies are never changed after
+		// submission, so pointing into them is safe while the waited job is alive
+		std::vector<const std::shared_ptr<Job>*> dependencyStack;
+		std::vector<Job*> visitedJobs;
+
+		float mainThreadBudget = 2.0f;
+		MainThreadStats mainThreadStats;
+
+		std::thread::id mainThreadId;
+		std::atomic<int> nextThreadIndex{ 0 };
 
 	public:
+		// Threads outside the pool (e.g. the I/O threads) that can get a slot through RegisterThread
+		static constexpr int MAX_EXTERNAL_THREADS = 8;
+
 		void Init();
 		void Destroy();
-		void Execute(const std::function<void(void)>& task);
-		void ExecuteOnMainThread(const std::function<void(void)>& task);
+
+		JobHandle Execute(InlineTask task);
+		JobHandle Execute(InlineTask task, const std::vector<JobHandle>& dependencies);
+		JobHandle ExecuteOnMainThread(InlineTask task, MainThreadPriority priority = MainThreadPriority::CALLBACKS);
+		JobHandle ExecuteOnMainThread(InlineTask task, const std::vector<JobHandle>& dependencies,
+			MainThreadPriority priority = MainThreadPriority::CALLBACKS);
+
+		// Handle finished by calling Signal from any thread, for work that doesn't run on the job system (e.g. I/O)
+		JobHandle CreateSignal();
+		void Signal(const JobHandle& handle);
+
+		// On the main thread, only the main thread jobs the handle depends on run, the others are left to Update
+		void Wait(const JobHandle& handle);
+		void Wait(const std::vector<JobHandle>& handles);
+
+		void ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& function);
+
+		inline int GetWorkerCount() { return threads.size(); }
+		inline bool IsMainThread() { return std::this_thread::get_id() == mainThreadId; }
+
+		// Milliseconds per frame that Update may spend on main thread tasks, the rest rolls over to the next frame
+		inline void SetMainThreadBudget(float milliseconds) { mainThreadBudget = milliseconds; }
+		inline float GetMainThreadBudget() { return mainThreadBudget; }
+		inline const MainThreadStats& GetMainThreadStats() { return mainThreadStats; }
+
+		// Gives the calling thread its own index, for long lived threads outside the pool that use per-thread data
+		void RegisterThread();
+
+		// Number of distinct thread indices, the size of any per-thread array
+		inline int GetThreadCount() { return GetWorkerCount() + 1 + MAX_EXTERNAL_THREADS; }
+
+		// 0 for the main thread, 1..GetWorkerCount() for workers, then registered threads
+		static int GetCurrentThreadIndex();
+
 		void Update();
+
+	private:
+		JobHandle Submit(InlineTask&& task, const std::vector<JobHandle>& dependencies, bool mainThread,
+			MainThreadPriority priority = MainThreadPriority::CALLBACKS);
+
+		void WorkerLoop(int index);
+		void Schedule(const std::shared_ptr<Job>& job);
+		void Run(const std::shared_ptr<Job>& job);
+		bool TryRunOne();
+		bool TryGetJob(std::shared_ptr<Job>& job);
+		bool TryClaim(const std::shared_ptr<Job>& job);
+		std::shared_ptr<Job> FindMainThreadDependency(const std::shared_ptr<Job>& job);
+	};
+
+	/*
+	* One instance of T per thread that can run jobs, so that parallel loops can accumulate
+	* results without locking. Slots are padded to a cache line to avoid false sharing.
+	*/
+	template<typename T>
+	class ThreadScratch
+	{
+	private:
+		struct alignas(64) Slot
+		{
+			T value;
+		};
+
+		std::vector<Slot> slots;
+
+	public:
+		ThreadScratch(WorkManager& workManager)
+			: slots(workManager.GetThreadCount()) {}
+
+		inline T& Local() { return slots[WorkManager::GetCurrentThreadIndex()].value; }
+
+		template<typename Func>
+		void ForEach(const Func& function)
+		{
+			for (Slot& slot : slots)
+				function(slot.value);
+		}
 	};
 }
\ No newline at end of file
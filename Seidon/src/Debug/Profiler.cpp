@@ -0,0 +1,254 @@
+#include "Profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace Seidon
+{
+    struct ThreadBuffer
+    {
+        int id;
+        std::string name;
+
+        // Only the owning thread writes, writeIndex counts every event ever written
+        std::vector<ProfileEvent> events = std::vector<ProfileEvent>(Profiler::BUFFER_CAPACITY);
+        std::atomic<unsigned long long> writeIndex{ 0 };
+
+        const char* openNames[Profiler::MAX_DEPTH];
+        long long openStarts[Profiler::MAX_DEPTH];
+        int depth = 0;
+    };
+
+    static std::mutex& GetBuffersMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::vector<std::unique_ptr<ThreadBuffer>>& GetBuffers()
+    {
+        static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        return buffers;
+    }
+
+    static std::atomic<long long> frameTimes[Profiler::FRAME_HISTORY];
+    static std::atomic<unsigned long long> frameCount{ 0 };
+
+    static thread_local ThreadBuffer* threadBuffer = nullptr;
+
+    static ThreadBuffer* GetThreadBuffer()
+    {
+        if (threadBuffer) return threadBuffer;
+
+        std::unique_lock<std::mutex> lock(GetBuffersMutex());
+        std::vector<std::unique_ptr<ThreadBuffer>>& buffers = GetBuffers();
+
+        // Buffers outlive their threads so that their events can still be exported
+        buffers.push_back(std::make_unique<ThreadBuffer>());
+        threadBuffer = buffers.back().get();
+        threadBuffer->id = buffers.size() - 1;
+        threadBuffer->name = "Thread " + std::to_string(threadBuffer->id);
+
+        return threadBuffer;
+    }
+
+    // Copies the events still in the ring. The owner keeps writing while we copy, so events
+    // that may have been overwritten in the meantime are dropped
+    static void ReadEvents(ThreadBuffer& buffer, std::vector<ProfileEvent>& events)
+    {
+        const unsigned long long capacity = Profiler::BUFFER_CAPACITY;
+
+        unsigned long long end = buffer.writeIndex.load(std::memory_order_acquire);
+        unsigned long long begin = end > capacity ? end - capacity : 0;
+
+        std::vector<ProfileEvent> copy;
+        copy.reserve(end - begin);
+        for (unsigned long long i = begin; i < end; i++)
+            copy.push_back(buffer.events[i % capacity]);
+
+        unsigned long long after = buffer.writeIndex.load(std::memory_order_acquire);
+        unsigned long long firstValid = after + 1 > capacity ? after + 1 - capacity : 0;
+
+        for (unsigned long long i = std::max(begin, firstValid); i < end; i++)
+            events.push_back(copy[i - begin]);
+    }
+
+    static void WriteEscaped(std::ofstream& out, const char* string)
+    {
+        for (const char* c = string; *c; c++)
+        {
+            if (*c == '"' || *c == '\\') out << '\\';
+            out << *c;
+        }
+    }
+
+    void Profiler::BeginZone(const char* name)
+    {
+        ThreadBuffer& buffer = *GetThreadBuffer();
+
+        // Zones nested deeper than MAX_DEPTH are not recorded, but still counted to keep Begin and End paired
+        if (buffer.depth < MAX_DEPTH)
+        {
+            buffer.openNames[buffer.depth] = name;
+            buffer.openStarts[buffer.depth] = GetTime();
+        }
+
+        buffer.depth++;
+    }
+
+    void Profiler::EndZone()
+    {
+        ThreadBuffer& buffer = *GetThreadBuffer();
+
+        if (buffer.depth == 0) return;
+        buffer.depth--;
+
+        if (buffer.depth >= MAX_DEPTH) return;
+
+        unsigned long long index = buffer.writeIndex.load(std::memory_order_relaxed);
+
+        ProfileEvent& event = buffer.events[index % BUFFER_CAPACITY];
+        event.name = buffer.openNames[buffer.depth];
+        event.start = buffer.openStarts[buffer.depth];
+        event.end = GetTime();
+        event.depth = buffer.depth;
+
+        buffer.writeIndex.store(index + 1, std::memory_order_release);
+    }
+
+    void Profiler::MarkFrame()
+    {
+        unsigned long long index = frameCount.load(std::memory_order_relaxed);
+
+        frameTimes[index % FRAME_HISTORY].store(GetTime(), std::memory_order_relaxed);
+        frameCount.store(index + 1, std::memory_order_release);
+    }
+
+    void Profiler::SetThreadName(const std::string& name)
+    {
+        ThreadBuffer* buffer = GetThreadBuffer();
+
+        std::unique_lock<std::mutex> lock(GetBuffersMutex());
+        buffer->name = name;
+    }
+
+    const char* Profiler::InternName(const std::string& name)
+    {
+        static std::mutex mutex;
+        static std::unordered_set<std::string> names;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        return names.insert(name).first->c_str();
+    }
+
+    long long Profiler::GetTime()
+    {
+        using Clock = std::chrono::steady_clock;
+        static const Clock::time_point epoch = Clock::now();
+
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count();
+    }
+
+    bool Profiler::CaptureLastFrame(std::vector<ProfileThreadCapture>& threads, long long& frameStart, long long& frameEnd)
+    {
+        threads.clear();
+
+        unsigned long long count = frameCount.load(std::memory_order_acquire);
+        if (count < 2) return false;
+
+        frameStart = frameTimes[(count - 2) % FRAME_HISTORY].load(std::memory_order_relaxed);
+        frameEnd = frameTimes[(count - 1) % FRAME_HISTORY].load(std::memory_order_relaxed);
+
+        std::unique_lock<std::mutex> lock(GetBuffersMutex());
+
+        for (std::unique_ptr<ThreadBuffer>& buffer : GetBuffers())
+        {
+            std::vector<ProfileEvent> events;
+            ReadEvents(*buffer, events);
+
+            ProfileThreadCapture capture;
+            capture.threadId = buffer->id;
+            capture.threadName = buffer->name;
+
+            for (ProfileEvent& event : events)
+                if (event.end > frameStart && event.start < frameEnd)
+                    capture.events.push_back(event);
+
+            if (capture.events.empty()) continue;
+
+            std::sort(capture.events.begin(), capture.events.end(),
+                [](const ProfileEvent& a, const ProfileEvent& b) { return a.start < b.start; });
+
+            threads.push_back(std::move(capture));
+        }
+
+        return true;
+    }
+
+    bool Profiler::ExportChromeTrace(const std::string& path)
+    {
+        std::ofstream out(path, std::ios::out);
+
+        if (!out)
+        {
+            std::cerr << "Error opening trace file: " << path << std::endl;
+            return false;
+        }
+
+        out << std::fixed << std::setprecision(3);
+        out << "{\"traceEvents\":[\n";
+
+        bool first = true;
+        auto separator = [&]()
+        {
+            if (!first) out << ",\n";
+            first = false;
+        };
+
+        {
+            std::unique_lock<std::mutex> lock(GetBuffersMutex());
+
+            for (std::unique_ptr<ThreadBuffer>& buffer : GetBuffers())
+            {
+                separator();
+                out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->id << ",\"args\":{\"name\":\"";
+                WriteEscaped(out, buffer->name.c_str());
+                out << "\"}}";
+
+                std::vector<ProfileEvent> events;
+                ReadEvents(*buffer, events);
+
+                // Chrome traces use microseconds
+                for (ProfileEvent& event : events)
+                {
+                    separator();
+                    out << "{\"name\":\"";
+                    WriteEscaped(out, event.name);
+                    out << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->id
+                        << ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+                }
+            }
+        }
+
+        unsigned long long count = frameCount.load(std::memory_order_acquire);
+        unsigned long long firstFrame = count > FRAME_HISTORY ? count - FRAME_HISTORY : 0;
+
+        for (unsigned long long i = firstFrame; i < count; i++)
+        {
+            separator();
+            out << "{\"name\":\"Frame " << i << "\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":"
+                << frameTimes[i % FRAME_HISTORY].load(std::memory_order_relaxed) / 1000.0 << "}";
+        }
+
+        out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+        return true;
+    }
+}
\ No newline at end of file
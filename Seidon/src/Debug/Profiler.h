@@ -0,0 +1,89 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Zones are only recorded in Debug and Checked builds, define SD_PROFILE to also record them in Release
+#if !defined(SD_PROFILE) && (defined(_DEBUG) || defined(SD_DEBUG))
+#define SD_PROFILE
+#endif
+
+namespace Seidon
+{
+	struct ProfileEvent
+	{
+		// Must outlive the capture: use string literals or Profiler::InternName
+		const char* name;
+
+		// Nanoseconds since the profiler started
+		long long start;
+		long long end;
+
+		int depth;
+	};
+
+	struct ProfileThreadCapture
+	{
+		int threadId;
+		std::string threadName;
+		std::vector<ProfileEvent> events;
+	};
+
+	/*
+	* Every thread records its zones into its own ring buffer, so recording never takes a lock.
+	* Old events are overwritten once a buffer is full, captures only see the most recent ones.
+	*/
+	class Profiler
+	{
+	public:
+		static constexpr int BUFFER_CAPACITY = 1 << 16;
+		static constexpr int MAX_DEPTH = 64;
+		static constexpr int FRAME_HISTORY = 256;
+
+		static void BeginZone(const char* name);
+		static void EndZone();
+
+		// Called once per frame by the main thread, at the start of the frame
+		static void MarkFrame();
+
+		static void SetThreadName(const std::string& name);
+		static const char* InternName(const std::string& name);
+
+		static long long GetTime();
+
+		// Events of every thread that overlap the last finished frame, returns false if there is none yet
+		static bool CaptureLastFrame(std::vector<ProfileThreadCapture>& threads, long long& frameStart, long long& frameEnd);
+
+		// Writes everything still in the buffers as Chrome trace JSON (chrome://tracing, ui.perfetto.dev)
+		static bool ExportChromeTrace(const std::string& path);
+	};
+
+	class ScopedProfileZone
+	{
+	public:
+		ScopedProfileZone(const char* name) { Profiler::BeginZone(name); }
+		~ScopedProfileZone() { Profiler::EndZone(); }
+	};
+}
+
+#ifdef SD_PROFILE
+
+#define SD_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SD_PROFILE_CONCAT(a, b) SD_PROFILE_CONCAT_IMPL(a, b)
+
+#define SD_PROFILE_ZONE(name) Seidon::ScopedProfileZone SD_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define SD_PROFILE_FUNCTION() SD_PROFILE_ZONE(__FUNCTION__)
+#define SD_PROFILE_BEGIN(name) Seidon::Profiler::BeginZone(name)
+#define SD_PROFILE_END() Seidon::Profiler::EndZone()
+#define SD_PROFILE_FRAME() Seidon::Profiler::MarkFrame()
+#define SD_PROFILE_THREAD(name) Seidon::Profiler::SetThreadName(name)
+
+#else
+
+#define SD_PROFILE_ZONE(name)
+#define SD_PROFILE_FUNCTION()
+#define SD_PROFILE_BEGIN(name)
+#define SD_PROFILE_END()
+#define SD_PROFILE_FRAME()
+#define SD_PROFILE_THREAD(name)
+
+#endif
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+namespace Seidon
+{
+	struct TimingStats
+	{
+		float min = 0;
+		float average = 0;
+		float p95 = 0;
+		float max = 0;
+	};
+
+	// Ring buffer keeping the most recent samples (in milliseconds), older ones are overwritten
+	class TimingHistory
+	{
+	public:
+		static constexpr int DEFAULT_CAPACITY = 300;
+
+	private:
+		std::vector<float> samples;
+		int next = 0;
+		int count = 0;
+
+	public:
+		TimingHistory(int capacity = DEFAULT_CAPACITY) : samples(capacity) {}
+
+		inline void Push(float sample)
+		{
+			samples[next] = sample;
+			next = (next + 1) % samples.size();
+			count = std::min(count + 1, (int)samples.size());
+		}
+
+		inline void Clear()
+		{
+			next = 0;
+			count = 0;
+		}
+
+		inline int GetCount() const { return count; }
+		inline int GetCapacity() const { return samples.size(); }
+
+		// Index 0 is the oldest sample still in the history
+		inline float GetSample(int index) const
+		{
+			return samples[(next - count + index + samples.size()) % samples.size()];
+		}
+
+		inline float GetLast() const { return count > 0 ? GetSample(count - 1) : 0; }
+
+		TimingStats ComputeStats() const
+		{
+			TimingStats stats;
+			if (count == 0) return stats;
+
+			std::vector<float> sorted(count);
+			for (int i = 0; i < count; i++)
+				sorted[i] = GetSample(i);
+
+			std::sort(sorted.begin(), sorted.end());
+
+			float sum = 0;
+			for (float sample : sorted)
+				sum += sample;
+
+			// Nearest rank percentile
+			int p95Index = std::max((int)std::ceil(0.95f * count) - 1, 0);
+
+			stats.min = sorted.front();
+			stats.max = sorted.back();
+			stats.average = sum / count;
+			stats.p95 = sorted[p95Index];
+
+			return stats;
+		}
+	};
+}
\ No newline at end of file
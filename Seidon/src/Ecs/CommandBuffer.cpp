@@ -0,0 +1,49 @@
+#include "CommandBuffer.h"
+
+namespace Seidon
+{
+	thread_local uint64_t CommandBuffer::currentSortKey = 0;
+
+	DeferredEntity CommandBuffer::CreateEntity(const std::string& name)
+	{
+		DeferredEntity entity;
+		entity.createdIndex = createdEntities.size();
+
+		createdEntities.push_back(NullEntityId);
+
+		int index = entity.createdIndex;
+		Record([this, index, name]()
+			{
+				createdEntities[index] = scene->CreateEntity(name).ID;
+			}
+		);
+
+		return entity;
+	}
+
+	void CommandBuffer::DestroyEntity(DeferredEntity entity)
+	{
+		Record([this, entity]()
+			{
+				Entity e(Resolve(entity), scene);
+				if (IsAlive(e.ID)) scene->DestroyEntity(e);
+			}
+		);
+	}
+
+	void CommandBuffer::Record(InlineTask&& execute)
+	{
+		commands.push_back({ currentSortKey, (uint32_t)commands.size(), std::move(execute) });
+	}
+
+	EntityId CommandBuffer::Resolve(const DeferredEntity& entity)
+	{
+		return entity.createdIndex >= 0 ? createdEntities[entity.createdIndex] : entity.id;
+	}
+
+	bool CommandBuffer::IsAlive(EntityId id)
+	{
+		// Commands recorded before a destruction may still target the entity
+		return id != NullEntityId && scene->IsEntityIdValid(id);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+#include "Entity.h"
+
+#include "../Utils/InlineTask.h"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace Seidon
+{
+	// Entity targeted by a recorded command: an existing one, or one created by the same buffer
+	class DeferredEntity
+	{
+	private:
+		EntityId id = NullEntityId;
+		int createdIndex = -1;
+
+	public:
+		DeferredEntity() = default;
+		DeferredEntity(EntityId id) : id(id) {}
+		DeferredEntity(Entity entity) : id(entity.ID) {}
+
+		friend class CommandBuffer;
+	};
+
+	/*
+	* Records structural changes (entity creation and destruction, component addition and removal) so that
+	* jobs can request them without touching the registry. Each thread gets its own buffer from
+	* Scene::GetCommandBuffer, and Scene::PlaybackCommands applies all of them on the main thread.
+	* Commands are played back by system, then by the item of the parallel loop that recorded them,
+	* so the result doesn't depend on which worker ran which chunk.
+	*/
+	class CommandBuffer
+	{
+	private:
+		struct Command
+		{
+			uint64_t sortKey;
+			uint32_t sequence;
+			InlineTask execute;
+		};
+
+		Scene* scene;
+		std::vector<Command> commands;
+		std::vector<EntityId> createdEntities;
+
+		static thread_local uint64_t currentSortKey;
+
+	public:
+		CommandBuffer(Scene* scene) : scene(scene) {}
+
+		// The entity only exists after playback, until then it can only be the target of commands of this buffer
+		DeferredEntity CreateEntity(const std::string& name = std::string());
+		void DestroyEntity(DeferredEntity entity);
+
+		template <typename T, typename... Args>
+		void AddComponent(DeferredEntity entity, Args&&... args)
+		{
+			Record([this, entity, component = T(std::forward<Args>(args)...)]() mutable
+				{
+					EntityId id = Resolve(entity);
+					if (IsAlive(id)) Entity(id, scene).AddComponent<T>(std::move(component));
+				}
+			);
+		}
+
+		template <typename T>
+		void RemoveComponent(DeferredEntity entity)
+		{
+			Record([this, entity]()
+				{
+					EntityId id = Resolve(entity);
+					if (IsAlive(id) && Entity(id, scene).HasComponent<T>()) Entity(id, scene).RemoveComponent<T>();
+				}
+			);
+		}
+
+		inline bool IsEmpty() { return commands.empty(); }
+
+	private:
+		void Record(InlineTask&& execute);
+
+		EntityId Resolve(const DeferredEntity& entity);
+		bool IsAlive(EntityId id);
+
+		friend class Scene;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "ComponentChangeLog.h"
+
+namespace Seidon
+{
+	void ComponentChangeLog::Mark(EntityId entity, const std::atomic<uint32_t>& version)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		MarkUnlocked(entity, version.load());
+	}
+
+	void ComponentChangeLog::Mark(const EntityId* entities, size_t count, const std::atomic<uint32_t>& version)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		uint32_t currentVersion = version.load();
+		for (size_t i = 0; i < count; i++)
+			MarkUnlocked(entities[i], currentVersion);
+	}
+
+	void ComponentChangeLog::MarkWritten(uint32_t version, const void* writer)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		for (Write& write : writes)
+		{
+			if (write.writer != writer) continue;
+
+			write.version = std::max(write.version, version);
+			return;
+		}
+
+		writes.push_back({ writer, version });
+	}
+
+	bool ComponentChangeLog::WasWrittenAfter(uint32_t version, const void* reader)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		// Unknown writers are foreign to every reader
+		for (const Write& write : writes)
+			if (write.version > version && (!write.writer || write.writer != reader))
+				return true;
+
+		return false;
+	}
+
+	bool ComponentChangeLog::HasChangesAfter(uint32_t version)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		if (!IsComplete(version)) return true;
+
+		for (const Write& write : writes)
+			if (write.version > version) return true;
+
+		return !changes.empty() && changes.back().version > version;
+	}
+
+	uint32_t ComponentChangeLog::GetVersion(EntityId entity)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		size_t index = entt::to_entity(entity);
+		if (index >= latestChanges.size() || latestChanges[index].entity != entity)
+			return 0;
+
+		return latestChanges[index].version;
+	}
+
+	void ComponentChangeLog::Discard(uint32_t version)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		if (version <= discardedVersion) return;
+
+		// The log is sorted, so this only goes through the discarded changes
+		for (const Change& change : changes)
+		{
+			if (change.version > version) break;
+
+			if (IsLatest(change))
+				latestChanges[entt::to_entity(change.entity)] = { NullEntityId, 0 };
+		}
+
+		changes.erase(std::remove_if(changes.begin(), changes.end(),
+			[&](const Change& change) { return !IsLatest(change); }), changes.end());
+
+		discardedVersion = version;
+	}
+
+	void ComponentChangeLog::MarkUnlocked(EntityId entity, uint32_t version)
+	{
+		size_t index = entt::to_entity(entity);
+		if (index >= latestChanges.size())
+			latestChanges.resize(index + 1, { NullEntityId, 0 });
+
+		Change& latest = latestChanges[index];
+
+		// Already marked in this version, the log entry is still the latest one
+		if (latest.entity == entity && latest.version == version) return;
+
+		latest = { entity, version };
+		changes.push_back(latest);
+	}
+}
\ No newline at end of file
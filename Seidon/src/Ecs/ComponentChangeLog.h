@@ -0,0 +1,89 @@
+#pragma once
+#include "EnttWrappers.h"
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+
+namespace Seidon
+{
+	/*
+	* Change history of one component type. Every change stamps the entity with the current change
+	* version of the scene and is appended to a log sorted by version, so the entities changed after a
+	* given version are found without going through the whole scene. Marking is thread safe, reading
+	* must not overlap with changes to the same component type.
+	*/
+	class ComponentChangeLog
+	{
+	private:
+		struct Change
+		{
+			EntityId entity;
+			uint32_t version;
+		};
+
+		// Latest change of each entity, by entity index
+		std::vector<Change> latestChanges;
+		std::vector<Change> changes;
+
+		// Changes up to this version have been discarded
+		uint32_t discardedVersion = 0;
+
+		// Last version at which each writer may have written the whole storage in place, null if the writer is unknown
+		struct Write
+		{
+			const void* writer;
+			uint32_t version;
+		};
+
+		std::vector<Write> writes;
+
+		std::mutex mutex;
+
+	public:
+		// The version is read under the lock, so that the log stays sorted when versions are captured concurrently
+		void Mark(EntityId entity, const std::atomic<uint32_t>& version);
+		void Mark(const EntityId* entities, size_t count, const std::atomic<uint32_t>& version);
+
+		// For writers that change components in place without marking them one by one
+		void MarkWritten(uint32_t version, const void* writer = nullptr);
+
+		// True if the storage may have been written in place after version by anyone but reader
+		bool WasWrittenAfter(uint32_t version, const void* reader = nullptr);
+
+		// True if any component of the type may have changed after version
+		bool HasChangesAfter(uint32_t version);
+
+		// 0 if the entity didn't change since its changes were last discarded
+		uint32_t GetVersion(EntityId entity);
+
+		// False if some changes after sinceVersion were discarded, callers then have to assume everything changed
+		inline bool IsComplete(uint32_t sinceVersion) { return sinceVersion >= discardedVersion; }
+
+		// Visits each entity changed after sinceVersion once, the entity may have been destroyed since
+		template <typename Func>
+		void ForEachChanged(uint32_t sinceVersion, const Func& function)
+		{
+			auto first = std::upper_bound(changes.begin(), changes.end(), sinceVersion,
+				[](uint32_t version, const Change& change) { return version < change.version; });
+
+			for (auto it = first; it != changes.end(); it++)
+				if (IsLatest(*it))
+					function(it->entity);
+		}
+
+		// Drops the changes up to version, and the ones superseded by a later change of the same entity
+		void Discard(uint32_t version);
+
+	private:
+		inline bool IsLatest(const Change& change)
+		{
+			const Change& latest = latestChanges[entt::to_entity(change.entity)];
+			return latest.entity == change.entity && latest.version == change.version;
+		}
+
+		void MarkUnlocked(EntityId entity, uint32_t version);
+	};
+}
\ No newline at end of file
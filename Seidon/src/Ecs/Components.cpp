@@ -42,10 +42,10 @@ namespace Seidon
 		RenderComponent& rc = *(RenderComponent*)component;
 		int oldSize = rc.materials.size();
 
-		if (oldSize < rc.mesh->subMeshes.size())
+		if (oldSize < rc.mesh->GetSubmeshCount())
 		{
-			rc.materials.resize(rc.mesh->subMeshes.size());
-			for (int i = oldSize; i < rc.mesh->subMeshes.size(); i++)
+			rc.materials.resize(rc.mesh->GetSubmeshCount());
+			for (int i = oldSize; i < rc.mesh->GetSubmeshCount(); i++)
 				rc.materials[i] = Application::Get()->GetResourceManager()->GetAsset<Material>("default_material");
 		}
 	}
@@ -55,10 +55,10 @@ namespace Seidon
 		SkinnedRenderComponent& rc = *(SkinnedRenderComponent*)component;
 		int oldSize = rc.materials.size();
 
-		if (oldSize < rc.mesh->subMeshes.size())
+		if (oldSize < rc.mesh->GetSubmeshCount())
 		{
-			rc.materials.resize(rc.mesh->subMeshes.size());
-			for (int i = oldSize; i < rc.mesh->subMeshes.size(); i++)
+			rc.materials.resize(rc.mesh->GetSubmeshCount());
+			for (int i = oldSize; i < rc.mesh->GetSubmeshCount(); i++)
 				rc.materials[i] = Application::Get()->GetResourceManager()->GetAsset<Material>("default_skinned_material");
 		}
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "Core/UUID.h"
+#include "EnttWrappers.h"
 #include "Graphics/Mesh.h"
 #include "Graphics/Armature.h"
 #include "Graphics/Material.h"
@@ -63,13 +64,19 @@ namespace Seidon
 	struct TransformComponent
 	{
 		glm::vec3 position = { 0.0f, 0.0f, 0.0f };
-		glm::vec3 rotation = { 0.0f, 0.0f, 0.0f };
+		glm::quat rotation = { 1.0f, 0.0f, 0.0f, 0.0f };
 		glm::vec3 scale = { 1.0f, 1.0f, 1.0f };
 
 		UUID parent = 0;
 		std::vector<UUID> children;
 
-		glm::mat4 chachedWorldSpaceMatrix;
+		// World matrix computed by Scene::UpdateTransforms, together with the local values it was computed
+		// from. Writes to position, rotation, scale or parent are detected by comparing against them
+		glm::mat4 chachedWorldSpaceMatrix = glm::mat4(1.0f);
+		glm::vec3 cachedPosition;
+		glm::quat cachedRotation;
+		glm::vec3 cachedScale;
+		UUID cachedParent = 0;
 		bool cacheValid = false;
 
 		TransformComponent() = default;
@@ -83,50 +90,99 @@ namespace Seidon
 			SetFromMatrix(transform);
 		}
 
+		// Assumes a matrix without shear or projection, like the ones built by GetTransformMatrix
 		void SetFromMatrix(const glm::mat4& transform)
 		{
-			glm::vec3 scale;
-			glm::quat rotation;
-			glm::vec3 translation;
-			glm::vec3 skew;
-			glm::vec4 perspective;
-			glm::decompose(transform, scale, rotation, translation, skew, perspective);
-
-			this->position = translation;
-			this->rotation = glm::eulerAngles(rotation);
-			this->scale = scale;
+			glm::mat3 axes(transform);
+
+			position = transform[3];
+			scale = glm::vec3(glm::length(axes[0]), glm::length(axes[1]), glm::length(axes[2]));
+
+			if (glm::determinant(axes) < 0)
+				scale = -scale;
+
+			if (scale.x == 0 || scale.y == 0 || scale.z == 0)
+			{
+				rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+				return;
+			}
+
+			axes[0] /= scale.x;
+			axes[1] /= scale.y;
+			axes[2] /= scale.z;
+
+			rotation = glm::normalize(glm::quat_cast(axes));
 		}
 
 		glm::mat4 GetTransformMatrix() const
 		{
-			glm::mat4 rot = glm::toMat4(glm::quat(rotation));
+			glm::mat3 axes = glm::mat3_cast(rotation);
+
+			return glm::mat4(
+				glm::vec4(axes[0] * scale.x, 0.0f),
+				glm::vec4(axes[1] * scale.y, 0.0f),
+				glm::vec4(axes[2] * scale.z, 0.0f),
+				glm::vec4(position, 1.0f)
+			);
+		}
 
-			return glm::translate(glm::mat4(1.0f), position)
-				* rot
-				* glm::scale(glm::mat4(1.0f), scale);
+		inline bool HasLocalChanged() const
+		{
+			return !cacheValid || position != cachedPosition || rotation != cachedRotation
+				|| scale != cachedScale || parent != cachedParent;
 		}
 
-		glm::quat GetOrientation() const
+		// Euler angles in radians, only meant for editing: the quaternion is the actual rotation
+		inline glm::vec3 GetEulerAngles() const { return glm::eulerAngles(rotation); }
+		inline void SetEulerAngles(const glm::vec3& angles) { rotation = glm::quat(angles); }
+
+		inline glm::quat GetOrientation() const
 		{
-			return glm::quat(glm::vec3(rotation.x, rotation.y, rotation.z));
+			return rotation;
 		}
 
 		glm::vec3 GetUpDirection() const
 		{
-			return glm::rotate(GetOrientation(), glm::vec3(0.0f, 1.0f, 0.0f));
+			return glm::rotate(rotation, glm::vec3(0.0f, 1.0f, 0.0f));
 		}
 
 		glm::vec3 GetRightDirection() const
 		{
-			return glm::rotate(GetOrientation(), glm::vec3(1.0f, 0.0f, 0.0f));
+			return glm::rotate(rotation, glm::vec3(1.0f, 0.0f, 0.0f));
 		}
 
 		glm::vec3 GetForwardDirection() const
 		{
-			return glm::rotate(GetOrientation(), glm::vec3(0.0f, 0.0f, 1.0f));
+			return glm::rotate(rotation, glm::vec3(0.0f, 0.0f, 1.0f));
 		}
 	};
 
+	/*
+	* Runtime links of the transform hierarchy, so that traversals don't go through UUID lookups. The UUIDs in
+	* TransformComponent stay the serialized form: the scene rebuilds the links from them on load and keeps
+	* both in sync when the hierarchy is edited through Entity (SetParent, RemoveParent, AddChild, RemoveChild)
+	*/
+	struct HierarchyComponent
+	{
+		EntityId parent = NullEntityId;
+		EntityId firstChild = NullEntityId;
+		EntityId lastChild = NullEntityId;
+		EntityId previousSibling = NullEntityId;
+		EntityId nextSibling = NullEntityId;
+		int childCount = 0;
+
+		HierarchyComponent() = default;
+		HierarchyComponent(const HierarchyComponent&) = default;
+	};
+
+	/*
+	* Tag of the entities deactivated through Scene::SetEntityActive. They keep their components, and the
+	* runtime resources behind them (e.g. physics actors), but rendering, animation and physics skip them
+	*/
+	struct InactiveComponent
+	{
+	};
+
 	struct RenderComponent
 	{
 		Mesh* mesh;
@@ -1,8 +1,10 @@
 #pragma once
 
+#include "CommandBuffer.h"
 #include "Components.h"
 #include "Entity.h"
 #include "Prefab.h"
+#include "PrefabPool.h"
 #include "Scene.h"
 #include "SceneManager.h"
 #include "System.h"
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "../Core/Application.h"
 #include "../Reflection/Reflection.h"
+#include "../Utils/SimdMath.h"
 
 namespace Seidon
 {
@@ -18,6 +19,16 @@ namespace Seidon
 		GetComponent<NameComponent>().name = name;
 	}
 
+	void Entity::SetActive(bool active)
+	{
+		scene->SetEntityActive(ID, active);
+	}
+
+	bool Entity::IsActive()
+	{
+		return scene->IsEntityActive(ID);
+	}
+
 	UUID Entity::GetId()
 	{
 		return GetComponent<IDComponent>().ID;
@@ -32,27 +43,35 @@ namespace Seidon
 	{
 		TransformComponent& localTransform = GetComponent<TransformComponent>();
 
-		if (localTransform.cacheValid) return localTransform.chachedWorldSpaceMatrix;
+		// The cached matrix is only up to date if neither the entity nor any of its ancestors moved since the last pass
+		bool changed = localTransform.HasLocalChanged();
+
+		for (Entity ancestor = *this; !changed && ancestor.HasParent();)
+		{
+			ancestor = ancestor.GetParent();
+			changed = ancestor.GetComponent<TransformComponent>().HasLocalChanged();
+		}
 
+		if (!changed) return localTransform.chachedWorldSpaceMatrix;
+
+		// Moved since the last Scene::UpdateTransforms, the cache is left for the next pass to refresh
+		// so that it can still tell which children need to be updated
 		glm::mat4 worldSpaceMatrix(1.0f);
 
 		if (HasParent())
 			worldSpaceMatrix = GetParent().GetGlobalTransformMatrix();
 
-		localTransform.chachedWorldSpaceMatrix = worldSpaceMatrix * GetLocalTransformMatrix();
-		localTransform.cacheValid = true;
-
-		return localTransform.chachedWorldSpaceMatrix;
+		return MultiplyMatrix(worldSpaceMatrix, localTransform.GetTransformMatrix());
 	}
 
 	bool Entity::HasParent()
 	{
-		return scene->IsIdValid(GetComponent<TransformComponent>().parent);
+		return GetComponent<HierarchyComponent>().parent != NullEntityId;
 	}
 
 	Entity Entity::GetParent()
 	{
-		return scene->GetEntityById(GetComponent<TransformComponent>().parent);
+		return Entity(GetComponent<HierarchyComponent>().parent, scene);
 	}
 
 	void Entity::SetParent(Entity parent)
@@ -72,12 +91,7 @@ namespace Seidon
 		t.parent = parent.GetId();
 		t.SetFromMatrix(glm::inverse(parent.GetGlobalTransformMatrix()) * t.GetTransformMatrix());
 
-		std::vector<UUID>& parentChildren = parent.GetChildrenIds();
-
-		UUID id = GetId();
-		if (std::find(parentChildren.begin(), parentChildren.end(), id) == parentChildren.end())
-			parentChildren.emplace_back(id);
-		
+		parent.AddChild(*this);
 	}
 
 	void Entity::RemoveParent()
@@ -97,9 +111,17 @@ namespace Seidon
 		return GetComponent<TransformComponent>().children;
 	}
 
+	int Entity::GetChildCount()
+	{
+		return GetComponent<HierarchyComponent>().childCount;
+	}
+
 	void Entity::AddChild(Entity e)
 	{
+		if (e.GetComponent<HierarchyComponent>().parent == ID) return;
+
 		GetComponent<TransformComponent>().children.push_back(e.GetId());
+		scene->LinkChild(ID, e.ID);
 	}
 
 	void Entity::RemoveChild(Entity e)
@@ -111,22 +133,19 @@ namespace Seidon
 
 		if (it != children.end())
 			children.erase(it);
+
+		if (e.GetComponent<HierarchyComponent>().parent == ID)
+			scene->UnlinkChild(e.ID);
 	}
 
 	bool Entity::IsAncestorOf(Entity e)
 	{
-		const auto& children = GetChildrenIds();
-
-		if (children.empty())
-			return false;
-
-		for (UUID child : children)
-			if (child == e.GetId())
-				return true;
-
-		for (UUID child : children)
-			if (scene->GetEntityById(child).IsAncestorOf(e))
+		for (EntityId current = e.GetComponent<HierarchyComponent>().parent; current != NullEntityId;
+			current = scene->GetRegistry().get<HierarchyComponent>(current).parent)
+		{
+			if (current == ID)
 				return true;
+		}
 
 		return false;
 	}
@@ -136,34 +155,27 @@ namespace Seidon
 		return e.IsAncestorOf(*this);
 	}
 
-	void Entity::Save(std::ofstream& out)
+	void Entity::Save(BinaryWriter& out)
 	{
 		int componentCount = 0;
 		for (auto& metaType : Application::Get()->GetComponentMetaTypes())
 			if (metaType.Has(*this)) componentCount++;
 
-		out.write((char*)&componentCount, sizeof(int));
+		out.Write(componentCount);
 
 		for (auto& metaType : Application::Get()->GetComponentMetaTypes())
 		{
 			if (!metaType.Has(*this)) continue;
 
-			size_t size = metaType.name.length() + 1;
-
-			out.write((char*)&size, sizeof(size_t));
-			out.write(metaType.name.c_str(), size * sizeof(char));
-
-			size_t metaTypeSize = metaType.GetSerializedDataSize((byte*)metaType.Get(*this));
-			out.write((char*)&metaTypeSize, sizeof(size_t));
-
-			size_t memberCount = metaType.members.size();
-			out.write((char*)&memberCount, sizeof(size_t));
+			out.WriteString(metaType.name);
+			out.Write(metaType.GetSerializedDataSize((byte*)metaType.Get(*this)));
+			out.Write(metaType.members.size());
 
 			metaType.Save(out, (byte*)metaType.Get(*this));
 		}
 	}
 
-	void Entity::Load(std::ifstream& in)
+	void Entity::Load(BinaryReader& in)
 	{
 		if (HasComponent<IDComponent>())
 		{
@@ -173,35 +185,29 @@ namespace Seidon
 			RemoveComponent<MouseSelectionComponent>();
 		}
 
-		int componentCount = 0;
-		in.read((char*)&componentCount, sizeof(int));
+		int componentCount = in.Read<int>();
 
-		for (int i = 0; i < componentCount; i++)
+		for (int i = 0; i < componentCount && in.IsGood(); i++)
 		{
-			size_t size = 0;
-			char buffer[500];
-
-			in.read((char*)&size, sizeof(size_t));
-			in.read(buffer, size * sizeof(char));
-
-			size_t metaTypeSize = 0;
-			in.read((char*)&metaTypeSize, sizeof(size_t));
+			std::string typeName = in.ReadString();
+			size_t metaTypeSize = in.Read<size_t>();
 
-			if (!Application::Get()->IsComponentRegistered(buffer))
+			if (!Application::Get()->IsComponentRegistered(typeName))
 			{
-				std::cerr << "Serialized component '" << buffer << "' is not a registered component" << std::endl;
+				std::cerr << "Serialized component '" << typeName << "' is not a registered component" << std::endl;
 
-				in.seekg(metaTypeSize + sizeof(size_t), std::ios::cur);
+				in.Skip(metaTypeSize + sizeof(size_t));
 				continue;
 			}
 
-			ComponentMetaType metaType = Application::Get()->GetComponentMetaTypeByName(buffer);
-			size_t memberCount = 0;
-			in.read((char*)&memberCount, sizeof(size_t));
+			ComponentMetaType metaType = Application::Get()->GetComponentMetaTypeByName(typeName);
+			size_t memberCount = in.Read<size_t>();
 
 			if (metaType.members.size() != memberCount)
 			{
-				std::cerr << "Serialized component '" << buffer << "' not compatible with current types" << std::endl;
+				std::cerr << "Serialized component '" << typeName << "' not compatible with current types" << std::endl;
+
+				in.Skip(metaTypeSize);
 				continue;
 			}
 
@@ -214,6 +220,7 @@ namespace Seidon
 	Entity Entity::Duplicate()
 	{
 		Entity e = scene->CreateEntity();
+		scene->idToEntityMap.erase(e.GetId());
 
 		e.RemoveComponent<NameComponent>();
 		e.RemoveComponent<IDComponent>();
@@ -226,6 +233,13 @@ namespace Seidon
 				metaType.Copy(*this, e);
 
 		e.AddComponent<IDComponent>();
+		scene->idToEntityMap[e.GetId()] = e.ID;
+
+		// The copy is a sibling of the original, without children
+		e.GetComponent<TransformComponent>().children.clear();
+
+		if (HasParent())
+			GetParent().AddChild(e);
 
 		return e;
 	}
@@ -21,9 +21,9 @@ namespace Seidon
 		Entity(const Entity& entity) = default;
 		Entity(entt::entity id, Scene* scene);
 
-		void Save(std::ofstream& out);
+		void Save(BinaryWriter& out);
 
-		void Load(std::ifstream& in);
+		void Load(BinaryReader& in);
 
 		Entity Duplicate();
 
@@ -39,16 +39,35 @@ namespace Seidon
 		void RemoveParent();
 
 		std::vector<UUID>& GetChildrenIds();
+		int GetChildCount();
 		void AddChild(Entity e);
 		void RemoveChild(Entity e);
 
+		// Visits the children in order, the function may destroy the child it receives
+		template <typename Func>
+		void ForEachChild(const Func& function)
+		{
+			EntityId child = GetComponent<HierarchyComponent>().firstChild;
+
+			while (child != NullEntityId)
+			{
+				EntityId next = scene->GetRegistry().get<HierarchyComponent>(child).nextSibling;
+				function(Entity(child, scene));
+				child = next;
+			}
+		}
+
 		bool IsAncestorOf(Entity e);
 		bool IsDescendantOf(Entity e);
 
+		void SetActive(bool active);
+		bool IsActive();
+
 		template <typename T, typename... Args>
 		T& AddComponent(Args&&... args)
 		{
 			T& component = scene->GetRegistry().emplace_or_replace<T>(ID, std::forward<Args>(args)...);
+			scene->MarkComponentChanged<T>(ID);
 			scene->OnComponentAdded<T>(ID);
 			return component;
 		}
@@ -57,6 +76,7 @@ namespace Seidon
 		void EditComponent(std::function<void(T&)> editFunction)
 		{
 			scene->GetRegistry().patch<T>(ID, editFunction);
+			scene->MarkComponentChanged<T>(ID);
 		}
 
 		template <typename T>
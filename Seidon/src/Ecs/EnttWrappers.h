@@ -15,6 +15,12 @@ namespace Seidon
 	template<typename... Types>
 	inline constexpr TypeList<Types...> GetTypeList{};
 
+	template<typename... Types>
+	using ExcludeList = entt::exclude_t<Types...>;
+
+	template<typename... Types>
+	inline constexpr ExcludeList<Types...> GetExcludeList{};
+
 	typedef entt::entity EntityId;
 	inline constexpr entt::null_t NullEntityId{};
 
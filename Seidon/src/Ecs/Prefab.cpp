@@ -2,7 +2,6 @@
 
 #include "../Core/Application.h"
 
-#include <fstream>
 
 namespace Seidon
 {
@@ -11,6 +10,8 @@ namespace Seidon
 		prefabScene.Destroy();
 
 		rootEntityId = AddEntityHierarchy(entity).GetId();
+
+		prefabScene.RebuildHierarchy();
 	}
 
 	Entity Prefab::AddEntityHierarchy(Entity entity)
@@ -22,8 +23,7 @@ namespace Seidon
 			if (metaType.Has(entity))
 				metaType.Copy(entity, e);
 
-		for (UUID childId : entity.GetChildrenIds())
-			AddEntityHierarchy(entity.scene->GetEntityById(childId));
+		entity.ForEachChild([&](Entity child) { AddEntityHierarchy(child); });
 
 		return e;
 	}
@@ -35,17 +35,17 @@ namespace Seidon
 
 	void Prefab::Save(const std::string& path)
 	{
-		std::ofstream out(path, std::ios::out | std::ios::binary);
+		BinaryWriter out(path);
 
-		out.write((char*)&rootEntityId, sizeof(UUID));
+		out.Write(rootEntityId);
 		prefabScene.Save(out);
 	}
 
 	void Prefab::Load(const std::string& path)
 	{
-		std::ifstream in(path, std::ios::in | std::ios::binary);
+		BinaryReader in(path);
 		
-		in.read((char*)&rootEntityId, sizeof(UUID));
+		in.Read(rootEntityId);
 		prefabScene.Load(in);
 	}
 }
\ No newline at end of file
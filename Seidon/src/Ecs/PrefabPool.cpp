@@ -0,0 +1,84 @@
+#include "PrefabPool.h"
+
+#include <iostream>
+
+namespace Seidon
+{
+	PrefabPool::PrefabPool(Scene* scene, Prefab* prefab, size_t initialSize)
+		: scene(scene), prefab(prefab)
+	{
+		Reserve(initialSize);
+	}
+
+	void PrefabPool::Reserve(size_t count)
+	{
+		std::vector<Entity> instances = scene->InstantiatePrefab(*prefab, nullptr, count);
+
+		available.reserve(available.size() + instances.size());
+
+		for (Entity& instance : instances)
+		{
+			instance.SetActive(false);
+			available.push_back(instance.ID);
+			this->instances.insert(instance.ID);
+		}
+	}
+
+	Entity PrefabPool::Acquire(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+	{
+		if (available.empty())
+		{
+			Entity e = scene->InstantiatePrefab(*prefab, position, rotation, scale);
+			instances.insert(e.ID);
+
+			return e;
+		}
+
+		Entity e(available.back(), scene);
+		available.pop_back();
+
+		// Moved before reactivating, the physics system reads the new pose when it puts the actors back
+		TransformComponent& transform = e.GetComponent<TransformComponent>();
+		transform.position = position;
+		transform.rotation = rotation;
+		transform.scale = scale;
+
+		e.SetActive(true);
+
+		return e;
+	}
+
+	void PrefabPool::Release(Entity entity)
+	{
+		if (instances.count(entity.ID) == 0 || !scene->GetRegistry().valid(entity.ID))
+		{
+			std::cerr << "Released an entity that wasn't acquired from this pool" << std::endl;
+			return;
+		}
+
+		if (!entity.IsActive())
+		{
+			std::cerr << "Entity released twice" << std::endl;
+			return;
+		}
+
+		entity.SetActive(false);
+		available.push_back(entity.ID);
+	}
+
+	void PrefabPool::Clear()
+	{
+		for (EntityId id : available)
+		{
+			if (!scene->GetRegistry().valid(id)) continue;
+
+			Entity e(id, scene);
+			scene->DestroyEntity(e);
+		}
+
+		for (EntityId id : available)
+			instances.erase(id);
+
+		available.clear();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+#include "Entity.h"
+#include "Prefab.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+#include <unordered_set>
+
+namespace Seidon
+{
+	/*
+	* Recycles the instances of a prefab instead of destroying them. Released instances are deactivated (see
+	* Scene::SetEntityActive), so their components and physics actors stay alive and acquiring one only moves
+	* it and turns it back on. Acquire and Release are structural changes: call them where entities could be
+	* created or destroyed, not from systems running in parallel. The pool must not outlive its scene
+	*/
+	class PrefabPool
+	{
+	private:
+		Scene* scene;
+		Prefab* prefab;
+
+		std::vector<EntityId> available;
+
+		// Every root this pool instantiated, only those can be released into it
+		std::unordered_set<EntityId> instances;
+
+	public:
+		PrefabPool(Scene* scene, Prefab* prefab, size_t initialSize = 0);
+
+		// Instantiates count inactive instances in one batch
+		void Reserve(size_t count);
+
+		// Falls back to a new instance when the pool is empty
+		Entity Acquire(const glm::vec3& position, const glm::quat& rotation = glm::quat(1, 0, 0, 0), const glm::vec3& scale = glm::vec3(1));
+
+		// Entities that don't come from this pool, or that are already released, are left untouched
+		void Release(Entity entity);
+
+		// Destroys the instances waiting in the pool, acquired ones are left to the scene
+		void Clear();
+
+		inline size_t GetAvailableCount() { return available.size(); }
+	};
+}
\ No newline at end of file
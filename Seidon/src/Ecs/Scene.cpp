@@ -1,13 +1,23 @@
 #include "Scene.h"
 #include "Entity.h"
 #include "Prefab.h"
+#include "CommandBuffer.h"
 #include "../Core/Application.h"
+#include "../Debug/Profiler.h"
+#include "../Utils/SimdMath.h"
+#include "../Utils/MappedFile.h"
 
 #include <iostream>
 #include <fstream>
+#include <limits>
+#include <chrono>
+#include <unordered_set>
 
 namespace Seidon
 {
+	// See Scene::GetRunningSystem
+	static thread_local const System* runningSystem = nullptr;
+
 	Scene::Scene(const std::string& name, UUID id)
 	{
 		this->name = name;
@@ -22,6 +32,7 @@ namespace Seidon
 
 	void Scene::Init()
 	{
+		CreateCommandBuffers();
 	}
 
 	//LONG WINAPI ExceptionFilterFunction(struct _EXCEPTION_POINTERS* ExceptionInfo)
@@ -32,20 +43,15 @@ namespace Seidon
 
 	void Scene::Update(float deltaTime)
 	{
-		CreateViewAndIterate<TransformComponent>
-		(
-			[](EntityId id, TransformComponent& transform)
-			{
-				transform.cacheValid = false;
-			}
-		);
+		AdvanceChangeHistory();
+		UpdateTransforms();
 
 		//LPTOP_LEVEL_EXCEPTION_FILTER oldExceptionFilter = SetUnhandledExceptionFilter(&ExceptionFilterFunction);
 
 		//try
 		//{
-			for (auto& [typeName, system] : systems)
-				system->SysUpdate(deltaTime);
+			UpdateSystems(deltaTime);
+			PlaybackCommands();
 		//}
 		//catch (...)
 		//{
@@ -55,62 +61,142 @@ namespace Seidon
 		//SetUnhandledExceptionFilter(oldExceptionFilter);
 	}
 
-	void Scene::Save(std::ofstream& out)
+	void Scene::Save(BinaryWriter& out)
 	{
-		out.write((char*)&id, sizeof(UUID));
+		out.Write(id);
+		out.Write(SCENE_MAGIC);
+		out.Write(SCENE_VERSION);
+		out.WriteString(name);
 
-		size_t size = name.length() + 1;
+		// Entity table, the ids of the entities in the order the columns refer to them
+		auto idView = registry.view<IDComponent>();
 
-		out.write((char*)&size, sizeof(size_t));
-		out.write(name.c_str(), size * sizeof(char));
+		std::vector<UUID> ids;
+		ids.reserve(idView.size());
 
-		size_t entityCount = registry.alive();
-		out.write((char*)&entityCount, sizeof(size_t));
+		// Position in the table by entity index, entities without an id are not saved
+		std::vector<uint32_t> positions(registry.size(), std::numeric_limits<uint32_t>::max());
 
-		registry.each([&](auto entityID)
+		for (EntityId entity : idView)
 		{
-			Entity entity = { entityID, this };
-			entity.Save(out);
-		});
+			positions[entt::to_entity(entity)] = (uint32_t)ids.size();
+			ids.push_back(idView.get<IDComponent>(entity).ID);
+		}
 
-		size_t systemCount = systems.size();
-		out.write((char*)&systemCount, sizeof(size_t));
+		out.WriteVector(ids);
 
-		for (auto& [name, system] : systems)
+		// One column per component type, the ids are already in the entity table. Columns are cut in chunks
+		// that can be decoded independently, see LoadColumnar
+		struct Column
 		{
-			SystemMetaType metaType = Application::Get()->GetSystemMetaTypeByName(name);
+			ComponentMetaType* metaType;
+			std::vector<std::vector<char>> chunks;
+		};
 
-			size_t size = metaType.name.length() + 1;
+		std::vector<ComponentMetaType> components = Application::Get()->GetComponentMetaTypes();
+		std::vector<Column> columns;
 
-			out.write((char*)&size, sizeof(size_t));
-			out.write(metaType.name.c_str(), size * sizeof(char));
+		std::vector<EntityId> entities;
+		std::vector<void*> data;
+		std::vector<uint32_t> columnEntities;
+		std::vector<void*> columnComponents;
 
-			size_t metaTypeSize = metaType.GetSerializedDataSize((byte*)system);
-			out.write((char*)&metaTypeSize, sizeof(size_t));
+		for (ComponentMetaType& metaType : components)
+		{
+			if (metaType.name == typeid(IDComponent).name()) continue;
 
-			size_t memberCount = metaType.members.size();
-			out.write((char*)&memberCount, sizeof(size_t));
+			metaType.GetAll(*this, entities, data);
 
-			metaType.Save(out, (byte*)system);
+			columnEntities.clear();
+			columnComponents.clear();
+
+			for (size_t i = 0; i < entities.size(); i++)
+			{
+				uint32_t position = positions[entt::to_entity(entities[i])];
+				if (position == std::numeric_limits<uint32_t>::max()) continue;
+
+				columnEntities.push_back(position);
+				columnComponents.push_back(data[i]);
+			}
+
+			if (columnEntities.empty()) continue;
+
+			Column& column = columns.emplace_back();
+			column.metaType = &metaType;
+
+			for (size_t begin = 0; begin < columnEntities.size(); begin += COLUMN_CHUNK_SIZE)
+			{
+				size_t end = std::min(begin + COLUMN_CHUNK_SIZE, columnEntities.size());
+
+				BinaryWriter chunkOut(column.chunks.emplace_back());
+
+				chunkOut.Write(end - begin);
+				chunkOut.WriteArray(&columnEntities[begin], end - begin);
+
+				metaType.SaveMembers(chunkOut, &columnComponents[begin], end - begin);
+			}
 		}
+
+		// Type table, with the schema each column was saved with
+		out.Write(columns.size());
+
+		for (Column& column : columns)
+		{
+			ComponentMetaType& metaType = *column.metaType;
+
+			out.WriteString(metaType.name);
+			out.Write(metaType.GetSchemaHash());
+			out.Write(metaType.members.size());
+
+			for (MemberData& m : metaType.members)
+			{
+				out.WriteString(m.name);
+				out.Write(m.type);
+			}
+		}
+
+		// Chunks are prefixed with their size, so that the ones that can't be loaded are skipped as a whole
+		for (Column& column : columns)
+		{
+			out.Write(column.chunks.size());
+
+			for (std::vector<char>& chunk : column.chunks)
+				out.WriteVector(chunk);
+		}
+
+		SaveSystems(out);
 	}
 
-	void Scene::Load(std::ifstream& in)
+	void Scene::Load(const std::string& path)
 	{
-		in.read((char*)&id, sizeof(UUID));
+		// Columns are decoded straight from the mapped file
+		BinaryReader in(std::make_shared<MappedFile>(path));
+		Load(in);
+	}
 
-		size_t size = 0;
-		char buffer[500];
+	void Scene::Load(BinaryReader& in)
+	{
+		in.Read(id);
 
-		in.read((char*)&size, sizeof(size_t));
-		in.read(buffer, size * sizeof(char));
+		uint64_t tag = in.Read<uint64_t>();
 
-		name = std::string(buffer);
+		if (tag == SCENE_MAGIC)
+			LoadColumnar(in);
+		else
+			LoadV1(in, tag);
+	}
 
-		size_t entityCount = 0;
-		in.read((char*)&entityCount, sizeof(size_t));
+	void Scene::LoadV1(BinaryReader& in, size_t nameLength)
+	{
+		in.ReadString(name, nameLength);
+
+		size_t entityCount = in.Read<size_t>();
 
-		for (int i = 0; i < entityCount; i++)
+		// Assets referenced by the entities load in parallel and are ready before any system runs
+		ResourceManager* resourceManager = Application::Get()->GetResourceManager();
+		resourceManager->BeginLoadBatch();
+
+		for (size_t i = 0; i < entityCount && in.IsGood(); i++)
 		{
 			Entity e(registry.create(), this);
 			e.Load(in);
@@ -118,34 +204,292 @@ namespace Seidon
 			idToEntityMap[e.GetId()] = e.ID;
 		}
 
-		size_t systemCount = 0;
-		in.read((char*)&systemCount, sizeof(size_t));
+		resourceManager->EndLoadBatch();
+
+		RebuildHierarchy();
+
+		LoadSystems(in);
+	}
+
+	void Scene::LoadColumnar(BinaryReader& in)
+	{
+		uint32_t version = in.Read<uint32_t>();
+
+		if (version < 2 || version > SCENE_VERSION)
+		{
+			std::cerr << "Error loading scene: unsupported version " << version << std::endl;
+			return;
+		}
+
+		in.ReadString(name);
+
+		std::vector<UUID> ids;
+		in.ReadVector(ids);
+
+		struct SavedType
+		{
+			std::string name;
+			uint64_t schemaHash;
+			std::vector<MemberData> members;
+
+			ComponentMetaType metaType;
+			bool loaded = false;
+			bool sameSchema = false;
+		};
+
+		std::vector<SavedType> types(in.ReadCount(2 * sizeof(size_t) + sizeof(uint64_t)));
+
+		for (SavedType& type : types)
+		{
+			in.ReadString(type.name);
+			in.Read(type.schemaHash);
+
+			type.members.resize(in.ReadCount(sizeof(size_t) + sizeof(Types)));
+
+			for (MemberData& m : type.members)
+			{
+				in.ReadString(m.name);
+				in.Read(m.type);
+			}
+		}
+
+		if (!in.IsGood())
+		{
+			std::cerr << "Error loading scene " << name << ": corrupted entity or type table" << std::endl;
+			return;
+		}
+
+		// Chunks of the columns are decoded in parallel into staging columns, then inserted in file order
+		struct Chunk
+		{
+			size_t type;
+			const char* data;
+			size_t size;
+
+			// Copy of the data when the reader can't read in place
+			std::vector<char> buffer;
+
+			std::vector<uint32_t> positions;
+			size_t membersOffset = 0;
+
+			std::shared_ptr<ComponentColumn> column;
+			std::vector<void*> components;
+			AssetResolver assets{ true };
+			bool valid = false;
+		};
+
+		std::vector<Chunk> chunks;
+		std::unordered_set<std::string> loadedTypes;
+
+		for (size_t t = 0; t < types.size() && in.IsGood(); t++)
+		{
+			SavedType& type = types[t];
+
+			// v2 files have a single chunk per column
+			size_t chunkCount = version >= 3 ? in.ReadCount(sizeof(size_t)) : 1;
+
+			if (!Application::Get()->IsComponentRegistered(type.name))
+				std::cerr << "Serialized component '" << type.name << "' is not a registered component" << std::endl;
+			else if (type.name != typeid(IDComponent).name() && loadedTypes.insert(type.name).second)
+			{
+				type.metaType = Application::Get()->GetComponentMetaTypeByName(type.name);
+				type.sameSchema = type.schemaHash == type.metaType.GetSchemaHash();
+				type.loaded = true;
+			}
+
+			for (size_t i = 0; i < chunkCount && in.IsGood(); i++)
+			{
+				size_t size = in.ReadCount(1);
+
+				if (!type.loaded)
+				{
+					in.Skip(size);
+					continue;
+				}
+
+				Chunk& chunk = chunks.emplace_back();
+				chunk.type = t;
+				chunk.size = size;
+				chunk.data = in.ReadInPlace(size);
+
+				if (!chunk.data)
+				{
+					chunk.buffer.resize(size);
+					in.ReadBytes(chunk.buffer.data(), size);
+					chunk.data = chunk.buffer.data();
+				}
+			}
+		}
+
+		if (!in.IsGood())
+		{
+			std::cerr << "Error loading scene " << name << ": truncated component columns" << std::endl;
+			return;
+		}
+
+		// Every entity is created at once along with its id
+		std::vector<EntityId> entities(ids.size());
+		registry.create(entities.begin(), entities.end());
+
+		std::vector<IDComponent> idComponents(ids.begin(), ids.end());
+		registry.insert<IDComponent>(entities.begin(), entities.end(), idComponents.begin());
+
+		idToEntityMap.reserve(idToEntityMap.size() + ids.size());
+		for (size_t i = 0; i < ids.size(); i++)
+			idToEntityMap[ids[i]] = entities[i];
+
+		GetChangeLog(typeid(IDComponent).name()).Mark(entities.data(), entities.size(), changeVersion);
+
+		// Component constructors may look up default assets, so the staging columns are created here and not by the workers
+		for (Chunk& chunk : chunks)
+		{
+			BinaryReader chunkIn(chunk.data, chunk.size);
+			chunkIn.ReadVector(chunk.positions);
+
+			if (!chunkIn.IsGood() || std::any_of(chunk.positions.begin(), chunk.positions.end(),
+				[&](uint32_t position) { return position >= entities.size(); }))
+				continue;
+
+			chunk.membersOffset = chunkIn.GetPosition();
+			chunk.column = types[chunk.type].metaType.CreateColumn(chunk.positions.size(), chunk.components);
+		}
+
+		// Decoding only reads the chunk and the metatype, asset ids are recorded and resolved afterwards
+		GetWorkManager()->ParallelFor(chunks.size(), 1, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					Chunk& chunk = chunks[i];
+					SavedType& type = types[chunk.type];
+
+					if (!chunk.column) continue;
+
+					BinaryReader chunkIn(chunk.data + chunk.membersOffset, chunk.size - chunk.membersOffset);
+					std::vector<void*>& components = chunk.components;
+
+					// Saved with the current schema, the whole chunk is read by the plan. Otherwise members are matched by name
+					if (type.sameSchema)
+						type.metaType.LoadMembers(chunkIn, components.data(), components.size(), chunk.assets);
+					else
+						for (void* component : components)
+							type.metaType.LoadMembers(chunkIn, (byte*)component, type.members, chunk.assets);
+
+					chunk.valid = chunkIn.IsGood();
+				}
+			}
+		);
+
+		// Assets referenced by the components load in parallel and are ready before any system runs
+		ResourceManager* resourceManager = Application::Get()->GetResourceManager();
+		resourceManager->BeginLoadBatch();
+
+		// Added callbacks run once every component and the hierarchy are in place
+		bool deferring = deferComponentCallbacks;
+		deferComponentCallbacks = true;
+
+		OnComponentsAdded<IDComponent>(entities);
+
+		// Shared by all the chunks, each referenced asset is looked up once
+		AssetResolver assets;
+
+		// Index of the last type that gave a component to each entity, to reject corrupted chunks
+		std::vector<size_t> lastType(entities.size(), std::numeric_limits<size_t>::max());
+
+		for (Chunk& chunk : chunks)
+		{
+			SavedType& type = types[chunk.type];
+
+			for (size_t i = 0; i < chunk.positions.size() && chunk.valid; i++)
+			{
+				if (lastType[chunk.positions[i]] == chunk.type)
+					chunk.valid = false;
+
+				lastType[chunk.positions[i]] = chunk.type;
+			}
+
+			if (!chunk.valid)
+			{
+				std::cerr << "Error loading scene " << name << ": corrupted column for component '" << type.name << "'" << std::endl;
+				continue;
+			}
+
+			// Staging components still hold the asset pointers, they're resolved before moving them
+			assets.Resolve(chunk.assets);
+
+			chunk.column->entities.reserve(chunk.positions.size());
+			for (uint32_t position : chunk.positions)
+				chunk.column->entities.push_back(entities[position]);
+
+			type.metaType.InsertAll(*this, *chunk.column);
+
+			// Referenced assets may still be loading, OnChange usually reads them
+			if (type.metaType.OnChange)
+			{
+				void (*onChange)(void*) = type.metaType.OnChange;
+				void* (*get)(Entity) = type.metaType.Get;
+
+				resourceManager->RunAfterLoadBatch([this, onChange, get, changed = chunk.column->entities]()
+					{
+						for (EntityId entity : changed)
+							onChange(get(Entity(entity, this)));
+					}
+				);
+			}
+
+			chunk.column.reset();
+		}
+
+		resourceManager->EndLoadBatch();
+
+		RebuildHierarchy();
+
+		deferComponentCallbacks = deferring;
+		if (!deferring) CallDeferredAddedCallbacks();
+
+		LoadSystems(in);
+	}
+
+	void Scene::SaveSystems(BinaryWriter& out)
+	{
+		out.Write(systems.size());
 
-		for (int i = 0; i < systemCount; i++)
+		for (auto& [name, system] : systems)
 		{
-			size_t size = 0;
+			SystemMetaType metaType = Application::Get()->GetSystemMetaTypeByName(name);
+
+			out.WriteString(metaType.name);
+			out.Write(metaType.GetSerializedDataSize((byte*)system));
+			out.Write(metaType.members.size());
+
+			metaType.Save(out, (byte*)system);
+		}
+	}
 
-			in.read((char*)&size, sizeof(size_t));
-			in.read(buffer, size * sizeof(char));
+	void Scene::LoadSystems(BinaryReader& in)
+	{
+		size_t systemCount = in.Read<size_t>();
 
-			size_t metaTypeSize = 0;
-			in.read((char*)&metaTypeSize, sizeof(size_t));
+		for (size_t i = 0; i < systemCount && in.IsGood(); i++)
+		{
+			std::string typeName = in.ReadString();
+			size_t metaTypeSize = in.Read<size_t>();
 
-			if (!Application::Get()->IsSystemRegistered(buffer))
+			if (!Application::Get()->IsSystemRegistered(typeName))
 			{
-				std::cerr << "Serialized system '" << buffer << "' is not a registered system, make sure that the relative extension is loaded and try again" << std::endl;
-				in.seekg(metaTypeSize, std::ios::cur);
+				std::cerr << "Serialized system '" << typeName << "' is not a registered system, make sure that the relative extension is loaded and try again" << std::endl;
+				in.Skip(metaTypeSize + sizeof(size_t));
 				continue;
 			}
 
-			SystemMetaType metaType = Application::Get()->GetSystemMetaTypeByName(buffer);
+			SystemMetaType metaType = Application::Get()->GetSystemMetaTypeByName(typeName);
 
-			size_t memberCount = 0;
-			in.read((char*)&memberCount, sizeof(size_t));
+			size_t memberCount = in.Read<size_t>();
 
 			if (metaType.members.size() != memberCount)
 			{
-				std::cerr << "Serialized system '" << buffer << "' not compatible with current types" << std::endl;
+				std::cerr << "Serialized system '" << typeName << "' not compatible with current types" << std::endl;
+
+				in.Skip(metaTypeSize);
 				continue;
 			}
 
@@ -163,7 +507,21 @@ namespace Seidon
 		}
 
 		systems.clear();
+
+		// The buffers stay, jobs of a scene that gets reused after Destroy may still record commands
+		for (std::unique_ptr<CommandBuffer>& buffer : commandBuffers)
+		{
+			buffer->commands.clear();
+			buffer->createdEntities.clear();
+		}
+
+		systemSchedule.clear();
+		systemScheduleDirty = true;
+		systemTimings.clear();
+
 		registry.clear();
+		transformHierarchy.clear();
+		transformHierarchyDirty = true;
 	}
 
 	Scene* Scene::Duplicate()
@@ -178,33 +536,134 @@ namespace Seidon
 
 	void Scene::CopyEntities(Scene* other)
 	{
-		auto& srcRegistry = registry;
-		auto& dstRegistry = other->registry;
-		std::unordered_map<UUID, EntityId> enttMap;
+		auto idView = registry.view<IDComponent>();
+
+		std::vector<EntityId> copies(idView.size());
+		other->registry.create(copies.begin(), copies.end());
 
-		auto idView = srcRegistry.view<IDComponent>();
-		for (auto e : idView)
+		// Copy of each entity by entity index, null for the ones without an id that are not copied
+		std::vector<EntityId> entityMap(registry.size(), (EntityId)NullEntityId);
+		other->idToEntityMap.reserve(other->idToEntityMap.size() + copies.size());
+
+		size_t i = 0;
+		for (EntityId id : idView)
+		{
+			entityMap[entt::to_entity(id)] = copies[i];
+			other->idToEntityMap[idView.get<IDComponent>(id).ID] = copies[i];
+			i++;
+		}
+
+		// Added callbacks run once every component and the hierarchy are in place
+		bool deferring = other->deferComponentCallbacks;
+		other->deferComponentCallbacks = true;
+
+		// One component type at a time, so each storage is filled in one go
+		const std::vector<ComponentMetaType>& components = Application::Get()->GetComponentMetaTypes();
+		for (auto& metaType : components)
+			metaType.CopyAll(*this, *other, entityMap);
+
+		other->RebuildHierarchy();
+		other->transformHierarchyDirty = true;
+
+		other->deferComponentCallbacks = deferring;
+		if (!deferring) other->CallDeferredAddedCallbacks();
+	}
+
+	SceneSnapshot Scene::Snapshot(const SceneSnapshot* baseline)
+	{
+		// Transforms moved in place since the last frame have to be marked before comparing versions
+		UpdateTransforms();
+
+		SceneSnapshot snapshot;
+		snapshot.changeVersion = CaptureChangeVersion();
+		snapshot.entities.assign(registry.data(), registry.data() + registry.size());
+		snapshot.released = registry.released();
+
+		bool shareColumns = baseline && HasSameEntities(*baseline);
+
+		const std::vector<ComponentMetaType>& components = Application::Get()->GetComponentMetaTypes();
+		for (auto& metaType : components)
 		{
-			UUID uuid = srcRegistry.get<IDComponent>(e).ID;
-			std::string& name = srcRegistry.get<NameComponent>(e).name;
+			if (shareColumns && !HasComponentTypeChanged(metaType.name, baseline->changeVersion))
+			{
+				auto it = baseline->columns.find(metaType.name);
+				if (it != baseline->columns.end())
+					snapshot.columns[metaType.name] = it->second;
+
+				continue;
+			}
 
-			Entity newEntity = other->CreateEntity(name, uuid);
-			enttMap[uuid] = newEntity.ID;
+			std::shared_ptr<const ComponentColumn> column = metaType.SnapshotAll(*this);
+			if (column) snapshot.columns[metaType.name] = column;
 		}
 
+		return snapshot;
+	}
+
+	void Scene::Restore(const SceneSnapshot& snapshot)
+	{
+		UpdateTransforms();
+
+		bool sameEntities = HasSameEntities(snapshot);
+		bool transformsRestored = !sameEntities;
+
 		const std::vector<ComponentMetaType>& components = Application::Get()->GetComponentMetaTypes();
-		srcRegistry.each([&](auto entityId) 
+
+		// Different entities: everything is rebuilt, with the entity ids of the snapshot
+		if (!sameEntities)
+		{
+			for (auto& metaType : components)
+				metaType.ClearAll(*this);
+
+			registry.clear();
+			registry.assign(snapshot.entities.begin(), snapshot.entities.end(), snapshot.released);
+		}
+
+		for (auto& metaType : components)
+		{
+			if (sameEntities)
 			{
-				for (auto& metaType : components)
-					if (metaType.Has(Entity(entityId, this)))
-					{
-						UUID uuid = srcRegistry.get<IDComponent>(entityId).ID;
-						EntityId dstEnttID = enttMap.at(uuid);
+				if (!HasComponentTypeChanged(metaType.name, snapshot.changeVersion)) continue;
 
-						metaType.Copy(Entity(entityId, this), Entity(dstEnttID, other));
-					}
-			});
+				metaType.ClearAll(*this);
+
+				if (metaType.name == typeid(TransformComponent).name())
+					transformsRestored = true;
+			}
+
+			auto it = snapshot.columns.find(metaType.name);
+			if (it != snapshot.columns.end())
+				metaType.RestoreAll(*this, *it->second);
+		}
+
+		if (!sameEntities)
+		{
+			idToEntityMap.clear();
+			registry.view<IDComponent>().each([&](EntityId id, IDComponent& idComponent)
+				{
+					idToEntityMap[idComponent.ID] = id;
+				}
+			);
+		}
+
+		if (transformsRestored)
+			RebuildHierarchy();
+
+		transformHierarchyDirty = true;
+	}
 
+	bool Scene::HasComponentTypeChanged(const std::string& typeName, uint32_t sinceVersion)
+	{
+		ComponentChangeLog* log = FindChangeLog(typeName);
+		return log && log->HasChangesAfter(sinceVersion);
+	}
+
+	bool Scene::HasSameEntities(const SceneSnapshot& snapshot)
+	{
+		if (registry.size() != snapshot.entities.size() || registry.released() != snapshot.released)
+			return false;
+
+		return std::equal(snapshot.entities.begin(), snapshot.entities.end(), registry.data());
 	}
 
 	void Scene::CopySystems(Scene* other)
@@ -222,6 +681,7 @@ namespace Seidon
 	{
 		Entity e(registry.create(), this);
 		e.AddComponent<TransformComponent>().parent = 0;
+		registry.emplace<HierarchyComponent>(e.ID);
 		UUID i = e.AddComponent<IDComponent>(id).ID;
 		e.AddComponent<MouseSelectionComponent>();
 
@@ -231,86 +691,154 @@ namespace Seidon
 			e.AddComponent<NameComponent>(name);
 
 		idToEntityMap[i] = e.ID;
+		transformHierarchyDirty = true;
 
 		return e;
 	}
 
 	Entity Scene::InstantiatePrefab(Prefab& prefab, const std::string& name)
 	{
-		Entity e(registry.create(), this);
-
-		const std::vector<ComponentMetaType>& components = Application::Get()->GetComponentMetaTypes();
-		for (auto& metaType : components)
-			if (metaType.Has(prefab.GetRootEntity()))
-				metaType.Copy(prefab.GetRootEntity(), e);
-
-		e.GetComponent<IDComponent>().ID = UUID();
+		Entity e = InstantiatePrefab(prefab, nullptr, 1)[0];
 
 		if (name != "")
 			e.GetComponent<NameComponent>().name = name;
 
-		TransformComponent& t = e.GetComponent<TransformComponent>();
-		t.parent = 0;
-		t.children.clear();
+		return e;
+	}
 
-		for (UUID childId : prefab.GetRootEntity().GetChildrenIds())
-			AddChildEntityFromPrefab(e, prefab.prefabScene.GetEntityById(childId));
+	Entity Scene::InstantiatePrefab(Prefab& prefab, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale, const std::string& name)
+	{
+		TransformComponent transform;
+		transform.position = position;
+		transform.rotation = rotation;
+		transform.scale = scale;
+
+		Entity e = InstantiatePrefab(prefab, &transform, 1)[0];
 
-		idToEntityMap[e.GetComponent<IDComponent>().ID] = e.ID;
+		if (name != "")
+			e.GetComponent<NameComponent>().name = name;
 
 		return e;
 	}
 
-	Entity Scene::InstantiatePrefab(Prefab& prefab, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale, const std::string& name)
+	std::vector<Entity> Scene::InstantiatePrefab(Prefab& prefab, const TransformComponent* transforms, size_t count)
 	{
-		Entity e(registry.create(), this);
+		std::vector<Entity> roots;
+		if (count == 0) return roots;
+
+		Scene& prefabScene = prefab.prefabScene;
+
+		// Prefab hierarchy flattened parents first, with the index of the parent of each node
+		std::vector<EntityId> nodes = { prefab.GetRootEntity().ID };
+		std::vector<int> parents = { -1 };
+
+		for (int i = 0; i < nodes.size(); i++)
+		{
+			Entity node(nodes[i], &prefabScene);
+			node.ForEachChild([&](Entity child)
+				{
+					nodes.push_back(child.ID);
+					parents.push_back(i);
+				}
+			);
+		}
+
+		// Instance i owns the nodeCount entities starting at i * nodeCount, in the order of nodes
+		size_t nodeCount = nodes.size();
+
+		std::vector<EntityId> instances(nodeCount * count);
+		registry.create(instances.begin(), instances.end());
+		registry.insert<HierarchyComponent>(instances.begin(), instances.end());
+
+		// Callbacks run once the ids and the hierarchy of every instance are set
+		bool deferring = deferComponentCallbacks;
+		deferComponentCallbacks = true;
 
 		const std::vector<ComponentMetaType>& components = Application::Get()->GetComponentMetaTypes();
 		for (auto& metaType : components)
-			if (metaType.Has(prefab.GetRootEntity()))
-				metaType.Copy(prefab.GetRootEntity(), e);
+			metaType.InstantiateAll(prefabScene, *this, nodes, instances);
 
-		e.GetComponent<IDComponent>().ID = UUID();
+		idToEntityMap.reserve(idToEntityMap.size() + instances.size());
+		roots.reserve(count);
 
-		if (name != "")
-			e.GetComponent<NameComponent>().name = name;
+		for (size_t i = 0; i < count; i++)
+		{
+			const EntityId* instance = &instances[i * nodeCount];
+
+			for (size_t j = 0; j < nodeCount; j++)
+			{
+				UUID id;
+				registry.get<IDComponent>(instance[j]).ID = id;
+				idToEntityMap[id] = instance[j];
 
-		TransformComponent& t = e.GetComponent<TransformComponent>();
-		t.position = position;
-		t.rotation = rotation;
-		t.scale = scale;
-		t.parent = 0;
-		t.children.clear();
+				TransformComponent& transform = registry.get<TransformComponent>(instance[j]);
+				transform.children.clear();
+				transform.cacheValid = false;
 
-		for (UUID childId : prefab.GetRootEntity().GetChildrenIds())
-			AddChildEntityFromPrefab(e, prefab.prefabScene.GetEntityById(childId));
+				if (parents[j] < 0)
+				{
+					transform.parent = 0;
 
-		idToEntityMap[e.GetComponent<IDComponent>().ID] = e.ID;
-		
-		return e;
+					if (transforms)
+					{
+						transform.position = transforms[i].position;
+						transform.rotation = transforms[i].rotation;
+						transform.scale = transforms[i].scale;
+					}
+
+					roots.push_back(Entity(instance[j], this));
+					continue;
+				}
+
+				EntityId parent = instance[parents[j]];
+				TransformComponent& parentTransform = registry.get<TransformComponent>(parent);
+
+				transform.parent = registry.get<IDComponent>(parent).ID;
+				parentTransform.children.push_back(id);
+
+				LinkChild(parent, instance[j]);
+			}
+		}
+
+		deferComponentCallbacks = deferring;
+		if (!deferring) CallDeferredAddedCallbacks();
+
+		transformHierarchyDirty = true;
+
+		return roots;
 	}
 
-	void Scene::AddChildEntityFromPrefab(Entity parentEntity, Entity prefabEntity)
+	void Scene::SetEntityActive(EntityId id, bool active)
 	{
-		Entity e(registry.create(), this);
-
-		const std::vector<ComponentMetaType>& components = Application::Get()->GetComponentMetaTypes();
-		for (auto& metaType : components)
-			if (metaType.Has(prefabEntity))
-				metaType.Copy(prefabEntity, e);
+		std::vector<EntityId> stack = { id };
 
-		e.GetComponent<IDComponent>().ID = UUID();
+		while (!stack.empty())
+		{
+			EntityId e = stack.back();
+			stack.pop_back();
 
-		TransformComponent& t = e.GetComponent<TransformComponent>();
-		t.parent = parentEntity.GetId();
-		t.children.clear();
+			bool inactive = registry.all_of<InactiveComponent>(e);
 
-		parentEntity.AddChild(e);
+			if (active && inactive)
+			{
+				OnComponentRemoved<InactiveComponent>(e);
+				registry.remove<InactiveComponent>(e);
+			}
+			else if (!active && !inactive)
+			{
+				registry.emplace<InactiveComponent>(e);
+				OnComponentAdded<InactiveComponent>(e);
+			}
 
-		for (UUID childId : prefabEntity.GetChildrenIds())
-			AddChildEntityFromPrefab(e, prefabEntity.scene->GetEntityById(childId));
+			const HierarchyComponent& hierarchy = registry.get<HierarchyComponent>(e);
+			for (EntityId child = hierarchy.firstChild; child != NullEntityId; child = registry.get<HierarchyComponent>(child).nextSibling)
+				stack.push_back(child);
+		}
+	}
 
-		idToEntityMap[e.GetComponent<IDComponent>().ID] = e.ID;
+	bool Scene::IsEntityActive(EntityId id)
+	{
+		return !registry.all_of<InactiveComponent>(id);
 	}
 
 	void Scene::DestroyEntity(Entity& entity)
@@ -318,11 +846,7 @@ namespace Seidon
 		if (entity.HasParent())
 			entity.GetParent().RemoveChild(entity);
 
-		for (UUID id : entity.GetChildrenIds())
-		{
-			Entity e = GetEntityById(id);
-			DestroyEntity(e);
-		}
+		entity.ForEachChild([&](Entity child) { DestroyEntity(child); });
 
 		idToEntityMap.erase(entity.GetId());
 
@@ -332,6 +856,578 @@ namespace Seidon
 				metaType.Remove(entity);
 
 		registry.destroy(entity.ID);
+		transformHierarchyDirty = true;
+	}
+
+	void Scene::RebuildHierarchy()
+	{
+		auto transforms = registry.view<TransformComponent>();
+
+		for (EntityId id : transforms)
+			registry.emplace_or_replace<HierarchyComponent>(id);
+
+		// Children are linked in the order of the children ids, skipping ids that don't point back to the parent
+		for (EntityId id : transforms)
+		{
+			UUID uuid = registry.get<IDComponent>(id).ID;
+
+			for (UUID childId : transforms.get<TransformComponent>(id).children)
+			{
+				if (!IsIdValid(childId)) continue;
+
+				EntityId child = idToEntityMap.at(childId);
+				if (!transforms.contains(child) || transforms.get<TransformComponent>(child).parent != uuid) continue;
+
+				if (registry.get<HierarchyComponent>(child).parent == NullEntityId)
+					LinkChild(id, child);
+			}
+		}
+
+		// Entities missing from the children of their parent are appended to them
+		for (EntityId id : transforms)
+		{
+			UUID parentId = transforms.get<TransformComponent>(id).parent;
+			if (!IsIdValid(parentId) || registry.get<HierarchyComponent>(id).parent != NullEntityId) continue;
+
+			EntityId parent = idToEntityMap.at(parentId);
+			if (!transforms.contains(parent) || parent == id) continue;
+
+			LinkChild(parent, id);
+			transforms.get<TransformComponent>(parent).children.push_back(registry.get<IDComponent>(id).ID);
+		}
+
+		transformHierarchyDirty = true;
+	}
+
+	void Scene::LinkChild(EntityId parent, EntityId child)
+	{
+		UnlinkChild(child);
+
+		HierarchyComponent& parentHierarchy = registry.get<HierarchyComponent>(parent);
+		HierarchyComponent& childHierarchy = registry.get<HierarchyComponent>(child);
+
+		childHierarchy.parent = parent;
+		childHierarchy.previousSibling = parentHierarchy.lastChild;
+		childHierarchy.nextSibling = NullEntityId;
+
+		if (parentHierarchy.lastChild != NullEntityId)
+			registry.get<HierarchyComponent>(parentHierarchy.lastChild).nextSibling = child;
+		else
+			parentHierarchy.firstChild = child;
+
+		parentHierarchy.lastChild = child;
+		parentHierarchy.childCount++;
+
+		transformHierarchyDirty = true;
+	}
+
+	void Scene::UnlinkChild(EntityId child)
+	{
+		HierarchyComponent& childHierarchy = registry.get<HierarchyComponent>(child);
+		if (childHierarchy.parent == NullEntityId) return;
+
+		HierarchyComponent& parentHierarchy = registry.get<HierarchyComponent>(childHierarchy.parent);
+
+		if (childHierarchy.previousSibling != NullEntityId)
+			registry.get<HierarchyComponent>(childHierarchy.previousSibling).nextSibling = childHierarchy.nextSibling;
+		else
+			parentHierarchy.firstChild = childHierarchy.nextSibling;
+
+		if (childHierarchy.nextSibling != NullEntityId)
+			registry.get<HierarchyComponent>(childHierarchy.nextSibling).previousSibling = childHierarchy.previousSibling;
+		else
+			parentHierarchy.lastChild = childHierarchy.previousSibling;
+
+		parentHierarchy.childCount--;
+
+		childHierarchy.parent = NullEntityId;
+		childHierarchy.previousSibling = NullEntityId;
+		childHierarchy.nextSibling = NullEntityId;
+
+		transformHierarchyDirty = true;
+	}
+
+	void Scene::UpdateTransforms()
+	{
+		SD_PROFILE_FUNCTION();
+
+		auto transforms = registry.view<TransformComponent>();
+
+		if (transforms.size() != transformHierarchy.size())
+			transformHierarchyDirty = true;
+
+		if (transformHierarchyDirty)
+			BuildTransformHierarchy();
+
+		TransformBatch& batch = transformBatch;
+		batch.entities.clear();
+		batch.transforms.clear();
+		batch.parents.clear();
+		batch.positions.clear();
+		batch.rotations.clear();
+		batch.scales.clear();
+
+		// Unchanged entities only cost the comparison, the others are gathered in hierarchy order
+		for (TransformNode& node : transformHierarchy)
+		{
+			TransformComponent& transform = transforms.get<TransformComponent>(node.entity);
+
+			node.changed = transform.HasLocalChanged() || (node.parent >= 0 && transformHierarchy[node.parent].changed);
+			if (!node.changed) continue;
+
+			transform.cachedPosition = transform.position;
+			transform.cachedRotation = transform.rotation;
+			transform.cachedScale = transform.scale;
+			transform.cachedParent = transform.parent;
+			transform.cacheValid = true;
+
+			batch.entities.push_back(node.entity);
+			batch.transforms.push_back(&transform);
+			batch.parents.push_back(node.parent >= 0 ? &transforms.get<TransformComponent>(transformHierarchy[node.parent].entity) : nullptr);
+			batch.positions.push_back(transform.position);
+			batch.rotations.push_back(transform.rotation);
+			batch.scales.push_back(transform.scale);
+		}
+
+		size_t count = batch.transforms.size();
+		batch.localMatrices.resize(count);
+
+		ComposeTransforms(batch.positions.data(), batch.rotations.data(), batch.scales.data(), batch.localMatrices.data(), count);
+
+		// Parents come first, so their matrix is already up to date when a child reads it
+		for (size_t i = 0; i < count; i++)
+		{
+			if (batch.parents[i])
+				batch.transforms[i]->chachedWorldSpaceMatrix = MultiplyMatrix(batch.parents[i]->chachedWorldSpaceMatrix, batch.localMatrices[i]);
+			else
+				batch.transforms[i]->chachedWorldSpaceMatrix = batch.localMatrices[i];
+		}
+
+		if (count > 0)
+			GetChangeLog(typeid(TransformComponent).name()).Mark(batch.entities.data(), count, changeVersion);
+	}
+
+	void Scene::AdvanceChangeHistory()
+	{
+		frameChangeIndex = (frameChangeIndex + 1) % CHANGE_HISTORY_FRAMES;
+
+		uint32_t oldestVersion = frameChangeVersions[frameChangeIndex];
+		frameChangeVersions[frameChangeIndex] = CaptureChangeVersion();
+
+		if (oldestVersion == 0) return;
+
+		std::unique_lock<std::mutex> lock(componentChangesMutex);
+		for (auto& [typeName, log] : componentChanges)
+			log->Discard(oldestVersion);
+	}
+
+	ComponentChangeLog& Scene::GetChangeLog(const std::string& typeName)
+	{
+		std::unique_lock<std::mutex> lock(componentChangesMutex);
+
+		std::unique_ptr<ComponentChangeLog>& log = componentChanges[typeName];
+		if (!log) log = std::make_unique<ComponentChangeLog>();
+
+		return *log;
+	}
+
+	ComponentChangeLog* Scene::FindChangeLog(const std::string& typeName)
+	{
+		std::unique_lock<std::mutex> lock(componentChangesMutex);
+
+		auto it = componentChanges.find(typeName);
+		return it != componentChanges.end() ? it->second.get() : nullptr;
+	}
+
+	void Scene::BuildTransformHierarchy()
+	{
+		auto transforms = registry.view<TransformComponent>();
+
+		auto getParent = [&](EntityId id) -> EntityId
+		{
+			const HierarchyComponent* hierarchy = registry.try_get<HierarchyComponent>(id);
+			if (!hierarchy || hierarchy->parent == NullEntityId) return NullEntityId;
+
+			return transforms.contains(hierarchy->parent) ? hierarchy->parent : NullEntityId;
+		};
+
+		std::unordered_map<EntityId, int> depths;
+		depths.reserve(transforms.size());
+
+		std::vector<std::pair<int, EntityId>> sorted;
+		sorted.reserve(transforms.size());
+
+		std::vector<EntityId> chain;
+		for (EntityId id : transforms)
+		{
+			// Walk up until an entity with a known depth, then assign the depths on the way back down
+			chain.clear();
+			int depth = -1;
+
+			for (EntityId current = id; current != NullEntityId; current = getParent(current))
+			{
+				auto it = depths.find(current);
+				if (it != depths.end())
+				{
+					depth = it->second;
+					break;
+				}
+
+				// A cycle would never reach a root, cut it here
+				if (chain.size() > transforms.size()) break;
+
+				chain.push_back(current);
+			}
+
+			for (auto it = chain.rbegin(); it != chain.rend(); it++)
+				depths[*it] = ++depth;
+
+			sorted.emplace_back(depths[id], id);
+		}
+
+		std::stable_sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+		std::unordered_map<EntityId, int> indices;
+		indices.reserve(sorted.size());
+
+		for (int i = 0; i < sorted.size(); i++)
+			indices[sorted[i].second] = i;
+
+		transformHierarchy.clear();
+		transformHierarchy.reserve(sorted.size());
+
+		for (auto& [depth, id] : sorted)
+		{
+			TransformNode node;
+			node.entity = id;
+			node.parent = -1;
+			node.changed = false;
+
+			EntityId parent = getParent(id);
+			if (parent != NullEntityId && indices.at(parent) < indices.at(id))
+				node.parent = indices.at(parent);
+
+			transformHierarchy.push_back(node);
+		}
+
+		transformHierarchyDirty = false;
+	}
+
+	void Scene::BuildSystemSchedule()
+	{
+		struct Entry
+		{
+			System* system;
+			SystemMetaType metaType;
+			int registrationIndex;
+		};
+
+		Application* app = Application::Get();
+		std::vector<Entry> entries;
+
+		for (auto& [name, system] : systems)
+		{
+			Entry entry;
+			entry.system = system;
+			entry.registrationIndex = std::numeric_limits<int>::max();
+
+			// Unregistered systems keep the default metatype, which makes them exclusive
+			if (app->IsSystemRegistered(name))
+			{
+				entry.metaType = app->GetSystemMetaTypeByName(name);
+				entry.registrationIndex = app->registeredSystemsIndexToName.at(name);
+			}
+			else
+				entry.metaType.name = name;
+
+			// The transform pass run before the system reads the hierarchy and writes every transform
+			SystemMetaType& metaType = entry.metaType;
+			if (metaType.updateTransformsBefore)
+			{
+				metaType.readComponents.push_back(typeid(HierarchyComponent).name());
+				metaType.writtenComponents.push_back(typeid(TransformComponent).name());
+			}
+
+			entries.push_back(entry);
+		}
+
+		std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b)
+			{
+				if (a.metaType.executionOrder != b.metaType.executionOrder)
+					return a.metaType.executionOrder < b.metaType.executionOrder;
+
+				if (a.registrationIndex != b.registrationIndex)
+					return a.registrationIndex < b.registrationIndex;
+
+				return a.metaType.name < b.metaType.name;
+			}
+		);
+
+		systemSchedule.clear();
+		for (int i = 0; i < entries.size(); i++)
+		{
+			SystemNode node;
+			node.system = entries[i].system;
+			node.profileName = Profiler::InternName(entries[i].metaType.name);
+			node.mainThread = !entries[i].metaType.accessDeclared || entries[i].metaType.mainThreadOnly;
+			node.updateTransformsBefore = entries[i].metaType.updateTransformsBefore;
+			node.duration = 0;
+			node.commandSortKey = (uint64_t)(i + 1) << 40;
+			node.writtenComponents = entries[i].metaType.writtenComponents;
+
+			for (int j = 0; j < i; j++)
+				if (entries[i].metaType.ConflictsWith(entries[j].metaType))
+					node.dependencies.push_back(j);
+
+			systemSchedule.push_back(node);
+		}
+
+		// Timings of removed systems are dropped, the others keep their history
+		for (auto it = systemTimings.begin(); it != systemTimings.end();)
+		{
+			if (systems.count(it->first)) it++;
+			else it = systemTimings.erase(it);
+		}
+
+		systemScheduleDirty = false;
+	}
+
+	void Scene::UpdateSystems(float deltaTime)
+	{
+		CreateCommandBuffers();
+
+		// The first frame after a change runs serially, so that the groups and storages the systems
+		// create on first use are never created concurrently
+		if (systemScheduleDirty)
+		{
+			BuildSystemSchedule();
+
+			for (SystemNode& node : systemSchedule)
+				RunSystem(node, deltaTime);
+		}
+		else
+			UpdateSystemsParallel(deltaTime);
+
+		for (SystemNode& node : systemSchedule)
+			systemTimings[node.profileName].Push(node.duration);
+
+		MarkSystemWrites();
+	}
+
+	void Scene::MarkSystemWrites()
+	{
+		// Systems write components in place without marking them one by one, so the written types count as changed.
+		// Transforms are skipped, UpdateTransforms marks the ones that actually moved by comparing their values.
+		// Systems that don't declare their access have to mark what they change themselves
+		uint32_t version = changeVersion;
+		const char* transformName = typeid(TransformComponent).name();
+
+		for (SystemNode& node : systemSchedule)
+			for (const std::string& typeName : node.writtenComponents)
+				if (typeName != transformName)
+					GetChangeLog(typeName).MarkWritten(version, node.system);
+	}
+
+	void Scene::UpdateSystemsParallel(float deltaTime)
+	{
+		WorkManager& workManager = *GetWorkManager();
+
+		std::vector<JobHandle> handles(systemSchedule.size());
+		std::vector<bool> started(systemSchedule.size(), false);
+
+		// Worker systems are submitted as soon as every dependency is either submitted or, for main thread systems, done
+		auto submitReadySystems = [&]()
+		{
+			for (int i = 0; i < systemSchedule.size(); i++)
+			{
+				SystemNode& node = systemSchedule[i];
+				if (node.mainThread || started[i]) continue;
+
+				std::vector<JobHandle> dependencies;
+				bool ready = true;
+
+				for (int dependency : node.dependencies)
+				{
+					if (!started[dependency])
+					{
+						ready = false;
+						break;
+					}
+
+					dependencies.push_back(handles[dependency]);
+				}
+
+				if (!ready) continue;
+
+				SystemNode* nodePointer = &node;
+				handles[i] = workManager.Execute([this, nodePointer, deltaTime]() { RunSystem(*nodePointer, deltaTime); }, dependencies);
+				started[i] = true;
+			}
+		};
+
+		submitReadySystems();
+
+		for (int i = 0; i < systemSchedule.size(); i++)
+		{
+			SystemNode& node = systemSchedule[i];
+			if (!node.mainThread) continue;
+
+			for (int dependency : node.dependencies)
+				workManager.Wait(handles[dependency]);
+
+			RunSystem(node, deltaTime);
+			started[i] = true;
+
+			submitReadySystems();
+		}
+
+		workManager.Wait(handles);
+	}
+
+	void Scene::RunSystem(SystemNode& node, float deltaTime)
+	{
+		SD_PROFILE_ZONE(node.profileName);
+
+		using Clock = std::chrono::steady_clock;
+		Clock::time_point start = Clock::now();
+
+		// Marks the transforms moved by the systems that ran earlier in the frame
+		if (node.updateTransformsBefore)
+			UpdateTransforms();
+
+		SetCommandSortKey(node.commandSortKey);
+		runningSystem = node.system;
+
+		node.system->SysUpdate(deltaTime);
+
+		runningSystem = nullptr;
+		SetCommandSortKey(0);
+
+		node.duration = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+	}
+
+	CommandBuffer& Scene::GetCommandBuffer()
+	{
+		CreateCommandBuffers();
+
+		int index = WorkManager::GetCurrentThreadIndex();
+		SD_ASSERT(index < commandBuffers.size(), "Command buffers are created by Init, Update or a parallel iteration of the scene");
+
+		return *commandBuffers[index];
+	}
+
+	void Scene::PlaybackCommands()
+	{
+		struct Entry
+		{
+			uint64_t sortKey;
+			int buffer;
+			uint32_t sequence;
+			InlineTask* execute;
+		};
+
+		std::vector<Entry> entries;
+		for (int i = 0; i < commandBuffers.size(); i++)
+			for (CommandBuffer::Command& command : commandBuffers[i]->commands)
+				entries.push_back({ command.sortKey, i, command.sequence, &command.execute });
+
+		if (entries.empty()) return;
+
+		std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b)
+			{
+				if (a.sortKey != b.sortKey) return a.sortKey < b.sortKey;
+				if (a.buffer != b.buffer) return a.buffer < b.buffer;
+
+				return a.sequence < b.sequence;
+			}
+		);
+
+		deferComponentCallbacks = true;
+
+		for (Entry& entry : entries)
+			(*entry.execute)();
+
+		deferComponentCallbacks = false;
+
+		for (std::unique_ptr<CommandBuffer>& buffer : commandBuffers)
+		{
+			buffer->commands.clear();
+			buffer->createdEntities.clear();
+		}
+
+		CallDeferredAddedCallbacks();
+	}
+
+	void Scene::CreateCommandBuffers()
+	{
+		// Workers only read the vector, it grows on the main thread before any job that could record is scheduled
+		if (!GetWorkManager()->IsMainThread()) return;
+
+		size_t count = GetWorkManager()->GetThreadCount();
+
+		while (commandBuffers.size() < count)
+			commandBuffers.push_back(std::make_unique<CommandBuffer>(this));
+	}
+
+	std::vector<EntityId>& Scene::GetDeferredAddedCallbacks(const std::string& typeName)
+	{
+		for (auto& [name, entities] : deferredAddedCallbacks)
+			if (name == typeName)
+				return entities;
+
+		deferredAddedCallbacks.push_back({ typeName, {} });
+		return deferredAddedCallbacks.back().second;
+	}
+
+	bool Scene::CancelDeferredAddedCallback(const std::string& typeName, EntityId id)
+	{
+		std::vector<EntityId>& entities = GetDeferredAddedCallbacks(typeName);
+
+		auto it = std::find(entities.begin(), entities.end(), id);
+		if (it == entities.end()) return false;
+
+		entities.erase(it);
+		return true;
+	}
+
+	void Scene::CallDeferredAddedCallbacks()
+	{
+		// Callbacks may add components themselves, those are announced right away
+		std::vector<std::pair<std::string, std::vector<EntityId>>> deferred;
+		deferred.swap(deferredAddedCallbacks);
+
+		for (auto& [typeName, entities] : deferred)
+		{
+			std::vector<ComponentCallback>& callbacks = componentAddedCallbacks[typeName];
+
+			for (EntityId id : entities)
+			{
+				if (!registry.valid(id)) continue;
+
+				for (auto& callback : callbacks)
+					callback(id);
+			}
+		}
+	}
+
+	const System* Scene::GetRunningSystem()
+	{
+		return runningSystem;
+	}
+
+	uint64_t Scene::GetCommandSortKey()
+	{
+		return CommandBuffer::currentSortKey;
+	}
+
+	void Scene::SetCommandSortKey(uint64_t sortKey)
+	{
+		CommandBuffer::currentSortKey = sortKey;
+	}
+
+	WorkManager* Scene::GetWorkManager()
+	{
+		return Application::Get()->GetWorkManager();
 	}
 
 	Entity Scene::GetEntityByEntityId(EntityId id)
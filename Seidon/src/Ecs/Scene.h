@@ -1,23 +1,36 @@
 #pragma once
 
 #include "Core/Asset.h"
+#include "Core/WorkManager.h"
 #include "EnttWrappers.h"
+#include "ComponentChangeLog.h"
+#include "SceneSnapshot.h"
 #include "System.h"
+#include "../Debug/TimingHistory.h"
 
 #include <unordered_map>
+#include <map>
 #include <string>
 #include <typeinfo>
 #include <iostream>
 #include <functional>
+#include <algorithm>
+#include <tuple>
+#include <atomic>
+#include <mutex>
+#include <memory>
 
 #include <entt/entt.hpp>
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 
 namespace Seidon
 {
 	class Entity;
 	class Prefab;
+	class CommandBuffer;
+	struct TransformComponent;
 
 	typedef std::function<void(EntityId)> ComponentCallback;
 	typedef std::vector<ComponentCallback>::iterator ComponentCallbackId;
@@ -35,23 +48,71 @@ namespace Seidon
 		using Asset::Save;
 		using Asset::Load;
 
-		void Save(std::ofstream& out);
-		void Load(std::ifstream& in);
+		void Save(BinaryWriter& out);
+		void Load(BinaryReader& in);
+
+		// Maps the file, the component columns are decoded in parallel straight from it
+		void Load(const std::string& path) override;
 
 		Scene* Duplicate();
 		void CopyEntities(Scene* other);
 		void CopySystems(Scene* other);
 
+		// Captures the entities and components of the scene. With a baseline, the component types that didn't change
+		// since it was taken share its columns instead of being copied again
+		SceneSnapshot Snapshot(const SceneSnapshot* baseline = nullptr);
+
+		// Brings the scene back to a snapshot. While the entities are the same only the component types that changed
+		// since the snapshot are rewritten, removal and addition callbacks are called for the rewritten components
+		void Restore(const SceneSnapshot& snapshot);
+
 		Entity CreateEntity(const std::string& name = std::string(), const UUID& id = UUID());
 		Entity InstantiatePrefab(Prefab& prefab, const std::string& name = "");
-		Entity InstantiatePrefab(Prefab& prefab, const glm::vec3& position, const glm::vec3& rotation,
+		Entity InstantiatePrefab(Prefab& prefab, const glm::vec3& position, const glm::quat& rotation,
 			const glm::vec3& scale, const std::string& name = "");
 
+		// Instantiates count copies of the prefab and returns their roots. The root of instance i takes the position,
+		// rotation and scale of transforms[i], or keeps the prefab's ones when transforms is null. Components are copied
+		// one type at a time and the added callbacks run once every instance is complete
+		std::vector<Entity> InstantiatePrefab(Prefab& prefab, const TransformComponent* transforms, size_t count);
+
+		// Deactivates or reactivates the entity and the entities currently under it, see InactiveComponent
+		void SetEntityActive(EntityId id, bool active);
+		bool IsEntityActive(EntityId id);
+
 		Entity GetEntityByEntityId(EntityId id);
 		Entity GetEntityById(UUID id);
 
 		void DestroyEntity(Entity& entity);
 
+		// Rebuilds the HierarchyComponent links of every entity from the parent and children ids of the transforms
+		void RebuildHierarchy();
+
+		// Recomputes the world matrices of the transforms that changed since the last call, and of their descendants.
+		// Runs at the start of every Update, call it again after moving entities to refresh the cached matrices
+		void UpdateTransforms();
+
+		/*
+		* Change tracking: components changed through Entity::AddComponent, Entity::EditComponent, the entity
+		* overloads of ComponentMetaType or MarkComponentChanged are stamped with the current change version.
+		* TransformComponent is also marked by UpdateTransforms whenever its world matrix changes.
+		* A system keeps the value returned by CaptureChangeVersion and, on its next run, captures again and
+		* visits with IterateChanged only the components changed after the previous value.
+		*/
+		inline uint32_t CaptureChangeVersion() { return changeVersion++; }
+
+		// Discards the changes older than CHANGE_HISTORY_FRAMES frames. Update calls it, call it once per frame
+		// when updating systems without Update
+		void AdvanceChangeHistory();
+
+		// Buffer of the calling thread, for structural changes requested from jobs. Workers can record after Init,
+		// during Update or from a parallel iteration of the scene
+		CommandBuffer& GetCommandBuffer();
+
+		// Applies the commands of every thread's buffer, component added callbacks are called afterwards grouped by type.
+		// Update calls it once every system is done
+		void PlaybackCommands();
+
 		inline bool IsEntityIdValid(EntityId id) { return registry.valid(id); }
 		inline bool IsIdValid(UUID id) { return idToEntityMap.count(id); }
 		
@@ -62,10 +123,13 @@ namespace Seidon
 
 		inline const std::string& GetName() { return name; }
 
-		template <typename... OwnedTypes, typename... ObservedTypes>
-		auto CreateComponentGroup(TypeList<ObservedTypes...> observedTypes = {})
+		// Milliseconds spent in each system's update over the last frames, by system name
+		inline const std::map<std::string, TimingHistory>& GetSystemTimings() { return systemTimings; }
+
+		template <typename... OwnedTypes, typename... ObservedTypes, typename... ExcludedTypes>
+		auto CreateComponentGroup(TypeList<ObservedTypes...> observedTypes = {}, ExcludeList<ExcludedTypes...> excludedTypes = {})
 		{
-			return registry.group<OwnedTypes...>(observedTypes);
+			return registry.group<OwnedTypes...>(observedTypes, excludedTypes);
 		}
 
 		template <typename Type>
@@ -102,12 +166,55 @@ namespace Seidon
 			v.each(function);
 		}
 
+		// Parallel variants split the entities in chunks of roughly PARALLEL_CHUNK_BYTES of component data
+		// and run them on the WorkManager threads. The calling thread takes part and returns once every chunk is done
+		template <typename Type, typename Func>
+		void ParallelIterate(const ComponentView<Type>& view, const Func& function, size_t chunkSize = 0)
+		{
+			ParallelIterateRange(view, chunkSize, [&](EntityId id, auto&... components) { function(id, components...); });
+		}
+
+		template <typename... Types, typename Func>
+		void ParallelIterate(const ComponentGroup<Types...>& group, const Func& function, size_t chunkSize = 0)
+		{
+			ParallelIterateRange(group, chunkSize, [&](EntityId id, auto&... components) { function(id, components...); });
+		}
+
+		template <typename Scratch, typename Type, typename Func>
+		void ParallelIterate(const ComponentView<Type>& view, ThreadScratch<Scratch>& scratch, const Func& function, size_t chunkSize = 0)
+		{
+			ParallelIterateRange(view, chunkSize, [&](EntityId id, auto&... components) { function(scratch.Local(), id, components...); });
+		}
+
+		template <typename Scratch, typename... Types, typename Func>
+		void ParallelIterate(const ComponentGroup<Types...>& group, ThreadScratch<Scratch>& scratch, const Func& function, size_t chunkSize = 0)
+		{
+			ParallelIterateRange(group, chunkSize, [&](EntityId id, auto&... components) { function(scratch.Local(), id, components...); });
+		}
+
+		template <typename... OwnedTypes, typename... ObservedTypes, typename Func>
+		void CreateGroupAndParallelIterate(TypeList<ObservedTypes...> observedTypes, const Func& function, size_t chunkSize = 0)
+		{
+			auto g = registry.group<OwnedTypes...>(observedTypes);
+
+			ParallelIterate(g, function, chunkSize);
+		}
+
+		template <typename Type, typename Func>
+		void CreateViewAndParallelIterate(const Func& function, size_t chunkSize = 0)
+		{
+			auto v = registry.view<Type>();
+
+			ParallelIterate(v, function, chunkSize);
+		}
+
 		template <typename T, typename... Args>
 		T& AddSystem(Args&&... args)
 		{
 			systems[typeid(T).name()] = new T(std::forward<Args>(args)...);
 			systems[typeid(T).name()]->scene = this;
 			systems[typeid(T).name()]->SysInit();
+			systemScheduleDirty = true;
 			return *((T*)systems[typeid(T).name()]);
 		}
 
@@ -129,6 +236,205 @@ namespace Seidon
 			systems[typeid(T).name()]->SysDestroy();
 			delete systems[typeid(T).name()];
 			systems.erase(typeid(T).name());
+			systemScheduleDirty = true;
+		}
+
+		template <typename T>
+		void MarkComponentChanged(EntityId id)
+		{
+			GetChangeLog(typeid(T).name()).Mark(id, changeVersion);
+		}
+
+		// 0 if the component didn't change in the last CHANGE_HISTORY_FRAMES frames
+		template <typename T>
+		uint32_t GetComponentVersion(EntityId id)
+		{
+			ComponentChangeLog* log = FindChangeLog(typeid(T).name());
+
+			return log ? log->GetVersion(id) : 0;
+		}
+
+		// Visits the components changed after sinceVersion, or all of them when that's older than the change history
+		// or when another system may have written them in place since then
+		template <typename T, typename Func>
+		void IterateChanged(uint32_t sinceVersion, const Func& function)
+		{
+			ComponentChangeLog* log = FindChangeLog(typeid(T).name());
+
+			if (log && (!log->IsComplete(sinceVersion) || log->WasWrittenAfter(sinceVersion, GetRunningSystem())))
+			{
+				registry.view<T>().each(function);
+				return;
+			}
+
+			if (!log) return;
+
+			log->ForEachChanged(sinceVersion, [&](EntityId id)
+				{
+					if (registry.valid(id) && registry.all_of<T>(id))
+						function(id, registry.get<T>(id));
+				}
+			);
+		}
+
+		// Copies every T of this scene to the entities of other given by entityMap, indexed by entity index.
+		// Added callbacks are called once every component is copied
+		template <typename T>
+		void CopyComponentsTo(Scene& other, const std::vector<EntityId>& entityMap)
+		{
+			auto view = registry.view<T>();
+			if (view.empty()) return;
+
+			std::vector<EntityId> copies;
+			copies.reserve(view.size());
+
+			other.registry.reserve<T>(other.registry.view<T>().size() + view.size());
+
+			for (EntityId id : view)
+			{
+				size_t index = entt::to_entity(id);
+				if (index >= entityMap.size() || entityMap[index] == NullEntityId) continue;
+
+				EntityId copy = entityMap[index];
+
+				if constexpr (std::is_empty_v<T>)
+					other.registry.emplace_or_replace<T>(copy);
+				else
+					other.registry.emplace_or_replace<T>(copy, view.template get<T>(id));
+
+				copies.push_back(copy);
+			}
+
+			if (copies.empty()) return;
+
+			other.GetChangeLog(typeid(T).name()).Mark(copies.data(), copies.size(), other.changeVersion);
+			other.OnComponentsAdded<T>(copies);
+		}
+
+		// Gives every instance a copy of the components of the prefab entities. instances holds prefabEntities.size()
+		// entities per instance, in the same order as prefabEntities
+		template <typename T>
+		void InstantiateComponents(Scene& prefabScene, const std::vector<EntityId>& prefabEntities, const std::vector<EntityId>& instances)
+		{
+			auto view = prefabScene.registry.view<T>();
+			if (view.empty()) return;
+
+			size_t nodeCount = prefabEntities.size();
+			size_t instanceCount = instances.size() / nodeCount;
+
+			std::vector<size_t> nodes;
+			for (size_t i = 0; i < nodeCount; i++)
+				if (view.contains(prefabEntities[i]))
+					nodes.push_back(i);
+
+			if (nodes.empty()) return;
+
+			registry.reserve<T>(registry.view<T>().size() + nodes.size() * instanceCount);
+
+			// One insertion per prefab entity, each copies the same component into every instance
+			std::vector<EntityId> targets(instanceCount);
+			std::vector<EntityId> added;
+			added.reserve(nodes.size() * instanceCount);
+
+			for (size_t node : nodes)
+			{
+				for (size_t i = 0; i < instanceCount; i++)
+					targets[i] = instances[i * nodeCount + node];
+
+				if constexpr (std::is_empty_v<T>)
+					registry.insert<T>(targets.begin(), targets.end());
+				else
+					registry.insert<T>(targets.begin(), targets.end(), view.template get<T>(prefabEntities[node]));
+
+				added.insert(added.end(), targets.begin(), targets.end());
+			}
+
+			GetChangeLog(typeid(T).name()).Mark(added.data(), added.size(), changeVersion);
+			OnComponentsAdded<T>(added);
+		}
+
+		template <typename T>
+		std::shared_ptr<const ComponentColumn> SnapshotComponents()
+		{
+			auto view = registry.view<T>();
+			if (view.empty()) return nullptr;
+
+			std::shared_ptr<TypedComponentColumn<T>> column = std::make_shared<TypedComponentColumn<T>>();
+			column->entities.assign(view.begin(), view.end());
+
+			if constexpr (!std::is_empty_v<T>)
+			{
+				column->components.reserve(view.size());
+
+				for (EntityId id : view)
+					column->components.push_back(view.template get<T>(id));
+			}
+
+			return column;
+		}
+
+		// Removes every T, calling the removed callbacks first
+		template <typename T>
+		void ClearComponents()
+		{
+			auto view = registry.view<T>();
+			if (view.empty()) return;
+
+			std::vector<EntityId> entities(view.begin(), view.end());
+
+			for (auto& callback : componentRemovedCallbacks[typeid(T).name()])
+				for (EntityId id : entities)
+					callback(id);
+
+			registry.clear<T>();
+		}
+
+		// Adds the components of column to the entities it was taken from, none of them may already have a T
+		template <typename T>
+		void RestoreComponents(const ComponentColumn& column)
+		{
+			const TypedComponentColumn<T>& typedColumn = static_cast<const TypedComponentColumn<T>&>(column);
+			const std::vector<EntityId>& entities = typedColumn.entities;
+
+			if constexpr (std::is_empty_v<T>)
+				registry.insert<T>(entities.begin(), entities.end());
+			else
+				registry.insert<T>(entities.begin(), entities.end(), typedColumn.components.begin());
+
+			GetChangeLog(typeid(T).name()).Mark(entities.data(), entities.size(), changeVersion);
+			OnComponentsAdded<T>(entities);
+		}
+
+		// Every T along with the entity it belongs to, components are null for empty types
+		template <typename T>
+		void GetComponents(std::vector<EntityId>& entities, std::vector<void*>& components)
+		{
+			auto view = registry.view<T>();
+
+			entities.assign(view.begin(), view.end());
+			components.assign(entities.size(), nullptr);
+
+			if constexpr (!std::is_empty_v<T>)
+				for (size_t i = 0; i < entities.size(); i++)
+					components[i] = &view.template get<T>(entities[i]);
+		}
+
+		// Moves the components of column into the entities it holds, none of them may already have a T
+		template <typename T>
+		void InsertComponents(ComponentColumn& column)
+		{
+			TypedComponentColumn<T>& typedColumn = static_cast<TypedComponentColumn<T>&>(column);
+			const std::vector<EntityId>& entities = typedColumn.entities;
+
+			if (entities.empty()) return;
+
+			if constexpr (std::is_empty_v<T>)
+				registry.insert<T>(entities.begin(), entities.end());
+			else
+				registry.insert<T>(entities.begin(), entities.end(), std::make_move_iterator(typedColumn.components.begin()));
+
+			GetChangeLog(typeid(T).name()).Mark(entities.data(), entities.size(), changeVersion);
+			OnComponentsAdded<T>(entities);
 		}
 
 		template <typename T>
@@ -160,31 +466,211 @@ namespace Seidon
 		}
 
 		private:
+			// Saved after the id by the columnar format, where v1 files have the length of the name
+			static constexpr uint64_t SCENE_MAGIC = 0x3243534453; // "SDSC2"
+			static constexpr uint32_t SCENE_VERSION = 3;
+
+			// Components per column chunk, chunks are the unit of parallel decoding
+			static constexpr size_t COLUMN_CHUNK_SIZE = 4096;
+
+			static constexpr size_t PARALLEL_CHUNK_BYTES = 16 * 1024;
+			static constexpr size_t MIN_PARALLEL_CHUNK_SIZE = 64;
+
 			entt::registry registry;
 
 			std::unordered_map<UUID, EntityId> idToEntityMap;
 
 			std::unordered_map<std::string, System*> systems;
 
+			struct SystemNode
+			{
+				System* system;
+				const char* profileName;
+				bool mainThread;
+				bool updateTransformsBefore;
+
+				// Components the system may write in place
+				std::vector<std::string> writtenComponents;
+
+				// Commands recorded by the system are played back in schedule order
+				uint64_t commandSortKey;
+				std::vector<int> dependencies;
+
+				// Written by whichever thread runs the system, read once every system is done
+				float duration;
+			};
+
+			// Systems sorted in execution order, each node depends on the earlier nodes it conflicts with
+			std::vector<SystemNode> systemSchedule;
+			bool systemScheduleDirty = true;
+
+			std::map<std::string, TimingHistory> systemTimings;
+
+			struct TransformNode
+			{
+				EntityId entity;
+				int parent;
+				bool changed;
+			};
+
+			// Every entity with a transform, sorted by depth so that parents are always updated before their children
+			std::vector<TransformNode> transformHierarchy;
+			bool transformHierarchyDirty = true;
+
+			// Scratch of UpdateTransforms, the local matrices of the changed transforms are composed in one batch
+			struct TransformBatch
+			{
+				std::vector<EntityId> entities;
+				std::vector<TransformComponent*> transforms;
+				std::vector<const TransformComponent*> parents;
+				std::vector<glm::vec3> positions;
+				std::vector<glm::quat> rotations;
+				std::vector<glm::vec3> scales;
+				std::vector<glm::mat4> localMatrices;
+			};
+
+			TransformBatch transformBatch;
+
+			static constexpr int CHANGE_HISTORY_FRAMES = 16;
+
+			std::atomic<uint32_t> changeVersion{ 1 };
+
+			// Change version at the start of each of the last frames, as a ring buffer
+			uint32_t frameChangeVersions[CHANGE_HISTORY_FRAMES] = {};
+			int frameChangeIndex = 0;
+
+			// By component type name, logs are created on the first change and never removed
+			std::unordered_map<std::string, std::unique_ptr<ComponentChangeLog>> componentChanges;
+			std::mutex componentChangesMutex;
+
 			std::unordered_map<std::string, std::vector<ComponentCallback>> componentAddedCallbacks;
 			std::unordered_map<std::string, std::vector<ComponentCallback>> componentRemovedCallbacks;
 
+			// By thread index, see WorkManager::GetCurrentThreadIndex
+			std::vector<std::unique_ptr<CommandBuffer>> commandBuffers;
+
+			// While playing back commands, added callbacks are collected by component type and called at the end
+			bool deferComponentCallbacks = false;
+			std::vector<std::pair<std::string, std::vector<EntityId>>> deferredAddedCallbacks;
+
 		private:
 			template <typename T>
 			void OnComponentAdded(EntityId entityId)
 			{
+				if (deferComponentCallbacks)
+				{
+					GetDeferredAddedCallbacks(typeid(T).name()).push_back(entityId);
+					return;
+				}
+
 				for(auto& callback : componentAddedCallbacks[typeid(T).name()])
 					callback(entityId);
 			}
 
+			template <typename T>
+			void OnComponentsAdded(const std::vector<EntityId>& entityIds)
+			{
+				if (deferComponentCallbacks)
+				{
+					std::vector<EntityId>& deferred = GetDeferredAddedCallbacks(typeid(T).name());
+					deferred.insert(deferred.end(), entityIds.begin(), entityIds.end());
+					return;
+				}
+
+				for (auto& callback : componentAddedCallbacks[typeid(T).name()])
+					for (EntityId id : entityIds)
+						callback(id);
+			}
+
 			template <typename T>
 			void OnComponentRemoved(EntityId entityId)
 			{
+				// Components added and removed during the same playback were never announced, nor is their removal
+				if (deferComponentCallbacks && CancelDeferredAddedCallback(typeid(T).name(), entityId)) return;
+
 				for (auto& callback : componentRemovedCallbacks[typeid(T).name()])
 					callback(entityId);
 			}
 
-			void AddChildEntityFromPrefab(Entity parentEntity, Entity prefabEntity);
+			template <typename Tuple, size_t... Indices>
+			static constexpr size_t GetComponentsSize(std::index_sequence<Indices...>)
+			{
+				return (sizeof(EntityId) + ... + sizeof(std::decay_t<std::tuple_element_t<Indices, Tuple>>));
+			}
+
+			template <typename Range, typename Func>
+			void ParallelIterateRange(const Range& range, size_t chunkSize, const Func& function)
+			{
+				using ComponentsTuple = decltype(range.get(std::declval<EntityId>()));
+
+				if (chunkSize == 0)
+				{
+					size_t entitySize = GetComponentsSize<ComponentsTuple>(std::make_index_sequence<std::tuple_size_v<ComponentsTuple>>{});
+					chunkSize = std::max(PARALLEL_CHUNK_BYTES / entitySize, MIN_PARALLEL_CHUNK_SIZE);
+				}
+
+				auto first = range.begin();
+
+				// Each item records its commands with its own sort key, whichever thread runs it
+				uint64_t sortKey = GetCommandSortKey();
+				CreateCommandBuffers();
+
+				GetWorkManager()->ParallelFor(range.size(), chunkSize, [&](size_t begin, size_t end)
+					{
+						uint64_t previousSortKey = GetCommandSortKey();
+
+						for (size_t i = begin; i < end; i++)
+						{
+							SetCommandSortKey(sortKey + i + 1);
+
+							EntityId id = *(first + i);
+							std::apply([&](auto&... components) { function(id, components...); }, range.get(id));
+						}
+
+						SetCommandSortKey(previousSortKey);
+					}
+				);
+
+				// Commands recorded after the loop are played back after the ones of its items
+				SetCommandSortKey(sortKey + range.size() + 1);
+			}
+
+			WorkManager* GetWorkManager();
+
+			void LoadV1(BinaryReader& in, size_t nameLength);
+			void LoadColumnar(BinaryReader& in);
+			void SaveSystems(BinaryWriter& out);
+			void LoadSystems(BinaryReader& in);
+
+			void CreateCommandBuffers();
+			std::vector<EntityId>& GetDeferredAddedCallbacks(const std::string& typeName);
+			bool CancelDeferredAddedCallback(const std::string& typeName, EntityId id);
+			void CallDeferredAddedCallbacks();
+
+			// System being updated by the calling thread, null outside of RunSystem
+			static const System* GetRunningSystem();
+
+			static uint64_t GetCommandSortKey();
+			static void SetCommandSortKey(uint64_t sortKey);
+
+			ComponentChangeLog& GetChangeLog(const std::string& typeName);
+			ComponentChangeLog* FindChangeLog(const std::string& typeName);
+
+			bool HasComponentTypeChanged(const std::string& typeName, uint32_t sinceVersion);
+			bool HasSameEntities(const SceneSnapshot& snapshot);
+			void MarkSystemWrites();
+
+			// Appends child to the children of parent, removing it from its previous parent first
+			void LinkChild(EntityId parent, EntityId child);
+			void UnlinkChild(EntityId child);
+
+			void BuildTransformHierarchy();
+
+			void BuildSystemSchedule();
+			void RunSystem(SystemNode& node, float deltaTime);
+			void UpdateSystems(float deltaTime);
+			void UpdateSystemsParallel(float deltaTime);
+
 			friend class Entity;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+#include "EnttWrappers.h"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+
+namespace Seidon
+{
+	// Copy of every component of one type, along with the entities they belong to
+	struct ComponentColumn
+	{
+		std::vector<EntityId> entities;
+
+		virtual ~ComponentColumn() = default;
+	};
+
+	template <typename T>
+	struct TypedComponentColumn : public ComponentColumn
+	{
+		// Empty for empty types, only the entities matter
+		std::vector<T> components;
+	};
+
+	/*
+	* State of a scene captured by Scene::Snapshot and brought back by Scene::Restore. Columns never change
+	* once captured, so snapshots share the columns of the component types that didn't change between them.
+	*/
+	struct SceneSnapshot
+	{
+		uint32_t changeVersion = 0;
+
+		// The whole entity array of the registry, including the free list, so that ids are restored as they were
+		std::vector<EntityId> entities;
+		EntityId released = NullEntityId;
+
+		// By component type name, types without components have no column
+		std::unordered_map<std::string, std::shared_ptr<const ComponentColumn>> columns;
+	};
+}
\ No newline at end of file
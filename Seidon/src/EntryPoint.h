@@ -11,6 +11,7 @@ extern Seidon::Application* Seidon::CreateApplication();
 int main(int argc, char** argv) 
 {
 	Seidon::Application* app = Seidon::CreateApplication();
+	app->SetArguments(argc, argv);
 	app->AppInit();
 
 	while (!app->GetWindow()->ShouldClose())
@@ -14,8 +14,8 @@ namespace Seidon
 	public:
 		void Destroy();
 
-		void Save(std::ofstream& out) {}
-		void Load(std::ifstream& in)  {}
+		void Save(BinaryWriter& out) {}
+		void Load(BinaryReader& in)  {}
 
 		void Save(const std::string& path) {}
 		void Load(const std::string& path);
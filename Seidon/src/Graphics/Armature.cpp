@@ -1,7 +1,6 @@
 #include "Armature.h"
 
 #include <iostream>
-#include <fstream>
 
 namespace Seidon
 {
@@ -11,58 +10,38 @@ namespace Seidon
 
     }
 
-	void Armature::Save(std::ofstream& out)
+	void Armature::Save(BinaryWriter& out)
 	{
-        out.write((char*)&id, sizeof(id));
+        out.Write(id);
+        out.WriteString(name);
 
-        size_t size = name.length() + 1;
-        out.write((char*)&size, sizeof(size_t));
-
-        out.write(name.c_str(), size * sizeof(char));
-
-        size = bones.size();
-        out.write((char*)&size, sizeof(size_t));
+        out.Write(bones.size());
 
         for (BoneData& bone : bones)
         {
-            size = bone.name.length() + 1;
-            out.write((char*)&size, sizeof(size_t));
-            out.write(bone.name.c_str(), size * sizeof(char));
+            out.WriteString(bone.name);
 
-            out.write((char*)&bone.id, sizeof(bone.id));
-            out.write((char*)&bone.parentId, sizeof(bone.parentId));
-            out.write((char*)&bone.inverseBindPoseMatrix, sizeof(bone.inverseBindPoseMatrix));
+            out.Write(bone.id);
+            out.Write(bone.parentId);
+            out.Write(bone.inverseBindPoseMatrix);
         }
 	}
 
-    void Armature::Load(std::ifstream& in)
+    void Armature::Load(BinaryReader& in)
     {
-        char buffer[2048];
-        in.read((char*)&id, sizeof(id));
+        in.Read(id);
+        in.ReadString(name);
 
-        size_t size = 0;
-        in.read((char*)&size, sizeof(size_t));
+        // Each bone takes at least its name length, ids and matrix
+        bones.resize(in.ReadCount(sizeof(size_t) + 2 * sizeof(int) + sizeof(glm::mat4)));
 
-        in.read(buffer, size * sizeof(char));
-        name = buffer;
-
-        in.read((char*)&size, sizeof(size_t));
-        bones.resize(size);
-        for (int i = 0; i < size; i++)
+        for (BoneData& bone : bones)
         {
-            BoneData bone;
-
-            size_t size2 = 0;
-
-            in.read((char*)&size2, sizeof(size_t));
-            in.read(buffer, size2 * sizeof(char));
-            bone.name = buffer;
-
-            in.read((char*)&bone.id, sizeof(bone.id));
-            in.read((char*)&bone.parentId, sizeof(bone.parentId));
-            in.read((char*)&bone.inverseBindPoseMatrix, sizeof(bone.inverseBindPoseMatrix));
+            in.ReadString(bone.name);
 
-            bones[i] = bone;
+            in.Read(bone.id);
+            in.Read(bone.parentId);
+            in.Read(bone.inverseBindPoseMatrix);
         }
     }
 }
\ No newline at end of file
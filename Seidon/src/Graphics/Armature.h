@@ -1,5 +1,7 @@
 #pragma once
 #include "../Core/UUID.h"
+#include "../Utils/BinaryReader.h"
+#include "../Utils/BinaryWriter.h"
 
 #include <glm/glm.hpp>
 
@@ -32,9 +34,7 @@ namespace Seidon
 
 		Armature(UUID id = UUID());
 
-		void Save(std::ofstream& out);
-		void SaveAsync(std::ofstream& out);
-		void Load(std::ifstream& in);
-		void LoadAsync(std::ifstream& in);
+		void Save(BinaryWriter& out);
+		void Load(BinaryReader& in);
 	};
 }
\ No newline at end of file
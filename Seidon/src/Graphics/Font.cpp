@@ -37,67 +37,49 @@ namespace Seidon
         return glyphs[c1].advance + kerning;
     }
 
-	void Font::Save(std::ofstream& out)
+	void Font::Save(BinaryWriter& out)
 	{
-        out.write((char*)&id, sizeof(UUID));
+        out.Write(id);
+        out.WriteString(name);
 
-        size_t size = name.length() + 1;
-        out.write((char*)&size, sizeof(size_t));
-
-        out.write(name.c_str(), size * sizeof(char));
-
-        size = glyphs.size();
-        out.write((char*)&size, sizeof(size_t));
+        out.Write(glyphs.size());
         for (auto& [character, glyph] : glyphs)
         {
-            out.write((char*)&character, sizeof(char32_t));
-            out.write((char*)&glyph, sizeof(Glyph));
+            out.Write(character);
+            out.Write(glyph);
         }
 
-        size = kernings.size();
-        out.write((char*)&size, sizeof(size_t));
+        out.Write(kernings.size());
         for (auto& [pair, kerning] : kernings)
         {
-            out.write((char*)&pair, sizeof(pair));
-            out.write((char*)&kerning, sizeof(float));
+            out.Write(pair.first);
+            out.Write(pair.second);
+            out.Write(kerning);
         }
 
         fontAtlas->Save(out);
 	}
 
-	void Font::Load(std::ifstream& in)
+	void Font::Load(BinaryReader& in)
 	{
-        in.read((char*)&id, sizeof(UUID));
-
-        size_t size = 0;
-        in.read((char*)&size, sizeof(size_t));
-
-        char buffer[2048];
-        in.read(buffer, size * sizeof(char));
-        name = buffer;
+        in.Read(id);
+        in.ReadString(name);
 
-        in.read((char*)&size, sizeof(size_t));
-
-        Glyph glyph;
-        char32_t character;
-        for (int i = 0; i < size; i++)
+        size_t size = in.ReadCount(sizeof(char32_t) + sizeof(Glyph));
+        for (size_t i = 0; i < size; i++)
         {
-            in.read((char*)&character, sizeof(char32_t));
-            in.read((char*)&glyph, sizeof(Glyph));
-
-            glyphs[character] = glyph;
+            char32_t character = in.Read<char32_t>();
+            in.Read(glyphs[character]);
         }
 
-        in.read((char*)&size, sizeof(size_t));
-
-        std::pair<char32_t, char32_t> pair;
-        float kerning;
-        for (int i = 0; i < size; i++)
+        size = in.ReadCount(2 * sizeof(char32_t) + sizeof(float));
+        for (size_t i = 0; i < size; i++)
         {
-            in.read((char*)&pair, sizeof(pair));
-            in.read((char*)&kerning, sizeof(float));
+            std::pair<char32_t, char32_t> pair;
+            in.Read(pair.first);
+            in.Read(pair.second);
 
-            kernings[pair] = kerning;
+            in.Read(kernings[pair]);
         }
 
         fontAtlas->Load(in);
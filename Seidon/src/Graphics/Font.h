@@ -49,8 +49,8 @@ namespace Seidon
 		using Asset::Save;
 		using Asset::Load;
 
-		void Save(std::ofstream& out);
-		void Load(std::ifstream& in);
+		void Save(BinaryWriter& out);
+		void Load(BinaryReader& in);
 
 		bool Import(const std::string& path);
 	private:
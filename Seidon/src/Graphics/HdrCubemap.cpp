@@ -6,7 +6,6 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
-#include <fstream>
 
 namespace Seidon
 {
@@ -40,15 +39,12 @@ namespace Seidon
         initialized = false;
     }
 
-    void HdrCubemap::Save(std::ofstream& out)
+    void HdrCubemap::Save(BinaryWriter& out)
     {
         SD_ASSERT(initialized, "Cubemap not initialized");
 
-        out.write((char*)&id, sizeof(UUID));
-
-        size_t size = name.length() + 1;
-        out.write((char*)&size, sizeof(size_t));
-        out.write(name.c_str(), size * sizeof(char));
+        out.Write(id);
+        out.WriteString(name);
 
         SaveCubemap(out);
         SaveIrradianceMap(out);
@@ -59,13 +55,13 @@ namespace Seidon
         BRDFLookupMap->Bind(0);
         GL_CHECK(glGetTexImage(GL_TEXTURE_2D, 0, (GLenum)TextureFormat::RED_GREEN, GL_FLOAT, pixels));
 
-        out.write((char*)&BRDFLookupSize, sizeof(unsigned int));
-        out.write((char*)pixels, sizeof(float) * BRDFLookupSize * BRDFLookupSize * 2);
+        out.Write(BRDFLookupSize);
+        out.WriteArray(pixels, (size_t)BRDFLookupSize * BRDFLookupSize * 2);
 
         delete[] pixels;
     }
 
-    void HdrCubemap::SaveCubemap(std::ofstream& out)
+    void HdrCubemap::SaveCubemap(BinaryWriter& out)
     {
         int elementsPerPixel = 3;
         float* pixels = new float[(long long)faceSize * faceSize * elementsPerPixel];
@@ -73,17 +69,17 @@ namespace Seidon
         GL_CHECK(glActiveTexture(GL_TEXTURE0));
         GL_CHECK(glBindTexture(GL_TEXTURE_CUBE_MAP, skyboxID));
 
-        out.write((char*)&faceSize, sizeof(unsigned int));
+        out.Write(faceSize);
         for (unsigned int i = 0; i < 6; ++i)
         {
             GL_CHECK(glGetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, GL_FLOAT, pixels));
-            out.write((char*)pixels, sizeof(float) * faceSize * faceSize * elementsPerPixel);
+            out.WriteArray(pixels, (size_t)faceSize * faceSize * elementsPerPixel);
         }
 
         delete[] pixels;
     }
 
-    void HdrCubemap::SaveIrradianceMap(std::ofstream& out)
+    void HdrCubemap::SaveIrradianceMap(BinaryWriter& out)
     {
         int elementsPerPixel = 3;
         float* pixels = new float[(long long)irradianceMapSize * irradianceMapSize * elementsPerPixel];
@@ -91,17 +87,17 @@ namespace Seidon
         GL_CHECK(glActiveTexture(GL_TEXTURE0));
         GL_CHECK(glBindTexture(GL_TEXTURE_CUBE_MAP, irradianceMapID));
 
-        out.write((char*)&irradianceMapSize, sizeof(unsigned int));
+        out.Write(irradianceMapSize);
         for (unsigned int i = 0; i < 6; ++i)
         {
             GL_CHECK(glGetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, GL_FLOAT, pixels));
-            out.write((char*)pixels, sizeof(float) * irradianceMapSize * irradianceMapSize * elementsPerPixel);
+            out.WriteArray(pixels, (size_t)irradianceMapSize * irradianceMapSize * elementsPerPixel);
         }
 
         delete[] pixels;
     }
 
-    void HdrCubemap::SavePrefilteredMap(std::ofstream& out)
+    void HdrCubemap::SavePrefilteredMap(BinaryWriter& out)
     {
         int elementsPerPixel = 3;
         float* pixels = new float[(long long)prefilteredMapSize * prefilteredMapSize * elementsPerPixel];
@@ -109,7 +105,7 @@ namespace Seidon
         GL_CHECK(glActiveTexture(GL_TEXTURE0));
         GL_CHECK(glBindTexture(GL_TEXTURE_CUBE_MAP, prefilteredMapID));
         
-        out.write((char*)&prefilteredMapSize, sizeof(unsigned int));
+        out.Write(prefilteredMapSize);
 
         for (unsigned int mip = 0; mip < maxMipLevels; mip++)
         {
@@ -118,33 +114,27 @@ namespace Seidon
             for (unsigned int i = 0; i < 6; ++i)
             {
                 GL_CHECK(glGetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, mip, GL_RGB, GL_FLOAT, pixels));
-                out.write((char*)pixels, sizeof(float) * mipSize * mipSize * elementsPerPixel);
+                out.WriteArray(pixels, (size_t)mipSize * mipSize * elementsPerPixel);
             }
         }
         delete[] pixels;
     }
 
-    void HdrCubemap::Load(std::ifstream& in)
+    void HdrCubemap::Load(BinaryReader& in)
     {
         SD_ASSERT(!initialized, "Cubemap alrady initialized");
 
-        in.read((char*)&id, sizeof(UUID));
-
-        size_t size = 0;
-        in.read((char*)&size, sizeof(size_t));
-
-        char buffer[2048];
-        in.read(buffer, size * sizeof(char));
-        name = buffer;
+        in.Read(id);
+        in.ReadString(name);
 
         LoadCubemap(in);
         LoadIrradianceMap(in);
         LoadPrefilteredMap(in);
 
-        in.read((char*)&BRDFLookupSize, sizeof(unsigned int));
+        in.Read(BRDFLookupSize);
         
         float* pixels = new float[(long long)BRDFLookupSize * BRDFLookupSize * 2];
-        in.read((char*)pixels, sizeof(float) * BRDFLookupSize * BRDFLookupSize * 2);
+        in.ReadArray(pixels, (size_t)BRDFLookupSize * BRDFLookupSize * 2);
 
         BRDFLookupMap = new Texture();
         BRDFLookupMap->Create(BRDFLookupSize, BRDFLookupSize, pixels, TextureFormat::RED_GREEN, TextureFormat::FLOAT16_RED_GREEN, ClampingMode::CLAMP);
@@ -153,19 +143,19 @@ namespace Seidon
         initialized = true;
     }
 
-    void HdrCubemap::LoadCubemap(std::ifstream& in)
+    void HdrCubemap::LoadCubemap(BinaryReader& in)
     {
         int elementsPerPixel = 3;
 
         GL_CHECK(glGenTextures(1, &skyboxID));
         GL_CHECK(glBindTexture(GL_TEXTURE_CUBE_MAP, skyboxID));
 
-        in.read((char*)&faceSize, sizeof(unsigned int));
+        in.Read(faceSize);
         float* pixels = new float[(long long)faceSize * faceSize * 3];
 
         for (unsigned int i = 0; i < 6; ++i)
         {
-            in.read((char*)pixels, sizeof(float) * faceSize * faceSize * elementsPerPixel);
+            in.ReadArray(pixels, (size_t)faceSize * faceSize * elementsPerPixel);
             GL_CHECK(glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, faceSize, faceSize, 0, GL_RGB, GL_FLOAT, pixels));
         }
 
@@ -180,19 +170,19 @@ namespace Seidon
     }
 
     
-    void HdrCubemap::LoadIrradianceMap(std::ifstream& in)
+    void HdrCubemap::LoadIrradianceMap(BinaryReader& in)
     {
         int elementsPerPixel = 3;
 
         GL_CHECK(glGenTextures(1, &irradianceMapID));
         GL_CHECK(glBindTexture(GL_TEXTURE_CUBE_MAP, irradianceMapID));
 
-        in.read((char*)&irradianceMapSize, sizeof(unsigned int));
+        in.Read(irradianceMapSize);
         float* pixels = new float[(long long)irradianceMapSize * irradianceMapSize * 3];
 
         for (unsigned int i = 0; i < 6; ++i)
         {
-            in.read((char*)pixels, sizeof(float) * irradianceMapSize * irradianceMapSize * elementsPerPixel);
+            in.ReadArray(pixels, (size_t)irradianceMapSize * irradianceMapSize * elementsPerPixel);
             GL_CHECK(glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, irradianceMapSize, irradianceMapSize, 0, GL_RGB, GL_FLOAT, pixels));
         }
 
@@ -206,14 +196,14 @@ namespace Seidon
     }
 
     
-    void HdrCubemap::LoadPrefilteredMap(std::ifstream& in)
+    void HdrCubemap::LoadPrefilteredMap(BinaryReader& in)
     {
         int elementsPerPixel = 3;
 
         GL_CHECK(glGenTextures(1, &prefilteredMapID));
         GL_CHECK(glBindTexture(GL_TEXTURE_CUBE_MAP, prefilteredMapID));
 
-        in.read((char*)&prefilteredMapSize, sizeof(unsigned int));
+        in.Read(prefilteredMapSize);
         float* pixels = new float[(long long)prefilteredMapSize * prefilteredMapSize * 3];
 
         for (unsigned int i = 0; i < 6; i++)
@@ -227,7 +217,7 @@ namespace Seidon
 
             for (unsigned int i = 0; i < 6; ++i)
             {
-                in.read((char*)pixels, sizeof(float) * mipSize * mipSize * elementsPerPixel);
+                in.ReadArray(pixels, (size_t)mipSize * mipSize * elementsPerPixel);
                 GL_CHECK(glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, mip, GL_RGB16F, mipSize, mipSize, 0, GL_RGB, GL_FLOAT, pixels));
             }
         }
@@ -740,6 +730,13 @@ namespace Seidon
                 offset += sizeof(glm::vec4);
                 break;
             }
+            case Types::QUATERNION:
+            {
+                *(glm::quat*)(shaderData + offset) = *(glm::quat*)(material->data + m.offset);
+
+                offset += sizeof(glm::vec4);
+                break;
+            }
             case Types::TEXTURE:
             {
                 Texture* t = *(Texture**)(material->data + m.offset);
@@ -31,8 +31,8 @@ namespace Seidon
 		using Asset::Save;
 		using Asset::Load;
 
-		void Save(std::ofstream& out);
-		void Load(std::ifstream& in);
+		void Save(BinaryWriter& out);
+		void Load(BinaryReader& in);
 		
 		void CreateFromEquirectangularMap(Texture* texture);
 		void CreateFromMaterial(Material* material);
@@ -64,14 +64,14 @@ namespace Seidon
 		static constexpr unsigned int maxMipLevels = 5;
 
 	private:
-		void SaveCubemap(std::ofstream& out);
-		void LoadCubemap(std::ifstream& in);
+		void SaveCubemap(BinaryWriter& out);
+		void LoadCubemap(BinaryReader& in);
 
-		void SaveIrradianceMap(std::ofstream& out);
-		void LoadIrradianceMap(std::ifstream& in);
+		void SaveIrradianceMap(BinaryWriter& out);
+		void LoadIrradianceMap(BinaryReader& in);
 
-		void SavePrefilteredMap(std::ofstream& out);
-		void LoadPrefilteredMap(std::ifstream& in);
+		void SavePrefilteredMap(BinaryWriter& out);
+		void LoadPrefilteredMap(BinaryReader& in);
 
 		void ToCubemap(Texture& equirectangularMap);
 		void GenerateIrradianceMap();
@@ -2,7 +2,6 @@
 #include "../Core/Application.h"
 
 #include <iostream>
-#include <fstream>
 
 namespace Seidon
 {
@@ -27,17 +26,12 @@ namespace Seidon
 		layout->ModifyMember<Texture*>("Ambient Occlusion", data, resourceManager.GetAsset<Texture>("ao_default"));
 	}
 
-	void Material::Save(std::ofstream& out)
+	void Material::Save(BinaryWriter& out)
 	{
-		out.write((char*)&id, sizeof(UUID));
+		out.Write(id);
+		out.WriteString(name);
 
-		size_t size = name.length() + 1;
-		out.write((char*)&size, sizeof(size_t));
-
-		out.write(name.c_str(), size * sizeof(char));
-
-		UUID shaderId = shader->GetId();
-		out.write((char*)&shaderId, sizeof(UUID));
+		out.Write(shader->GetId());
 
 		MetaType& layout = *shader->GetBufferLayout();
 		layout.Save(out, data);
@@ -45,46 +39,24 @@ namespace Seidon
 
 	void Material::SaveAsync(const std::string& path)
 	{
-		Application::Get()->GetWorkManager()->Execute([&]()
+		Application::Get()->GetWorkManager()->Execute([this, path]()
 			{
 				Save(path);
 			});
 	}
 
-	void Material::Load(std::ifstream& in)
+	void Material::Load(BinaryReader& in)
 	{
-		in.read((char*)&id, sizeof(UUID));
-
-		size_t size = 0;
-		in.read((char*)&size, sizeof(size_t));
-
-		char buffer[2048];
-		in.read(buffer, size * sizeof(char));
-		name = buffer;
+		in.Read(id);
+		in.ReadString(name);
 
 		ResourceManager* resourceManager = Application::Get()->GetResourceManager();
 		UUID shaderId;
 
-		in.read((char*)&shaderId, sizeof(UUID));
+		in.Read(shaderId);
 		shader = resourceManager->GetOrLoadAsset<Shader>(shaderId);
 
 		MetaType& layout = *shader->GetBufferLayout();
 		layout.Load(in, data);
 	}
-
-	void Material::LoadAsync(const std::string& path)
-	{
-		ResourceManager* resourceManager = Application::Get()->GetResourceManager();
-		/*
-		albedo = resourceManager->GetTexture("albedo_default");
-		roughness = resourceManager->GetTexture("roughness_default");
-		normal = resourceManager->GetTexture("normal_default");
-		metallic = resourceManager->GetTexture("metallic_default");
-		ao = resourceManager->GetTexture("ao_default");
-		*/
-		Application::Get()->GetWorkManager()->Execute([&]()
-			{
-				Load(path);
-			});
-	}
 }
\ No newline at end of file
@@ -23,10 +23,9 @@ namespace Seidon
 		using Asset::Save;
 		using Asset::Load;
 
-		void Save(std::ofstream& out);
+		void Save(BinaryWriter& out);
 		void SaveAsync(const std::string& path);
-		void Load(std::ifstream& in);
-		void LoadAsync(const std::string& path);
+		void Load(BinaryReader& in);
 
 		template<typename T>
 		void ModifyProperty(const std::string& propertyName, const T& value)
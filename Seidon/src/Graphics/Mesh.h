@@ -1,21 +1,27 @@
 #pragma once
 #include "../Core/UUID.h"
 #include "../Core/Asset.h"
+#include "../Utils/MappedFile.h"
 
 #include "Vertex.h"
 #include "Armature.h"
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
 
 #include <iostream>
-#include <fstream>
 
 namespace Seidon
 {
     template <typename T>
     struct BaseSubmesh
     {
+        using VertexType = T;
+
         std::string name;
         std::vector<T> vertices;
         std::vector<unsigned int> indices;
@@ -29,11 +35,101 @@ namespace Seidon
             : name(name), vertices(vertices), indices(indices) {}
     };
 
+    /*
+    * Location of a submesh in the vertex and index blobs of a packed mesh. Indices are relative to the first vertex
+    * of the mesh, not of the submesh, so both blobs can be handed as they are to the GPU and to the physics cooking.
+    */
+    struct SubmeshRange
+    {
+        uint64_t vertexOffset = 0;
+        uint64_t vertexCount = 0;
+        uint64_t indexOffset = 0;
+        uint64_t indexCount = 0;
+
+        // Offset of the null terminated name in the name table
+        uint64_t nameOffset = 0;
+
+        glm::vec3 boundsMin = glm::vec3(0);
+        glm::vec3 boundsMax = glm::vec3(0);
+    };
+
+    static_assert(sizeof(SubmeshRange) == 64, "Submesh ranges are saved as they are and must not contain padding");
+
+    /*
+    * Geometry of a whole mesh in a single block: the submesh ranges, then the vertices, the indices and the submesh
+    * names. The block is saved as it is in .sdmesh v2 files, so loading it is one read, or none when the file is mapped.
+    */
+    template <typename V>
+    struct PackedGeometry
+    {
+        const char* block = nullptr;
+        size_t blockSize = 0;
+
+        const SubmeshRange* ranges = nullptr;
+        size_t submeshCount = 0;
+
+        const V* vertices = nullptr;
+        size_t vertexCount = 0;
+
+        const unsigned int* indices = nullptr;
+        size_t indexCount = 0;
+
+        const char* names = nullptr;
+        size_t namesSize = 0;
+
+        // Owner of the block: the mapped file it points into, or a copy when it couldn't be used in place
+        std::shared_ptr<const MappedFile> mappedFile;
+        std::vector<char> storage;
+
+        PackedGeometry() = default;
+        PackedGeometry(PackedGeometry&&) = default;
+        PackedGeometry& operator=(PackedGeometry&&) = default;
+
+        // The pointers would still point into the storage of the copied geometry
+        PackedGeometry(const PackedGeometry&) = delete;
+        PackedGeometry& operator=(const PackedGeometry&) = delete;
+
+        inline const char* GetSubmeshName(size_t index) const { return names + ranges[index].nameOffset; }
+
+        static size_t GetBlockSize(size_t submeshCount, size_t vertexCount, size_t indexCount, size_t namesSize)
+        {
+            return submeshCount * sizeof(SubmeshRange) + vertexCount * sizeof(V) + indexCount * sizeof(unsigned int) + namesSize;
+        }
+
+        void SetBlock(const char* data, size_t submeshCount, size_t vertexCount, size_t indexCount, size_t namesSize)
+        {
+            block = data;
+            blockSize = GetBlockSize(submeshCount, vertexCount, indexCount, namesSize);
+
+            this->submeshCount = submeshCount;
+            this->vertexCount = vertexCount;
+            this->indexCount = indexCount;
+            this->namesSize = namesSize;
+
+            ranges = (const SubmeshRange*)data;
+            vertices = (const V*)(data + submeshCount * sizeof(SubmeshRange));
+            indices = (const unsigned int*)(vertices + vertexCount);
+            names = (const char*)(indices + indexCount);
+        }
+    };
+
     template <typename T>
     struct BaseMesh : public Asset
     {
+        using VertexType = typename T::VertexType;
+
+        // Saved after the id by v2 files, where v1 files have the length of the name
+        static constexpr uint64_t PACKED_MAGIC = 0x3248534D4453; // "SDMSH2"
+        static constexpr uint32_t PACKED_VERSION = 2;
+
+        // Alignment of the geometry block from the start of the file
+        static constexpr size_t BLOCK_ALIGNMENT = 16;
+
         std::string filepath;
+
+        // Editable submeshes, filled by the importer. Loaded meshes keep their geometry packed instead
         std::vector<T*> subMeshes;
+        PackedGeometry<VertexType> packedGeometry;
 
         T submeshType;
 
@@ -44,78 +140,245 @@ namespace Seidon
         using Asset::Save;
         using Asset::Load;
 
-        void Load(std::ifstream& in) override
+        inline bool IsPacked() const { return packedGeometry.block != nullptr; }
+        inline size_t GetSubmeshCount() const { return IsPacked() ? packedGeometry.submeshCount : subMeshes.size(); }
+
+        // Mapped so that the geometry of v2 files is used in place
+        void Load(const std::string& path) override
+        {
+            this->path = path;
+
+            BinaryReader in(std::make_shared<MappedFile>(path));
+            Load(in);
+        }
+
+        void Load(BinaryReader& in) override
         {
-            char buffer[2048];
-            in.read((char*)&id, sizeof(id));
+            if (!in.IsGood())
+            {
+                std::cerr << "Error opening mesh file: " << path << std::endl;
+                return;
+            }
 
-            size_t size = 0;
-            in.read((char*)&size, sizeof(size_t));
+            in.Read(id);
 
-            in.read(buffer, size * sizeof(char));
-            name = buffer;
+            uint64_t tag = in.Read<uint64_t>();
 
-            in.read((char*)&size, sizeof(size_t));
-            subMeshes.resize(size);
-            for (int i = 0; i < size; i++)
+            if (tag == PACKED_MAGIC)
+                LoadPacked(in);
+            else
+                LoadV1(in, tag);
+        }
+
+        // Meshes only hold CPU data, the renderer uploads them when batching
+        bool SupportsAsyncLoad() override { return true; }
+        bool SupportsMappedLoad() override { return true; }
+        void LoadCpuData(BinaryReader& in) override { Load(in); }
+
+        // Always saved as v2
+        void Save(BinaryWriter& out) override
+        {
+            if (IsPacked())
+                SavePacked(out, packedGeometry);
+            else
+                SavePacked(out, PackSubmeshes(subMeshes));
+        }
+
+        static PackedGeometry<VertexType> PackSubmeshes(const std::vector<T*>& subMeshes)
+        {
+            size_t vertexCount = 0;
+            size_t indexCount = 0;
+            size_t namesSize = 0;
+
+            for (T* submesh : subMeshes)
             {
-                T* submesh = new T();
+                vertexCount += submesh->vertices.size();
+                indexCount += submesh->indices.size();
+                namesSize += submesh->name.length() + 1;
+            }
+
+            PackedGeometry<VertexType> geometry;
+            geometry.storage.resize(PackedGeometry<VertexType>::GetBlockSize(subMeshes.size(), vertexCount, indexCount, namesSize));
+            geometry.SetBlock(geometry.storage.data(), subMeshes.size(), vertexCount, indexCount, namesSize);
+
+            SubmeshRange* ranges = (SubmeshRange*)geometry.ranges;
+            VertexType* vertices = (VertexType*)geometry.vertices;
+            unsigned int* indices = (unsigned int*)geometry.indices;
+            char* names = (char*)geometry.names;
 
-                size_t size2 = 0;
+            SubmeshRange range;
+            for (size_t i = 0; i < subMeshes.size(); i++)
+            {
+                T* submesh = subMeshes[i];
 
-                in.read((char*)&size2, sizeof(size_t));
-                in.read(buffer, size2 * sizeof(char));
-                submesh->name = buffer;
+                range.vertexCount = submesh->vertices.size();
+                range.indexCount = submesh->indices.size();
 
-                in.read((char*)&size2, sizeof(size_t));
+                range.boundsMin = submesh->vertices.empty() ? glm::vec3(0) : submesh->vertices[0].position;
+                range.boundsMax = range.boundsMin;
 
-                submesh->vertices.resize(size2);
+                for (const VertexType& vertex : submesh->vertices)
+                {
+                    range.boundsMin = glm::min(range.boundsMin, vertex.position);
+                    range.boundsMax = glm::max(range.boundsMax, vertex.position);
+                }
 
-                for (int j = 0; j < size2; j++)
-                    in.read((char*)&submesh->vertices[j], sizeof(decltype(submesh->vertexType)));
+                if (range.vertexCount > 0)
+                    memcpy(vertices + range.vertexOffset, submesh->vertices.data(), range.vertexCount * sizeof(VertexType));
 
+                for (size_t j = 0; j < range.indexCount; j++)
+                    indices[range.indexOffset + j] = submesh->indices[j] + (unsigned int)range.vertexOffset;
 
-                in.read((char*)&size2, sizeof(size_t));
+                memcpy(names + range.nameOffset, submesh->name.c_str(), submesh->name.length() + 1);
 
-                submesh->indices.resize(size2);
-                for (int j = 0; j < size2; j++)
-                    in.read((char*)&submesh->indices[j], sizeof(unsigned int));
+                ranges[i] = range;
 
-                subMeshes[i] = submesh;
+                range.vertexOffset += range.vertexCount;
+                range.indexOffset += range.indexCount;
+                range.nameOffset += submesh->name.length() + 1;
             }
+
+            return geometry;
         }
 
-        //void SaveAsync(const std::string& path);
-        void Save(std::ofstream& out) override
+    private:
+        static size_t GetBlockPadding(size_t position)
         {
-            out.write((char*)&id, sizeof(id));
+            return (BLOCK_ALIGNMENT - position % BLOCK_ALIGNMENT) % BLOCK_ALIGNMENT;
+        }
 
-            size_t size = name.length() + 1;
-            out.write((char*)&size, sizeof(size_t));
+        void SavePacked(BinaryWriter& out, const PackedGeometry<VertexType>& geometry)
+        {
+            static const char zeroes[BLOCK_ALIGNMENT] = {};
 
-            out.write(name.c_str(), size * sizeof(char));
+            out.Write(id);
+            out.Write(PACKED_MAGIC);
+            out.Write(PACKED_VERSION);
+            out.Write((uint32_t)sizeof(VertexType));
+            out.WriteString(name);
 
-            size = subMeshes.size();
-            out.write((char*)&size, sizeof(size_t));
+            out.Write((uint64_t)geometry.submeshCount);
+            out.Write((uint64_t)geometry.vertexCount);
+            out.Write((uint64_t)geometry.indexCount);
+            out.Write((uint64_t)geometry.namesSize);
 
-            for (T* submesh : subMeshes)
+            out.WriteBytes(zeroes, GetBlockPadding(out.GetPosition()));
+            out.WriteBytes(geometry.block, geometry.blockSize);
+        }
+
+        void LoadPacked(BinaryReader& in)
+        {
+            uint32_t version = in.Read<uint32_t>();
+            uint32_t vertexSize = in.Read<uint32_t>();
+
+            if (version != PACKED_VERSION || vertexSize != sizeof(VertexType))
+            {
+                std::cerr << "Error loading mesh " << path << ": unsupported version or vertex format" << std::endl;
+                return;
+            }
+
+            in.ReadString(name);
+
+            uint64_t submeshCount = in.Read<uint64_t>();
+            uint64_t vertexCount = in.Read<uint64_t>();
+            uint64_t indexCount = in.Read<uint64_t>();
+            uint64_t namesSize = in.Read<uint64_t>();
+
+            in.Skip(GetBlockPadding(in.GetPosition()));
+
+            // Each part alone must fit in what is left, so that adding them up can't overflow
+            size_t remaining = std::min(in.GetRemainingSize(), SIZE_MAX / 4);
+
+            if (!in.IsGood() || submeshCount > remaining / sizeof(SubmeshRange) || vertexCount > remaining / sizeof(VertexType)
+                || indexCount > remaining / sizeof(unsigned int) || namesSize > remaining
+                || PackedGeometry<VertexType>::GetBlockSize(submeshCount, vertexCount, indexCount, namesSize) > remaining)
             {
-                size = submesh->name.length() + 1;
-                out.write((char*)&size, sizeof(size_t));
-                out.write(submesh->name.c_str(), size * sizeof(char));
+                std::cerr << "Error loading mesh " << path << ": geometry size out of range" << std::endl;
+                return;
+            }
+
+            PackedGeometry<VertexType> geometry;
+            size_t blockSize = PackedGeometry<VertexType>::GetBlockSize(submeshCount, vertexCount, indexCount, namesSize);
 
-                size = submesh->vertices.size();
-                out.write((char*)&size, sizeof(size_t));
+            const char* block = in.ReadInPlace(blockSize);
 
-                for (auto& v : submesh->vertices)
-                    out.write((char*)&v, sizeof(decltype(submesh->vertexType)));
+            if (block && in.GetMappedFile())
+                geometry.mappedFile = in.GetMappedFile();
+            else
+            {
+                // Memory readers don't own their data and streams can't be read in place
+                geometry.storage.resize(blockSize);
+
+                if (block)
+                    memcpy(geometry.storage.data(), block, blockSize);
+                else
+                    in.ReadBytes(geometry.storage.data(), blockSize);
 
-                size = submesh->indices.size();
-                out.write((char*)&size, sizeof(size_t));
+                block = geometry.storage.data();
+            }
 
-                for (unsigned int i : submesh->indices)
-                    out.write((char*)&i, sizeof(unsigned int));
+            if (!in.IsGood())
+            {
+                std::cerr << "Error loading mesh " << path << ": unexpected end of file" << std::endl;
+                return;
             }
+
+            geometry.SetBlock(block, submeshCount, vertexCount, indexCount, namesSize);
+
+            if (!IsValid(geometry))
+            {
+                std::cerr << "Error loading mesh " << path << ": corrupted submesh ranges" << std::endl;
+                return;
+            }
+
+            packedGeometry = std::move(geometry);
+        }
+
+        // Only the ranges are checked, indices are used as they are saved
+        static bool IsValid(const PackedGeometry<VertexType>& geometry)
+        {
+            if (geometry.namesSize > 0 && geometry.names[geometry.namesSize - 1] != '\0')
+                return false;
+
+            for (size_t i = 0; i < geometry.submeshCount; i++)
+            {
+                const SubmeshRange& range = geometry.ranges[i];
+
+                if (range.vertexOffset > geometry.vertexCount || range.vertexCount > geometry.vertexCount - range.vertexOffset)
+                    return false;
+
+                if (range.indexOffset > geometry.indexCount || range.indexCount > geometry.indexCount - range.indexOffset)
+                    return false;
+
+                if (range.nameOffset >= geometry.namesSize)
+                    return false;
+            }
+
+            return true;
+        }
+
+        // Kept to read the files saved before v2, they are packed once loaded
+        void LoadV1(BinaryReader& in, size_t nameLength)
+        {
+            in.ReadString(name, nameLength);
+
+            // Each submesh takes at least its name length and its two array sizes
+            std::vector<T*> loadedSubmeshes(in.ReadCount(3 * sizeof(size_t)));
+
+            for (T*& submesh : loadedSubmeshes)
+            {
+                submesh = new T();
+
+                in.ReadString(submesh->name);
+                in.ReadVector(submesh->vertices);
+                in.ReadVector(submesh->indices);
+            }
+
+            if (in.IsGood())
+                packedGeometry = PackSubmeshes(loadedSubmeshes);
+
+            for (T* submesh : loadedSubmeshes)
+                delete submesh;
         }
     };
 
@@ -134,13 +397,13 @@ namespace Seidon
         using BaseMesh::Save;
         using BaseMesh::Load;
 
-        void Save(std::ofstream& out) override
+        void Save(BinaryWriter& out) override
         {
             BaseMesh::Save(out);
             armature.Save(out);
         }
 
-        void Load(std::ifstream& in) override
+        void Load(BinaryReader& in) override
         {
             BaseMesh::Load(in);
             armature.Load(in);
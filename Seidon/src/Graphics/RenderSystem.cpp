@@ -1,6 +1,7 @@
 #include "RenderSystem.h"
 #include "../Debug/Debug.h"
-#include "../Debug/Timer.h"
+#include "../Debug/Profiler.h"
+#include "../Utils/SimdMath.h"
 
 #include "Ecs/Scene.h"
 
@@ -91,11 +92,11 @@ namespace Seidon
 		auto cameras   = scene->CreateComponentGroup<CameraComponent, TransformComponent>();
 		auto cubemaps   = scene->CreateComponentView<CubemapComponent>();
 		auto skyLights = scene->CreateComponentView<ProceduralSkylightComponent>();
-		auto renderGroup = scene->CreateComponentGroup<RenderComponent>(GetTypeList<TransformComponent>);
-		auto skinnedRenderGroup = scene->CreateComponentGroup<SkinnedRenderComponent>(GetTypeList<TransformComponent>);
-		auto wireframeRenderGroup = scene->CreateComponentGroup<WireframeRenderComponent>(GetTypeList<TransformComponent>);
-		auto spriteRenderGroup = scene->CreateComponentGroup<SpriteRenderComponent>(GetTypeList<TransformComponent>);
-		auto textRenderGroup = scene->CreateComponentGroup<TextRenderComponent>(GetTypeList<TransformComponent>);
+		auto renderGroup = scene->CreateComponentGroup<RenderComponent>(GetTypeList<TransformComponent>, GetExcludeList<InactiveComponent>);
+		auto skinnedRenderGroup = scene->CreateComponentGroup<SkinnedRenderComponent>(GetTypeList<TransformComponent>, GetExcludeList<InactiveComponent>);
+		auto wireframeRenderGroup = scene->CreateComponentGroup<WireframeRenderComponent>(GetTypeList<TransformComponent>, GetExcludeList<InactiveComponent>);
+		auto spriteRenderGroup = scene->CreateComponentGroup<SpriteRenderComponent>(GetTypeList<TransformComponent>, GetExcludeList<InactiveComponent>);
+		auto textRenderGroup = scene->CreateComponentGroup<TextRenderComponent>(GetTypeList<TransformComponent>, GetExcludeList<InactiveComponent>);
 
 		DirectionalLightComponent light;
 		TransformComponent lightTransform;
@@ -154,7 +155,31 @@ namespace Seidon
 
 		camera.aspectRatio = (float)framebufferWidth / framebufferHeight;
 
+		//Bone palettes are independent per entity, resolve them on the worker threads before any pass uses them
+		SD_PROFILE_BEGIN("Bone Palettes");
+		scene->ParallelIterate
+		(
+			skinnedRenderGroup,
+			[&](EntityId id, SkinnedRenderComponent& renderComponent, TransformComponent& transform)
+			{
+				if (renderComponent.worldSpaceBoneTransforms.size() > 0) renderComponent.worldSpaceBoneTransforms[0] = renderComponent.boneTransforms[0];
+				for (int i = 1; i < renderComponent.mesh->armature.bones.size(); i++)
+				{
+					BoneData& bone = renderComponent.mesh->armature.bones[i];
+					renderComponent.worldSpaceBoneTransforms[i] = MultiplyMatrix(renderComponent.worldSpaceBoneTransforms[bone.parentId], renderComponent.boneTransforms[i]);
+				}
+
+				for (int i = 0; i < renderComponent.mesh->armature.bones.size(); i++)
+				{
+					BoneData& bone = renderComponent.mesh->armature.bones[i];
+					renderComponent.worldSpaceBoneTransforms[i] = MultiplyMatrix(renderComponent.worldSpaceBoneTransforms[i], bone.inverseBindPoseMatrix);
+				}
+			}
+		);
+		SD_PROFILE_END();
+
 		//Shadow Pass
+		SD_PROFILE_BEGIN("Shadow Pass");
 		//glDisable(GL_CULL_FACE);
 		//glCullFace(GL_FRONT);
 		GL_CHECK(glEnable(GL_DEPTH_CLAMP));
@@ -205,7 +230,7 @@ namespace Seidon
 				{
 					Entity e = scene->GetEntityByEntityId(id);
 
-					while (renderComponent.mesh->subMeshes.size() > ms.size())
+					while (renderComponent.mesh->GetSubmeshCount() > ms.size())
 						ms.push_back(&m);
 
 					renderer.SubmitMesh(renderComponent.mesh, ms, e.GetGlobalTransformMatrix(), id);
@@ -219,7 +244,7 @@ namespace Seidon
 				{
 					Entity e = scene->GetEntityByEntityId(id);
 
-					while (renderComponent.mesh->subMeshes.size() > ms2.size())
+					while (renderComponent.mesh->GetSubmeshCount() > ms2.size())
 						ms2.push_back(&m2);
 
 					renderer.SubmitSkinnedMesh(renderComponent.mesh, renderComponent.worldSpaceBoneTransforms, ms2, e.GetGlobalTransformMatrix(), id);
@@ -233,8 +258,10 @@ namespace Seidon
 		renderer.End();
 
 		GL_CHECK(glDisable(GL_DEPTH_CLAMP));
+		SD_PROFILE_END();
 
 		//Hdr Pass
+		SD_PROFILE_BEGIN("Hdr Pass");
 		GL_CHECK(glEnable(GL_CULL_FACE));
 		hdrFramebuffer.Bind();
 
@@ -300,19 +327,6 @@ namespace Seidon
 			{
 				Entity e = scene->GetEntityByEntityId(id);
 
-				if (renderComponent.worldSpaceBoneTransforms.size() > 0) renderComponent.worldSpaceBoneTransforms[0] = renderComponent.boneTransforms[0];
-				for (int i = 1; i < renderComponent.mesh->armature.bones.size(); i++)
-				{
-					BoneData& bone = renderComponent.mesh->armature.bones[i];
-					renderComponent.worldSpaceBoneTransforms[i] = renderComponent.worldSpaceBoneTransforms[bone.parentId] * renderComponent.boneTransforms[i];
-				}
-
-				for (int i = 0; i < renderComponent.mesh->armature.bones.size(); i++)
-				{
-					BoneData& bone = renderComponent.mesh->armature.bones[i];
-					renderComponent.worldSpaceBoneTransforms[i] *= bone.inverseBindPoseMatrix;
-				}
-
 				renderer.SubmitSkinnedMesh(renderComponent.mesh, renderComponent.worldSpaceBoneTransforms, renderComponent.materials, e.GetGlobalTransformMatrix(), id);
 			}
 		);
@@ -357,7 +371,9 @@ namespace Seidon
 		renderer.End();
 
 		stats = renderer.GetRenderStats();
+		SD_PROFILE_END();
 
+		SD_PROFILE_BEGIN("UI Pass");
 		uiRenderer.Begin();
 
 		float aspectRatio = (float)framebufferWidth / framebufferHeight;
@@ -407,6 +423,7 @@ namespace Seidon
 		);
 		uiRenderer.End();
 		uiRenderer.Render();
+		SD_PROFILE_END();
 
 		ProcessMouseSelection();
 		
@@ -423,6 +440,7 @@ namespace Seidon
 		hdrFramebuffer.Unbind();
 
 		// Final Quad
+		SD_PROFILE_ZONE("Final Quad");
 		if(!renderToScreen) renderFramebuffer.Bind();
 		GL_CHECK(glViewport(0, 0, framebufferWidth, framebufferHeight));
 		GL_CHECK(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
@@ -3,7 +3,7 @@
 #include "QuadMesh.h"
 
 #include "../Debug/Debug.h"
-#include "../Debug/Timer.h"
+#include "../Debug/Profiler.h"
 
 #include "../Reflection/Reflection.h"
 
@@ -146,12 +146,10 @@ namespace Seidon
 
 		glBindVertexArray(vao);
 		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-		glBufferSubData(GL_ARRAY_BUFFER, vertexBufferHeadPosition, quad.subMeshes[0]->vertices.size() * sizeof(Vertex), (void*)&quad.subMeshes[0]->vertices[0]);
-		vertexBufferHeadPosition += quad.subMeshes[0]->vertices.size() * sizeof(Vertex);
+		glBufferSubData(GL_ARRAY_BUFFER, nextVertexPosition * sizeof(Vertex), quad.subMeshes[0]->vertices.size() * sizeof(Vertex), (void*)&quad.subMeshes[0]->vertices[0]);
 
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
-		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexBufferHeadPosition, quad.subMeshes[0]->indices.size() * sizeof(uint32_t), (void*)&quad.subMeshes[0]->indices[0]);
-		indexBufferHeadPosition += quad.subMeshes[0]->indices.size() * sizeof(uint32_t);
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, nextIndexPosition * sizeof(uint32_t), quad.subMeshes[0]->indices.size() * sizeof(uint32_t), (void*)&quad.subMeshes[0]->indices[0]);
 		glBindVertexArray(0);
 
 		spriteBatch.command.firstIndex = nextIndexPosition;
@@ -312,83 +310,99 @@ namespace Seidon
 		characterCount = 0;
 	}
 
-	void Renderer::SubmitMesh(Mesh* mesh, std::vector<Material*>& materials, const glm::mat4& transform, EntityId owningEntityId)
+	template <typename MeshType>
+	std::vector<CacheEntry>& Renderer::UploadMesh(MeshType* mesh, uint32_t vao, uint32_t vertexBuffer, uint32_t indexBuffer,
+		uint32_t& nextVertexPosition, uint32_t& nextIndexPosition, uint32_t& vertexCount, uint32_t& indexCount)
 	{
-		if (meshCache.count(mesh->id) > 0)
+		using VertexType = typename MeshType::VertexType;
+
+		std::vector<CacheEntry>& cache = meshCache[mesh->id];
+		cache.reserve(mesh->GetSubmeshCount());
+
+		glBindVertexArray(vao);
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+		if (mesh->IsPacked())
 		{
-			std::vector<CacheEntry>& cachedSubmeshes = meshCache[mesh->id];
+			// Indices are relative to the first vertex of the mesh, so every submesh shares its base vertex
+			const PackedGeometry<VertexType>& geometry = mesh->packedGeometry;
+
+			glBufferSubData(GL_ARRAY_BUFFER, nextVertexPosition * sizeof(VertexType), geometry.vertexCount * sizeof(VertexType), geometry.vertices);
+			glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, nextIndexPosition * sizeof(uint32_t), geometry.indexCount * sizeof(uint32_t), geometry.indices);
+
+			for (size_t i = 0; i < geometry.submeshCount; i++)
+			{
+				const SubmeshRange& range = geometry.ranges[i];
+				CacheEntry entry;
 
-			int i = 0;
-			for (CacheEntry& entry : cachedSubmeshes)
+				entry.vertexBufferBegin = nextVertexPosition;
+				entry.vertexBufferSize = (uint32_t)range.vertexCount;
+
+				entry.indexBufferBegin = nextIndexPosition + (uint32_t)range.indexOffset;
+				entry.indexBufferSize = (uint32_t)range.indexCount;
+
+				cache.push_back(entry);
+			}
+
+			nextVertexPosition += geometry.vertexCount;
+			nextIndexPosition += geometry.indexCount;
+
+			vertexCount += geometry.vertexCount;
+			indexCount += geometry.indexCount;
+		}
+		else
+		{
+			for (auto* s : mesh->subMeshes)
 			{
-				BatchData& batch = batches[materials[i]->shader];
+				CacheEntry entry;
 
-				RenderCommand command;
+				entry.vertexBufferBegin = nextVertexPosition;
+				entry.vertexBufferSize = s->vertices.size();
 
-				command.count = entry.indexBufferSize;
-				command.instanceCount = 1;
-				command.firstIndex = entry.indexBufferBegin;
-				command.baseVertex = entry.vertexBufferBegin;
-				command.baseInstance = batch.objectCount;
-				objectCount++;
+				entry.indexBufferBegin = nextIndexPosition;
+				entry.indexBufferSize = s->indices.size();
 
-				stats.objectCount++;
+				cache.push_back(entry);
 
-				MaterialData material;
-				SetupMaterialData(materials[i], material);
+				glBufferSubData(GL_ARRAY_BUFFER, nextVertexPosition * sizeof(VertexType), s->vertices.size() * sizeof(VertexType), (void*)&s->vertices[0]);
+				glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, nextIndexPosition * sizeof(uint32_t), s->indices.size() * sizeof(uint32_t), (void*)&s->indices[0]);
 
-				batch.objectCount++;
-				batch.transforms.push_back(transform);
-				batch.commands.push_back(command);
-				batch.materials.push_back(material);
-				batch.entityIds.push_back((int)owningEntityId);
+				nextVertexPosition += s->vertices.size();
+				nextIndexPosition += s->indices.size();
 
-				i++;
+				vertexCount += s->vertices.size();
+				indexCount += s->indices.size();
 			}
-
-			return;
 		}
 
-		std::vector<CacheEntry> cache;
-		cache.reserve(mesh->subMeshes.size());
+		glBindVertexArray(0);
+
+		return cache;
+	}
+
+	void Renderer::SubmitMesh(Mesh* mesh, std::vector<Material*>& materials, const glm::mat4& transform, EntityId owningEntityId)
+	{
+		auto it = meshCache.find(mesh->id);
+
+		std::vector<CacheEntry>& cachedSubmeshes = it != meshCache.end() ? it->second :
+			UploadMesh(mesh, vao, vertexBuffer, indexBuffer, nextVertexPosition, nextIndexPosition, stats.vertexCount, stats.indexCount);
+
 		int i = 0;
-		for (Submesh* s : mesh->subMeshes)
+		for (CacheEntry& entry : cachedSubmeshes)
 		{
 			BatchData& batch = batches[materials[i]->shader];
 
 			RenderCommand command;
-			command.count = s->indices.size();
+
+			command.count = entry.indexBufferSize;
 			command.instanceCount = 1;
-			command.firstIndex = nextIndexPosition;
-			command.baseVertex = nextVertexPosition;
+			command.firstIndex = entry.indexBufferBegin;
+			command.baseVertex = entry.vertexBufferBegin;
 			command.baseInstance = batch.objectCount;
-			
 			objectCount++;
-			stats.objectCount++;
-			CacheEntry entry;
 
-			entry.vertexBufferBegin = nextVertexPosition;
-			entry.vertexBufferSize = s->vertices.size();
-			nextVertexPosition += s->vertices.size();
-
-			entry.indexBufferBegin = nextIndexPosition;
-			entry.indexBufferSize = s->indices.size();
-			nextIndexPosition += s->indices.size();
-
-			cache.push_back(entry);
-
-			stats.vertexCount += s->vertices.size();
-			stats.indexCount += s->indices.size();
-
-			glBindVertexArray(vao);
-			glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-			glBufferSubData(GL_ARRAY_BUFFER, vertexBufferHeadPosition, s->vertices.size() * sizeof(Vertex), (void*)&s->vertices[0]);
-			vertexBufferHeadPosition += s->vertices.size() * sizeof(Vertex);
-			
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
-			glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexBufferHeadPosition, s->indices.size() * sizeof(uint32_t), (void*)&s->indices[0]);
-			indexBufferHeadPosition += s->indices.size() * sizeof(uint32_t);
-			glBindVertexArray(0);
+			stats.objectCount++;
 
 			MaterialData material;
 			SetupMaterialData(materials[i], material);
@@ -401,88 +415,32 @@ namespace Seidon
 
 			i++;
 		}
-
-		meshCache[mesh->id] = cache;
 	}
 	
 	void Renderer::SubmitSkinnedMesh(SkinnedMesh* mesh, std::vector<glm::mat4>& bones, std::vector<Material*>& materials, const glm::mat4& transform, EntityId owningEntityId)
 	{
-		if (meshCache.count(mesh->id) > 0)
-		{
-			std::vector<CacheEntry>& cachedSubmeshes = meshCache[mesh->id];
-
-			int i = 0;
-			for (CacheEntry& entry : cachedSubmeshes)
-			{
-				SkinnedMeshBatch& batch = skinnedMeshBatches[&bones];
+		auto it = meshCache.find(mesh->id);
 
-				RenderCommand command;
+		std::vector<CacheEntry>& cachedSubmeshes = it != meshCache.end() ? it->second :
+			UploadMesh(mesh, skinnedVao, skinnedVertexBuffer, skinnedIndexBuffer, nextSkinnedVertexPosition, nextSkinnedIndexPosition,
+				stats.skinnedVertexCount, stats.skinnedIndexCount);
 
-				command.count = entry.indexBufferSize;
-				command.instanceCount = 1;
-				command.firstIndex = entry.indexBufferBegin;
-				command.baseVertex = entry.vertexBufferBegin;
-				command.baseInstance = 0;
-				objectCount++;
-
-				stats.objectCount++;
-
-				MaterialData material;
-				SetupMaterialData(materials[i], material);
-
-				batch.objectCount++;
-				batch.transforms.push_back(transform);
-				batch.commands.push_back(command);
-				batch.materials.push_back(material);
-				batch.entityIds.push_back((int)owningEntityId);
-				batch.bones = &bones;
-
-				i++;
-			}
-
-			return;
-		}
-
-		std::vector<CacheEntry> cache;
-		cache.reserve(mesh->subMeshes.size());
 		int i = 0;
-		for (SkinnedSubmesh* s : mesh->subMeshes)
+		for (CacheEntry& entry : cachedSubmeshes)
 		{
 			SkinnedMeshBatch& batch = skinnedMeshBatches[&bones];
 
 			RenderCommand command;
-			command.count = s->indices.size();
+
+			command.count = entry.indexBufferSize;
 			command.instanceCount = 1;
-			command.firstIndex = nextSkinnedIndexPosition;
-			command.baseVertex = nextSkinnedVertexPosition;
+			command.firstIndex = entry.indexBufferBegin;
+			command.baseVertex = entry.vertexBufferBegin;
 			command.baseInstance = 0;
-
 			objectCount++;
-			stats.objectCount++;
-			CacheEntry entry;
-
-			entry.vertexBufferBegin = nextSkinnedVertexPosition;
-			entry.vertexBufferSize = s->vertices.size();
-			nextSkinnedVertexPosition += s->vertices.size();
-
-			entry.indexBufferBegin = nextSkinnedIndexPosition;
-			entry.indexBufferSize = s->indices.size();
-			nextSkinnedIndexPosition += s->indices.size();
-
-			cache.push_back(entry);
-
-			stats.skinnedVertexCount += s->vertices.size();
-			stats.skinnedIndexCount += s->indices.size();
 
-			glBindVertexArray(skinnedVao);
-			glBindBuffer(GL_ARRAY_BUFFER, skinnedVertexBuffer);
-			glBufferSubData(GL_ARRAY_BUFFER, skinnedVertexBufferHeadPosition, s->vertices.size() * sizeof(SkinnedVertex), (void*)&s->vertices[0]);
-			skinnedVertexBufferHeadPosition += s->vertices.size() * sizeof(SkinnedVertex);
+			stats.objectCount++;
 
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, skinnedIndexBuffer);
-			glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, skinnedIndexBufferHeadPosition, s->indices.size() * sizeof(uint32_t), (void*)&s->indices[0]);
-			skinnedIndexBufferHeadPosition += s->indices.size() * sizeof(uint32_t);
-			glBindVertexArray(0);
 			MaterialData material;
 			SetupMaterialData(materials[i], material);
 
@@ -495,77 +453,27 @@ namespace Seidon
 
 			i++;
 		}
-
-		meshCache[mesh->id] = cache;
 	}
 	
 	void Renderer::SubmitMeshWireframe(Mesh* mesh, const glm::vec3& color, const glm::mat4& transform, EntityId owningEntityId)
 	{
-		if (meshCache.count(mesh->id) > 0)
-		{
-			std::vector<CacheEntry>& cachedSubmeshes = meshCache[mesh->id];
+		auto it = meshCache.find(mesh->id);
 
-			int i = 0;
-			for (CacheEntry& entry : cachedSubmeshes)
-			{
-				RenderCommand command;
-
-				command.count = entry.indexBufferSize;
-				command.instanceCount = 1;
-				command.firstIndex = entry.indexBufferBegin;
-				command.baseVertex = entry.vertexBufferBegin;
-				command.baseInstance = wireframeBatch.objectCount;
-				objectCount++;
-
-				stats.objectCount++;
-
-				wireframeBatch.objectCount++;
-				wireframeBatch.transforms.push_back(transform);
-				wireframeBatch.commands.push_back(command);
-				wireframeBatch.colors.push_back(glm::vec4(color, 1.0));
-				wireframeBatch.entityIds.push_back((int)owningEntityId);
-			}
+		std::vector<CacheEntry>& cachedSubmeshes = it != meshCache.end() ? it->second :
+			UploadMesh(mesh, vao, vertexBuffer, indexBuffer, nextVertexPosition, nextIndexPosition, stats.vertexCount, stats.indexCount);
 
-			return;
-		}
-
-		std::vector<CacheEntry> cache;
-		cache.reserve(mesh->subMeshes.size());
-		for (Submesh* s : mesh->subMeshes)
+		for (CacheEntry& entry : cachedSubmeshes)
 		{
 			RenderCommand command;
-			command.count = s->indices.size();
+
+			command.count = entry.indexBufferSize;
 			command.instanceCount = 1;
-			command.firstIndex = nextIndexPosition;
-			command.baseVertex = nextVertexPosition;
+			command.firstIndex = entry.indexBufferBegin;
+			command.baseVertex = entry.vertexBufferBegin;
 			command.baseInstance = wireframeBatch.objectCount;
-
 			objectCount++;
-			stats.objectCount++;
-			CacheEntry entry;
-
-			entry.vertexBufferBegin = nextVertexPosition;
-			entry.vertexBufferSize = s->vertices.size();
-			nextVertexPosition += s->vertices.size();
-
-			entry.indexBufferBegin = nextIndexPosition;
-			entry.indexBufferSize = s->indices.size();
-			nextIndexPosition += s->indices.size();
-
-			cache.push_back(entry);
-
-			stats.vertexCount += s->vertices.size();
-			stats.indexCount += s->indices.size();
-
-			glBindVertexArray(vao);
-			glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-			glBufferSubData(GL_ARRAY_BUFFER, vertexBufferHeadPosition, s->vertices.size() * sizeof(Vertex), (void*)&s->vertices[0]);
-			vertexBufferHeadPosition += s->vertices.size() * sizeof(Vertex);
 
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
-			glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexBufferHeadPosition, s->indices.size() * sizeof(uint32_t), (void*)&s->indices[0]);
-			indexBufferHeadPosition += s->indices.size() * sizeof(uint32_t);
-			glBindVertexArray(0);
+			stats.objectCount++;
 
 			wireframeBatch.objectCount++;
 			wireframeBatch.transforms.push_back(transform);
@@ -573,8 +481,6 @@ namespace Seidon
 			wireframeBatch.colors.push_back(glm::vec4(color, 1.0));
 			wireframeBatch.entityIds.push_back((int)owningEntityId);
 		}
-
-		meshCache[mesh->id] = cache;
 	}
 
 	void Renderer::SubmitSprite(Texture* sprite, const glm::vec3& tint, const glm::mat4& transform, EntityId owningEntityId)
@@ -694,6 +600,8 @@ namespace Seidon
 
 	void Renderer::Render()
 	{
+		SD_PROFILE_FUNCTION();
+
 		GL_CHECK(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffers[tripleBufferStage]));
 
 		int offset = 0;
@@ -1063,6 +971,14 @@ namespace Seidon
 				alignment = std::max<int>(alignment, sizeof(glm::vec4));
 				break;
 			}
+			case Types::QUATERNION:
+			{
+				*(glm::quat*)(shaderData + offset) = *(glm::quat*)(material->data + m.offset);
+
+				offset += sizeof(glm::vec4);
+				alignment = std::max<int>(alignment, sizeof(glm::vec4));
+				break;
+			}
 			case Types::TEXTURE:
 			{
 				Texture* t = *(Texture**)(material->data + m.offset);
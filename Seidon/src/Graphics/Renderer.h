@@ -185,16 +185,12 @@ namespace Seidon
 		uint32_t indexBuffer;
 		uint32_t nextIndexPosition = 0;
 		uint32_t nextVertexPosition = 0;
-		uint32_t vertexBufferHeadPosition = 0;
-		uint32_t indexBufferHeadPosition = 0;
 
 		uint32_t skinnedVao;
 		uint32_t skinnedVertexBuffer;
 		uint32_t skinnedIndexBuffer;
 		uint32_t nextSkinnedIndexPosition = 0;
 		uint32_t nextSkinnedVertexPosition = 0;
-		uint32_t skinnedVertexBufferHeadPosition = 0;
-		uint32_t skinnedIndexBufferHeadPosition = 0;
 
 		uint32_t instanceDataBuffer;
 
@@ -244,6 +240,11 @@ namespace Seidon
 		void InitTextBuffers();
 		void InitStorageBuffers();
 
+		// Appends the geometry of a mesh to the given buffers and caches where each submesh ended up
+		template <typename MeshType>
+		std::vector<CacheEntry>& UploadMesh(MeshType* mesh, uint32_t vao, uint32_t vertexBuffer, uint32_t indexBuffer,
+			uint32_t& nextVertexPosition, uint32_t& nextIndexPosition, uint32_t& vertexCount, uint32_t& indexCount);
+
 		void SetupMaterialData(Material* material, MaterialData& materialData);
 		void DrawMeshes(int& offset, int& materialOffset, int& idOffset);
 		void DrawSkinnedMeshes(int& offset, int& materialOffset, int& idOffset);
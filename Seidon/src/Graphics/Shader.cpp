@@ -17,8 +17,6 @@
 
 namespace Seidon
 {
-    Shader* Shader::temporaryShader = nullptr;
-
     Shader::Shader(UUID id)
     {
         this->id = id;
@@ -42,12 +40,12 @@ namespace Seidon
         GL_CHECK(glDeleteProgram(renderId));
     }
 
-    void Shader::Save(std::ofstream& out)
+    void Shader::Save(BinaryWriter& out)
     {
 
     }
 
-    void Shader::Load(std::ifstream& in)
+    void Shader::Load(BinaryReader& in)
     {
 
     }
@@ -109,6 +107,12 @@ namespace Seidon
                 offset += member.size;
                 break;
 
+            case Types::QUATERNION:
+                member.size = sizeof(glm::quat);
+                member.offset = offset;
+                offset += member.size;
+                break;
+
             case Types::TEXTURE:
                 member.size = sizeof(uint64_t);
                 member.offset = offset;
@@ -124,6 +128,8 @@ namespace Seidon
             bufferLayout->nameToMember[member.name] = member;
         }
 
+        bufferLayout->Compile();
+
         if (!endFound)
         {
             std::cerr << "Shader buffer layout syntax error: End not found" << std::endl;
@@ -180,71 +186,6 @@ namespace Seidon
         initialized = true;
     }
 
-    void Shader::LoadFromFileAsync(const std::string& path)
-    {
-        SD_ASSERT(!initialized, "Shader already initialized");
-
-        this->name = path;
-
-        if (!temporaryShader)
-        {
-            temporaryShader = new Shader();
-            std::string vertexSource = "#version 330 core\n void main() { gl_Position = vec4(0); } ";
-            std::string fragmentSource = "#version 330 core\n void main() { } ";
-
-            temporaryShader->name = "Temp";
-            temporaryShader->CreateFromSource(vertexSource, fragmentSource);
-        }
-
-        renderId = temporaryShader->renderId;
-        Application::Get()->GetWorkManager()->Execute([this, path]()
-            {
-                std::stringstream vertexStream;
-                std::stringstream fragmentStream;
-                std::ifstream shaderFile;
-
-                try
-                {
-                    char buffer[512];
-                    std::stringstream* currentStream = nullptr;
-
-                    shaderFile.open(path);
-                    if (!shaderFile.is_open())
-                    {
-                        std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_OPENED " << path << std::endl;
-                        return;
-                    }
-
-                    while (shaderFile.getline(buffer, 512)) {
-                        if (buffer[0] == '~') {
-                            if (strcmp(buffer, "~VERTEX SHADER") == 0) currentStream = &vertexStream;
-                            if (strcmp(buffer, "~FRAGMENT SHADER") == 0) currentStream = &fragmentStream;
-                            continue;
-                        }
-
-                        (*currentStream) << buffer << "\n";
-                    }
-
-                    shaderFile.close();
-                }
-                catch (std::ifstream::failure e)
-                {
-                    std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ " << path << std::endl;
-                }
-
-                std::string vShaderCode = vertexStream.str();
-                std::string fShaderCode = fragmentStream.str();
-
-                
-                Application::Get()->GetWorkManager()->ExecuteOnMainThread([this, vShaderCode, fShaderCode]()
-                    {
-                        CreateFromSource(vShaderCode, fShaderCode);
-                    }
-                );
-            }
-        );
-    }
-
     void Shader::CreateFromSource(const std::string& vertexShaderCode, const std::string& fragmentShaderCode)
     {
         SD_ASSERT(!initialized, "Shader already initialized");
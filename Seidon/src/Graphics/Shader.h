@@ -24,11 +24,10 @@ namespace Seidon
         using Asset::Save;
         using Asset::Load;
 
-        void Save(std::ofstream& out) override;
-        void Load(std::ifstream& in) override;
+        void Save(BinaryWriter& out) override;
+        void Load(BinaryReader& in) override;
 
         void Load(const std::string& path) override;
-        void LoadFromFileAsync(const std::string& path);
 
         void Use();
 
@@ -50,7 +49,6 @@ namespace Seidon
 
         MetaType* bufferLayout;
 
-        static Shader* temporaryShader;
     private:
         void ReadLayout(std::ifstream& stream);
 
@@ -140,7 +140,7 @@ namespace Seidon
         initialized = false;
     }
 
-    void Texture::Save(std::ofstream& out)
+    void Texture::Save(BinaryWriter& out)
     {
         SD_ASSERT(initialized, "Texture not initialized");
 
@@ -170,21 +170,17 @@ namespace Seidon
         Bind(0);
         GL_CHECK(glGetTexImage(GL_TEXTURE_2D, 0, (GLenum)format, GL_UNSIGNED_BYTE, pixels));
 
-        out.write((char*)&id, sizeof(UUID));
+        out.Write(id);
+        out.WriteString(this->path);
 
-        size_t size = this->path.length() + 1;
-        out.write((char*)&size, sizeof(size_t));
-        out.write(this->path.c_str(), size * sizeof(char));
+        out.Write(gammaCorrected);
 
-        out.write((char*)&gammaCorrected, sizeof(bool));
+        out.Write(width);
+        out.Write(height);
+        out.Write(format);
+        out.Write(clampingMode);
 
-        out.write((char*)&width, sizeof(unsigned int));
-        out.write((char*)&height, sizeof(unsigned int));
-        out.write((char*)&format, sizeof(TextureFormat));
-        out.write((char*)&clampingMode, sizeof(ClampingMode));
-
-
-        out.write((char*)pixels, sizeof(byte) * width * height * elementsPerPixel);
+        out.WriteArray(pixels, (size_t)width * height * elementsPerPixel);
 
         delete[] pixels;
     }
@@ -218,58 +214,52 @@ namespace Seidon
 
         Bind(0);
         GL_CHECK(glGetTexImage(GL_TEXTURE_2D, 0, (GLenum)format, GL_UNSIGNED_BYTE, pixels));
-        Application::Get()->GetWorkManager()->Execute([&]()
+        Application::Get()->GetWorkManager()->Execute([this, path, pixels, elementsPerPixel]()
             {
-                std::ofstream out(path, std::ios::out | std::ios::binary);
-
-                out.write((char*)&id, sizeof(UUID));
+                BinaryWriter out(path);
 
-                size_t size = this->path.length() + 1;
-                out.write((char*)&size, sizeof(size_t));
-                out.write(this->path.c_str(), size * sizeof(char));
+                out.Write(id);
+                out.WriteString(this->path);
 
-                out.write((char*)&gammaCorrected, sizeof(bool));
+                out.Write(gammaCorrected);
 
-                out.write((char*)&width, sizeof(unsigned int));
-                out.write((char*)&height, sizeof(unsigned int));
-                out.write((char*)&format, sizeof(TextureFormat));
+                out.Write(width);
+                out.Write(height);
+                out.Write(format);
+                out.Write(clampingMode);
 
-                out.write((char*)pixels, sizeof(byte) * width * height * elementsPerPixel);
+                out.WriteArray(pixels, (size_t)width * height * elementsPerPixel);
 
                 delete[] pixels;
             }
         );
     }
 
-    void Texture::Load(std::ifstream& in)
+    void Texture::Load(BinaryReader& in)
+    {
+        LoadCpuData(in);
+        UploadGpuData();
+    }
+
+    void Texture::LoadCpuData(BinaryReader& in)
     {
         SD_ASSERT(!initialized, "Texture already initialized");
 
-        if (!in)
+        if (!in.IsGood())
         {
             std::cerr << "Error opening texture file: " << path << std::endl;
             return;
         }
 
-        unsigned int width, height;
-        in.read((char*)&id, sizeof(UUID));
+        in.Read(id);
+        in.ReadString(this->path);
 
-        size_t size = 0;
-        in.read((char*)&size, sizeof(size_t));
+        in.Read(gammaCorrected);
 
-        char buffer[2048];
-        in.read(buffer, size * sizeof(char));
-        this->path = buffer;
-
-        in.read((char*)&gammaCorrected, sizeof(bool));
-
-        in.read((char*)&width, sizeof(unsigned int));
-        in.read((char*)&height, sizeof(unsigned int));
-
-        TextureFormat format;
-        in.read((char*)&format, sizeof(TextureFormat));
-
-        in.read((char*)&clampingMode, sizeof(ClampingMode));
+        in.Read(width);
+        in.Read(height);
+        in.Read(format);
+        in.Read(clampingMode);
 
         int elementsPerPixel = 0;
 
@@ -292,87 +282,33 @@ namespace Seidon
             break;
         }
 
-        byte* pixels = new byte[(long long)width * height * elementsPerPixel];
-
-        in.read((char*)pixels, sizeof(byte) * width * height * elementsPerPixel);
-
-
-        TextureFormat internalFormat = format;
+        size_t pixelCount = (size_t)width * height * elementsPerPixel;
 
-        if (gammaCorrected && format == TextureFormat::RGB) internalFormat = TextureFormat::SRGB;
-        if (gammaCorrected && format == TextureFormat::RGBA) internalFormat = TextureFormat::SRGBA;
-
-        Create(width, height, pixels, format, internalFormat, clampingMode);
+        if (!in.IsGood() || pixelCount > in.GetRemainingSize())
+        {
+            std::cerr << "Error reading texture file: " << path << std::endl;
+            return;
+        }
 
-        delete[] pixels;
+        stagingPixels.resize(pixelCount);
+        in.ReadArray(stagingPixels.data(), stagingPixels.size());
     }
 
-    void Texture::LoadAsync(const std::string& path)
+    void Texture::UploadGpuData()
     {
         SD_ASSERT(!initialized, "Texture already initialized");
 
-        renderId = Application::Get()->GetResourceManager()->GetAsset<Texture>("albedo_default")->GetRenderId();
-        Application::Get()->GetWorkManager()->Execute([&]()
-            {
-                std::ifstream in(path, std::ios::in | std::ios::binary);
-
-                unsigned int width, height;
-                in.read((char*)&id, sizeof(UUID));
-
-                size_t size = 0;
-                in.read((char*)&size, sizeof(size_t));
-
-                char buffer[2048];
-                in.read(buffer, size * sizeof(char));
-                this->path = buffer;
-
-                in.read((char*)&gammaCorrected, sizeof(bool));
-
-                in.read((char*)&width, sizeof(unsigned int));
-                in.read((char*)&height, sizeof(unsigned int));
-
-                TextureFormat format;
-                in.read((char*)&format, sizeof(TextureFormat));
-
-                int elementsPerPixel = 0;
-
-                switch (format)
-                {
-                case TextureFormat::RED:
-                    elementsPerPixel = 1;
-                    break;
-
-                case TextureFormat::RED_GREEN:
-                    elementsPerPixel = 2;
-                    break;
-
-                case TextureFormat::RGB: case TextureFormat::SRGB:
-                    elementsPerPixel = 3;
-                    break;
-
-                case TextureFormat::RGBA: case TextureFormat::SRGBA:
-                    elementsPerPixel = 4;
-                    break;
-                }
-
-                byte* pixels = new byte[(long long)width * height * elementsPerPixel];
-
-                in.read((char*)pixels, sizeof(byte) * width * height * elementsPerPixel);
+        if (stagingPixels.empty()) return;
 
+        TextureFormat internalFormat = format;
 
-                TextureFormat internalFormat = format;
+        if (gammaCorrected && format == TextureFormat::RGB) internalFormat = TextureFormat::SRGB;
+        if (gammaCorrected && format == TextureFormat::RGBA) internalFormat = TextureFormat::SRGBA;
 
-                if (gammaCorrected && format == TextureFormat::RGB) internalFormat = TextureFormat::SRGB;
-                if (gammaCorrected && format == TextureFormat::RGBA) internalFormat = TextureFormat::SRGBA;
+        Create(width, height, stagingPixels.data(), format, internalFormat, clampingMode);
 
-                Application::Get()->GetWorkManager()->ExecuteOnMainThread([=]()
-                    {
-                        Create(width, height, pixels, format, internalFormat);
-                        delete[] pixels;
-                    }
-                );
-            }
-        );
+        stagingPixels.clear();
+        stagingPixels.shrink_to_fit();
     }
 
     bool Texture::Import(const std::string& path, bool gammaCorrection, bool flip, ClampingMode clampingMode)
@@ -461,7 +397,8 @@ namespace Seidon
                         {
                             Create(width, height, data, sourceFormat, internalFormat);
                             stbi_image_free(data);
-                        }
+                        },
+                        MainThreadPriority::GPU_UPLOAD
                     );
                 }
                 else
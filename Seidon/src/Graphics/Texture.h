@@ -7,6 +7,7 @@
 #include <StbImage/stb_image.h> 
 
 #include <string>
+#include <vector>
 #include <iostream>
 
 
@@ -59,11 +60,14 @@ namespace Seidon
         using Asset::Save;
         using Asset::Load;
 
-        void Save(std::ofstream& out) override;
+        void Save(BinaryWriter& out) override;
         void SaveAsync(const std::string& path);
 
-        void Load(std::ifstream& in) override;
-        void LoadAsync(const std::string& path);
+        void Load(BinaryReader& in) override;
+
+        bool SupportsAsyncLoad() override { return true; }
+        void LoadCpuData(BinaryReader& in) override;
+        void UploadGpuData() override;
 
         bool Import(const std::string& path, bool gammaCorrection = true, bool flip = true, ClampingMode clampingMode = ClampingMode::CLAMP);
         void ImportAsync(const std::string& path, bool gammaCorrection = true);
@@ -94,6 +98,9 @@ namespace Seidon
         bool gammaCorrected = false;
         bool isResident = false;
 
+        // Pixels read by LoadCpuData, waiting for UploadGpuData on the main thread
+        std::vector<unsigned char> stagingPixels;
+
         static Texture* temporaryTexture;
 
         friend class ResourceManager;
@@ -28,45 +28,25 @@ namespace Seidon
 	{
 		PhysicsApi& api = *Application::Get()->GetPhysicsApi();
 
-		int vertexCount = 0;
-		int indexCount = 0;
-		for (Submesh* submesh : mesh->subMeshes)
-		{
-			vertexCount += submesh->vertices.size();
-			indexCount += submesh->indices.size();
-		}
-
-		std::vector<Vertex> vertices;
-		std::vector<uint32_t> indices;
-
-		vertices.resize(vertexCount);
-		indices.resize(indexCount);
-
-		int vertexOffset = 0;
-		int indexOffset = 0;
-		for (Submesh* submesh : mesh->subMeshes)
-		{
-			memcpy(&vertices[vertexOffset], &submesh->vertices[0], submesh->vertices.size() * sizeof(Vertex));
+		// Packed meshes are already laid out the way the cooking wants them, editable ones are packed first
+		PackedGeometry<Vertex> packedSubmeshes;
+		if (!mesh->IsPacked())
+			packedSubmeshes = Mesh::PackSubmeshes(mesh->subMeshes);
 
-			for (int i = 0; i < submesh->indices.size(); i++)
-				indices[indexOffset + i] = submesh->indices[i] + vertexOffset;
-
-			vertexOffset += submesh->vertices.size();
-			indexOffset += submesh->indices.size();
-		}
+		const PackedGeometry<Vertex>& geometry = mesh->IsPacked() ? mesh->packedGeometry : packedSubmeshes;
 
 		physx::PxTriangleMeshDesc meshDesc;
 		meshDesc.setToDefault();
 
-		meshDesc.points.count = vertices.size();
+		meshDesc.points.count = geometry.vertexCount;
 		meshDesc.points.stride = sizeof(Vertex);
-		meshDesc.points.data = vertices.data();
+		meshDesc.points.data = geometry.vertices;
 
-		meshDesc.triangles.count = indices.size();
+		meshDesc.triangles.count = geometry.indexCount;
 		meshDesc.triangles.stride = 3 * sizeof(int);
-		meshDesc.triangles.data = indices.data();
+		meshDesc.triangles.data = geometry.indices;
 
-		if (indices.size() >= std::numeric_limits<uint16_t>::max())
+		if (geometry.indexCount >= std::numeric_limits<uint16_t>::max())
 		{
 			std::cerr << "Error cooking mesh " << mesh->name << ": index count exceeds the max of " << std::numeric_limits<uint16_t>::max() << std::endl;
 			return false;
@@ -91,31 +71,34 @@ namespace Seidon
 		return status;
 	}
 
-	void MeshCollider::Save(std::ofstream& out)
+	void MeshCollider::Save(BinaryWriter& out)
 	{
-		out.write((char*)&id, sizeof(UUID));
+		out.Write(id);
 
-		size_t size = vertexStream->getSize();
-		out.write((char*)&size, sizeof(size_t));
-		out.write((char*)vertexStream->getData(), size);
+		out.Write((size_t)vertexStream->getSize());
+		out.WriteBytes(vertexStream->getData(), vertexStream->getSize());
 	}
 
-	void MeshCollider::Load(std::ifstream& in)
+	void MeshCollider::Load(BinaryReader& in)
 	{
-		in.read((char*)&id, sizeof(UUID));
+		in.Read(id);
 
-		size_t size = 0;
-		in.read((char*)&size, sizeof(size_t));
+		size_t size = in.ReadCount(1);
 
-		byte* data = new byte[size];
-		in.read((char*)data, size);
+		// Readers working in place hand out the cooked data directly
+		const char* inPlace = in.ReadInPlace(size);
+		if (inPlace)
+			vertexStream->write(inPlace, size);
+		else
+		{
+			std::vector<byte> data(size);
+			in.ReadBytes(data.data(), size);
 
-		vertexStream->write(data, size);
+			vertexStream->write(data.data(), size);
+		}
 
 		PhysicsApi& api = *Application::Get()->GetPhysicsApi();
 		physx::PxDefaultMemoryInputData readBuffer(vertexStream->getData(), vertexStream->getSize());
 		meshData = api.GetPhysics()->createTriangleMesh(readBuffer);
-
-		delete data;
 	}
 }
\ No newline at end of file
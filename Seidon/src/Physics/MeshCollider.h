@@ -26,8 +26,8 @@ namespace Seidon
 		using Asset::Save;
 		using Asset::Load;
 
-		void Save(std::ofstream& out) override;
-		void Load(std::ifstream& in) override;
+		void Save(BinaryWriter& out) override;
+		void Load(BinaryReader& in) override;
 	private:
 		physx::PxTriangleMesh* meshData = nullptr;
 		physx::PxDefaultMemoryOutputStream* vertexStream = nullptr;
@@ -132,6 +132,27 @@ namespace Seidon
 			{
 				DeleteCharacterController(id);
 			});
+
+		/*
+			Inactive entities keep their actors out of the simulation instead of releasing them
+		*/
+		scene->CreateViewAndIterate<InactiveComponent>
+		(
+			[&](EntityId id)
+			{
+				DeactivateActors(id);
+			}
+		);
+
+		inactiveAddedCallbackId = scene->AddComponentAddedCallback<InactiveComponent>([&](EntityId id)
+			{
+				DeactivateActors(id);
+			});
+
+		inactiveRemovedCallbackId = scene->AddComponentRemovedCallback<InactiveComponent>([&](EntityId id)
+			{
+				reactivatedEntities.push_back(id);
+			});
 	}
 	 
 	void PhysicSystem::Update(float deltaTime)
@@ -141,35 +162,31 @@ namespace Seidon
 
 		timeSinceLastStep -= stepSize;
 
-		scene->CreateGroupAndIterate<DynamicRigidbodyComponent>
-		(
-			GetTypeList<TransformComponent>,
+		// The scene marked the transforms moved earlier this frame right before the update, see UpdateTransformsBefore
+		uint32_t sinceVersion = lastChangeVersion;
+		lastChangeVersion = scene->CaptureChangeVersion();
 
-			[&](EntityId e, DynamicRigidbodyComponent& rigidbody, TransformComponent& localTransform)
-			{
-				TransformComponent transform;
-				transform.SetFromMatrix(scene->GetEntityByEntityId(e).GetGlobalTransformMatrix());
+		entt::registry& registry = scene->GetRegistry();
 
-				PxTransform t;
-				t.p = PxVec3(transform.position.x, transform.position.y, transform.position.z);
-				glm::quat q = glm::quat(transform.rotation);
-				t.q = PxQuat(q.x, q.y, q.z, q.w);
+		for (EntityId id : reactivatedEntities)
+			if (registry.valid(id) && !registry.all_of<InactiveComponent>(id))
+				ReactivateActors(id);
 
-				PxRigidDynamic& actor = *rigidbody.actor.physxActor;
-				if (rigidbody.kinematic)
-				{
-					actor.setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, true);
-					actor.setKinematicTarget(t);
-				}
-				else
-				{
-					actor.setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, false);
-					actor.setGlobalPose(t);
-				}
+		reactivatedEntities.clear();
 
-				actor.setRigidDynamicLockFlag(PxRigidDynamicLockFlag::eLOCK_ANGULAR_X, rigidbody.lockXRotation);
-				actor.setRigidDynamicLockFlag(PxRigidDynamicLockFlag::eLOCK_ANGULAR_Y, rigidbody.lockYRotation);
-				actor.setRigidDynamicLockFlag(PxRigidDynamicLockFlag::eLOCK_ANGULAR_Z, rigidbody.lockZRotation);
+		// Only bodies moved or edited since the last step are looked at, and only the ones that don't match their actor anymore
+		// are pushed to PhysX. The others, including the bodies moved by the last step, keep their simulated pose and can sleep
+		scene->IterateChanged<TransformComponent>(sinceVersion, [&](EntityId e, TransformComponent&)
+			{
+				if (registry.all_of<DynamicRigidbodyComponent>(e) && !registry.all_of<InactiveComponent>(e))
+					SyncDynamicRigidbody(e);
+			}
+		);
+
+		scene->IterateChanged<DynamicRigidbodyComponent>(sinceVersion, [&](EntityId e, DynamicRigidbodyComponent&)
+			{
+				if (registry.all_of<TransformComponent>(e) && !registry.all_of<InactiveComponent>(e))
+					SyncDynamicRigidbody(e);
 			}
 		);
 		
@@ -205,18 +222,165 @@ namespace Seidon
 				TransformComponent worldTransform;
 				worldTransform.SetFromMatrix(e.GetGlobalTransformMatrix());
 				worldTransform.position = glm::vec3(transform.p.x, transform.p.y, transform.p.z);
-				worldTransform.rotation = glm::eulerAngles(glm::quat(transform.q.w, transform.q.x, transform.q.y, transform.q.z));
+				worldTransform.rotation = glm::quat(transform.q.w, transform.q.x, transform.q.y, transform.q.z);
 
 				localTransform.SetFromMatrix(glm::inverse(e.GetParent().GetGlobalTransformMatrix()) * worldTransform.GetTransformMatrix());
 			}
 			else
 			{
 				localTransform.position = glm::vec3(transform.p.x, transform.p.y, transform.p.z);
-				localTransform.rotation = glm::eulerAngles(glm::quat(transform.q.w, transform.q.x, transform.q.y, transform.q.z));
+				localTransform.rotation = glm::quat(transform.q.w, transform.q.x, transform.q.y, transform.q.z);
 			}
 		}
 	}
 
+	void PhysicSystem::SyncDynamicRigidbody(EntityId id)
+	{
+		Entity e = scene->GetEntityByEntityId(id);
+		DynamicRigidbodyComponent& rigidbody = e.GetComponent<DynamicRigidbodyComponent>();
+
+		TransformComponent transform;
+		transform.SetFromMatrix(e.GetGlobalTransformMatrix());
+
+		PxTransform t;
+		t.p = PxVec3(transform.position.x, transform.position.y, transform.position.z);
+		glm::quat q = transform.rotation;
+		t.q = PxQuat(q.x, q.y, q.z, q.w);
+
+		PxRigidDynamic& actor = *rigidbody.actor.physxActor;
+
+		// Setting the pose again would wake the body up, and the transform still holds what the last step wrote back
+		if (MatchesActor(actor, rigidbody, t)) return;
+
+		if (rigidbody.kinematic)
+		{
+			actor.setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, true);
+			actor.setKinematicTarget(t);
+		}
+		else
+		{
+			actor.setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, false);
+			actor.setGlobalPose(t);
+		}
+
+		actor.setRigidDynamicLockFlag(PxRigidDynamicLockFlag::eLOCK_ANGULAR_X, rigidbody.lockXRotation);
+		actor.setRigidDynamicLockFlag(PxRigidDynamicLockFlag::eLOCK_ANGULAR_Y, rigidbody.lockYRotation);
+		actor.setRigidDynamicLockFlag(PxRigidDynamicLockFlag::eLOCK_ANGULAR_Z, rigidbody.lockZRotation);
+	}
+
+	bool PhysicSystem::MatchesActor(const PxRigidDynamic& actor, const DynamicRigidbodyComponent& rigidbody, const PxTransform& pose)
+	{
+		PxRigidBodyFlags flags = actor.getRigidBodyFlags();
+		if (rigidbody.kinematic != flags.isSet(PxRigidBodyFlag::eKINEMATIC)) return false;
+
+		PxRigidDynamicLockFlags lockFlags = actor.getRigidDynamicLockFlags();
+		if (rigidbody.lockXRotation != lockFlags.isSet(PxRigidDynamicLockFlag::eLOCK_ANGULAR_X) ||
+			rigidbody.lockYRotation != lockFlags.isSet(PxRigidDynamicLockFlag::eLOCK_ANGULAR_Y) ||
+			rigidbody.lockZRotation != lockFlags.isSet(PxRigidDynamicLockFlag::eLOCK_ANGULAR_Z))
+			return false;
+
+		// Poses written back to parented transforms go through a matrix, so they only come back approximately
+		PxTransform actorPose = actor.getGlobalPose();
+		return (actorPose.p - pose.p).magnitudeSquared() < poseTolerance * poseTolerance &&
+			PxAbs(actorPose.q.dot(pose.q)) > 1.0f - poseTolerance;
+	}
+
+	void PhysicSystem::DeactivateActors(EntityId id)
+	{
+		Entity e = scene->GetEntityByEntityId(id);
+
+		if (e.HasComponent<StaticRigidbodyComponent>())
+		{
+			StaticRigidbodyComponent& r = e.GetComponent<StaticRigidbodyComponent>();
+			if (r.actor.IsInitialized()) SetActorEnabled(r.actor.GetInternalActor(), false);
+		}
+
+		if (e.HasComponent<DynamicRigidbodyComponent>())
+		{
+			DynamicRigidbodyComponent& r = e.GetComponent<DynamicRigidbodyComponent>();
+			if (r.actor.IsInitialized()) SetActorEnabled(r.actor.GetInternalActor(), false);
+		}
+
+		if (e.HasComponent<CharacterControllerComponent>())
+		{
+			CharacterControllerComponent& c = e.GetComponent<CharacterControllerComponent>();
+			if (c.runtimeController.IsInitialized())
+				SetActorEnabled(c.runtimeController.GetInternalController()->getActor(), false);
+		}
+	}
+
+	void PhysicSystem::ReactivateActors(EntityId id)
+	{
+		Entity e = scene->GetEntityByEntityId(id);
+
+		TransformComponent transform;
+		transform.SetFromMatrix(e.GetGlobalTransformMatrix());
+
+		PxTransform t;
+		t.p = PxVec3(transform.position.x, transform.position.y, transform.position.z);
+		t.q = PxQuat(transform.rotation.x, transform.rotation.y, transform.rotation.z, transform.rotation.w);
+
+		if (e.HasComponent<StaticRigidbodyComponent>())
+		{
+			StaticRigidbodyComponent& r = e.GetComponent<StaticRigidbodyComponent>();
+
+			if (r.actor.IsInitialized())
+			{
+				PxRigidActor* actor = r.actor.GetInternalActor();
+				SetActorEnabled(actor, true);
+				actor->setGlobalPose(t);
+			}
+		}
+
+		if (e.HasComponent<DynamicRigidbodyComponent>())
+		{
+			DynamicRigidbodyComponent& r = e.GetComponent<DynamicRigidbodyComponent>();
+
+			if (r.actor.IsInitialized())
+			{
+				PxRigidDynamic* actor = r.actor.GetInternalActor();
+				SetActorEnabled(actor, true);
+
+				SyncDynamicRigidbody(id);
+
+				// Pooled bodies start over instead of carrying the velocity they had when released
+				if (!r.kinematic)
+				{
+					actor->setLinearVelocity(PxVec3(0.0f));
+					actor->setAngularVelocity(PxVec3(0.0f));
+				}
+			}
+		}
+
+		if (e.HasComponent<CharacterControllerComponent>())
+		{
+			CharacterControllerComponent& c = e.GetComponent<CharacterControllerComponent>();
+
+			if (c.runtimeController.IsInitialized())
+			{
+				PxController* controller = c.runtimeController.GetInternalController();
+				SetActorEnabled(controller->getActor(), true);
+
+				glm::vec3 position = transform.position + c.offset;
+				controller->setPosition(PxExtendedVec3(position.x, position.y, position.z));
+			}
+		}
+	}
+
+	void PhysicSystem::SetActorEnabled(PxRigidActor* actor, bool enabled)
+	{
+		actor->setActorFlag(PxActorFlag::eDISABLE_SIMULATION, !enabled);
+
+		// Shapes of disabled actors would still be hit by raycasts, sweeps and character controllers.
+		// Every shape the system creates is a scene query shape, so enabling just restores the flag
+		PxU32 shapeCount = actor->getNbShapes();
+		std::vector<PxShape*> shapes(shapeCount);
+		actor->getShapes(shapes.data(), shapeCount);
+
+		for (PxShape* shape : shapes)
+			shape->setFlag(PxShapeFlag::eSCENE_QUERY_SHAPE, enabled);
+	}
+
 	void PhysicSystem::Destroy()
 	{
 		scene->CreateViewAndIterate<StaticRigidbodyComponent>
@@ -264,6 +428,9 @@ namespace Seidon
 		scene->RemoveComponentRemovedCallback<StaticRigidbodyComponent>(staticRigidbodyRemovedCallbackId);
 		scene->RemoveComponentRemovedCallback<DynamicRigidbodyComponent>(dynamicRigidbodyRemovedCallbackId);
 		scene->RemoveComponentRemovedCallback<CharacterControllerComponent>(characterControllerRemovedCallbackId);
+
+		scene->RemoveComponentAddedCallback<InactiveComponent>(inactiveAddedCallbackId);
+		scene->RemoveComponentRemovedCallback<InactiveComponent>(inactiveRemovedCallbackId);
 	}
 
 
@@ -279,7 +446,7 @@ namespace Seidon
 		PxTransform t;
 		t.p = PxVec3(position.x, position.y, position.z);
 
-		glm::quat rot = glm::quat(transform.rotation);
+		glm::quat rot = transform.rotation;
 		t.q = PxQuat(rot.x, rot.y, rot.z, rot.w);
 
 		glm::vec3 size = transform.scale;
@@ -386,7 +553,7 @@ namespace Seidon
 		PxTransform t;
 		t.p = PxVec3(transform.position.x, transform.position.y, transform.position.z);
 
-		glm::quat rot = glm::quat(transform.rotation);
+		glm::quat rot = transform.rotation;
 		t.q = PxQuat(rot.x, rot.y, rot.z, rot.w);
 
 		PxRigidStatic* actor = physics->createRigidStatic(t);
@@ -423,7 +590,7 @@ namespace Seidon
 		PxTransform t;
 		t.p = PxVec3(transform.position.x, transform.position.y, transform.position.z);
 
-		glm::quat rot = glm::quat(transform.rotation);
+		glm::quat rot = transform.rotation;
 		t.q = PxQuat(rot.x, rot.y, rot.z, rot.w);
 
 		PxRigidDynamic* actor = physics->createRigidDynamic(t);
@@ -18,6 +18,9 @@ namespace Seidon
 	private:
 		static constexpr float stepSize = 1.0f / 60.0f;
 
+		// Transforms closer than this to their actor's pose are not pushed to PhysX again
+		static constexpr float poseTolerance = 1e-4f;
+
 		PhysicsApi* api;
 
 		physx::PxPhysics* physics;
@@ -41,7 +44,16 @@ namespace Seidon
 		ComponentCallbackId dynamicRigidbodyRemovedCallbackId;
 		ComponentCallbackId characterControllerRemovedCallbackId;
 
+		ComponentCallbackId inactiveAddedCallbackId;
+		ComponentCallbackId inactiveRemovedCallbackId;
+
 		float timeSinceLastStep = 0;
+
+		// Change version captured at the last step, 0 syncs every body on the first step
+		uint32_t lastChangeVersion = 0;
+
+		// Put back into the simulation at the next step, once their transforms are up to date
+		std::vector<EntityId> reactivatedEntities;
 	public:
 		PhysicSystem() = default;
 
@@ -61,6 +73,15 @@ namespace Seidon
 		void DeleteStaticRigidbody(EntityId id);
 		void DeleteDynamicRigidbody(EntityId id);
 		void DeleteCharacterController(EntityId id);
+
+		void SyncDynamicRigidbody(EntityId id);
+		static bool MatchesActor(const physx::PxRigidDynamic& actor, const DynamicRigidbodyComponent& rigidbody, const physx::PxTransform& pose);
+
+		void DeactivateActors(EntityId id);
+		void ReactivateActors(EntityId id);
+
+		// Takes the actor out of the simulation and the scene queries while keeping it alive, or puts it back
+		static void SetActorEnabled(physx::PxRigidActor* actor, bool enabled);
 	};
 
 }
\ No newline at end of file
@@ -1,674 +1,442 @@
 #include "Reflection.h"
 
 #include "../Core/Application.h"
+#include "../Debug/Debug.h"
+
+#include <algorithm>
 
 namespace Seidon
 {
-	void MetaType::Save(std::ofstream& out, byte* data)
+	void MetaType::Save(BinaryWriter& out, byte* data)
 	{
-		size_t nameSize = name.length() + 1;
-
-		out.write((char*)&nameSize, sizeof(size_t));
-		out.write(name.c_str(), nameSize * sizeof(char));
+		SD_ASSERT(plan.memberCount == members.size(), "Serialization plan out of date, call Compile after changing the members");
 
-		size_t memberCount = members.size();
-		out.write((char*)&memberCount, sizeof(size_t));
+		out.WriteString(name);
+		out.Write(members.size());
 
-		for (MemberData& m : members)
+		for (size_t i = 0; i < members.size(); i++)
 		{
-			out.write((char*)&m.type, sizeof(Types));
-			switch (m.type)
-			{
-			case Types::ID:
-			{
-				UUID* item = (UUID*)&data[m.offset];
-				out.write((char*)item, sizeof(UUID));
-				break;
-			}
-			case Types::ID_VECTOR:
-			{
-				std::vector<UUID>* item = (std::vector<UUID>*) &data[m.offset];
+			out.Write(members[i].type);
+			SaveStep(out, plan.memberSteps[i], data);
+		}
+	}
 
-				size_t size = item->size();
-				out.write((char*)&size, sizeof(size_t));
+	void MetaType::Load(BinaryReader& in, byte* data)
+	{
+		SD_ASSERT(plan.memberCount == members.size(), "Serialization plan out of date, call Compile after changing the members");
 
-				for (UUID& id : *item)
-					out.write((char*)&id, sizeof(UUID));
-				break;
-			}
-			case Types::STRING:
-			{
-				std::string* item = (std::string*)&data[m.offset];
-				size_t size = item->length() + 1;
+		ResourceManager& resourceManager = *Application::Get()->GetResourceManager();
 
-				out.write((char*)&size, sizeof(size_t));
-				out.write(item->c_str(), size * sizeof(char));
-				break;
-			}
-			case Types::FLOAT: case Types::FLOAT_NORMALIZED: case Types::FLOAT_ANGLE:
-			{
-				float* item = (float*)&data[m.offset];
-				out.write((char*)item, sizeof(float));
-				break;
-			}
-			case Types::INT:
-			{
-				int* item = (int*)&data[m.offset];
-				out.write((char*)item, sizeof(int));
-				break;
-			}
-			case Types::BOOL:
-			{
-				bool* item = (bool*)&data[m.offset];
-				out.write((char*)item, sizeof(bool));
-				break;
-			}
-			case Types::VECTOR2: case Types::VECTOR2_ANGLES:
-			{
-				glm::vec2* item = (glm::vec2*)&data[m.offset];
-				out.write((char*)item, sizeof(glm::vec2));
-				break;
-			}
-			case Types::VECTOR3: case Types::VECTOR3_ANGLES: case Types::VECTOR3_COLOR:
-			{
-				glm::vec3* item = (glm::vec3*)&data[m.offset];
-				out.write((char*)item, sizeof(glm::vec3));
-				break;
-			}
-			case Types::VECTOR4: case Types::VECTOR4_COLOR:
-			{
-				glm::vec4* item = (glm::vec4*)&data[m.offset];
-				out.write((char*)item, sizeof(glm::vec4));
-				break;
-			}
-			case Types::TEXTURE:
-			{
-				Texture* item = *(Texture**)&data[m.offset];
-				UUID id = item->GetId();
-				out.write((char*)&id, sizeof(UUID));
-				break;
-			}
-			case Types::TEXTURE_VECTOR:
-			{
-				std::vector<Texture*>* item = (std::vector<Texture*>*) & data[m.offset];
+		if (name != in.ReadString())
+			std::cerr << "Save metatype name is different from current metatype name, data might not load correctly" << std::endl;
 
-				size_t size = item->size();
-				out.write((char*)&size, sizeof(size_t));
+		size_t memberCount = in.Read<size_t>();
 
-				for (Texture* t : *item)
-				{
-					UUID id = t->GetId();
-					out.write((char*)&id, sizeof(UUID));
-				}
-				break;
-			}
-			case Types::MESH:
-			{
-				Mesh* item = *(Mesh**)&data[m.offset];
-				UUID id = item->id;
-				out.write((char*)&id, sizeof(UUID));
-				break;
-			}
-			case Types::MESH_VECTOR:
-			{
-				std::vector<Mesh*>* item = (std::vector<Mesh*>*) & data[m.offset];
+		if (members.size() != memberCount)
+		{
+			std::cerr << "Save metatype member count is different from current metatype member count, aborting data load" << std::endl;
+			return;
+		}
 
-				size_t size = item->size();
-				out.write((char*)&size, sizeof(size_t));
+		AssetResolver assets;
 
-				for (Mesh* m : *item)
-				{
-					UUID id = m->id;
-					out.write((char*)&id, sizeof(UUID));
-				}
-				break;
-			}
-			case Types::SKINNED_MESH:
-			{
-				SkinnedMesh* item = *(SkinnedMesh**)&data[m.offset];
-				UUID id = item->id;
-				out.write((char*)&id, sizeof(UUID));
-				break;
-			}
-			case Types::SKINNED_MESH_VECTOR:
-			{
-				std::vector<SkinnedMesh*>* item = (std::vector<SkinnedMesh*>*) & data[m.offset];
+		for (size_t i = 0; i < members.size(); i++)
+		{
+			MemberData& m = members[i];
 
-				size_t size = item->size();
-				out.write((char*)&size, sizeof(size_t));
+			Types type;
+			in.Read(type);
 
-				for (SkinnedMesh* m : *item)
-				{
-					UUID id = m->id;
-					out.write((char*)&id, sizeof(UUID));
-				}
-				break;
-			}
-			case Types::MATERIAL:
-			{
-				Material* item = *(Material**)&data[m.offset];
-				UUID id = item->id;
-				out.write((char*)&id, sizeof(UUID));
-				break;
-			}
-			case Types::MATERIAL_VECTOR:
+			// Rotations used to be saved as euler angles
+			if (m.type == Types::QUATERNION && type == Types::VECTOR3_ANGLES)
 			{
-				std::vector<Material*>* item = (std::vector<Material*>*) & data[m.offset];
-
-				size_t size = item->size();
-				out.write((char*)&size, sizeof(size_t));
+				glm::vec3 angles;
+				in.Read(angles);
 
-				for (Material* m : *item)
-				{
-					UUID id = m->id;
-					out.write((char*)&id, sizeof(UUID));
-				}
-				break;
-			}
-			case Types::CUBEMAP:
-			{
-				HdrCubemap* item = *(HdrCubemap**)&data[m.offset];
-				UUID id = item->GetId();
-				out.write((char*)&id, sizeof(UUID));
-				break;
-			}
-			case Types::ANIMATION:
-			{
-				Animation* item = *(Animation**)&data[m.offset];
-				UUID id = item->id;
-				out.write((char*)&id, sizeof(UUID));
-				break;
+				*(glm::quat*)&data[m.offset] = glm::quat(angles);
+				continue;
 			}
-			case Types::SHADER:
-			{
-				Shader* item = *(Shader**)&data[m.offset];
-				UUID id = item->GetId();
-				out.write((char*)&id, sizeof(UUID));
-				break;
-			}
-			case Types::FONT:
-			{
-				Font* item = *(Font**)&data[m.offset];
-				UUID id = item->GetId();
-				out.write((char*)&id, sizeof(UUID));
-				break;
-			}
-			case Types::MESH_COLLIDER:
-			{
-				MeshCollider* item = *(MeshCollider**)&data[m.offset];
-				UUID id = item->id;
-				out.write((char*)&id, sizeof(UUID));
-				break;
-			}
-			case Types::SOUND:
+
+			if (m.type != type)
 			{
-				Sound* item = *(Sound**)&data[m.offset];
-				UUID id = item->id;
-				out.write((char*)&id, sizeof(UUID));
-				break;
-			}
-			case Types::UNKNOWN:
-				break;
+				std::cerr << "Save member type is different from current member, aborting data load" << std::endl;
+				return;
 			}
+
+			LoadStep(in, plan.memberSteps[i], data, assets);
+		}
+
+		// Referenced assets may still be loading, OnChange usually reads them
+		if (OnChange)
+		{
+			void (*onChange)(void*) = OnChange;
+			resourceManager.RunAfterLoadBatch([onChange, data]() { onChange(data); });
 		}
 	}
 
-	void MetaType::Load(std::ifstream& in, byte* data)
+	void MetaType::SaveMembers(BinaryWriter& out, byte* data)
 	{
-		ResourceManager& resourceManager = *Application::Get()->GetResourceManager();
+		void* instance = data;
+		SaveMembers(out, &instance, 1);
+	}
 
-		size_t nameSize = 0;
-		char buffer[512];
+	void MetaType::SaveMembers(BinaryWriter& out, void* const* instances, size_t count)
+	{
+		SD_ASSERT(plan.memberCount == members.size(), "Serialization plan out of date, call Compile after changing the members");
 
-		in.read((char*)&nameSize, sizeof(size_t));
-		in.read(buffer, nameSize * sizeof(char));
+		for (size_t i = 0; i < count; i++)
+			for (const SerializationStep& step : plan.steps)
+				SaveStep(out, step, (byte*)instances[i]);
+	}
 
-		if (name != std::string(buffer))
-			std::cerr << "Save metatype name is different from current metatype name, data might not load correctly" << std::endl;
+	// OnChange is not called, the data is usually a staging copy that the caller moves into the scene
+	void MetaType::LoadMembers(BinaryReader& in, byte* data, AssetResolver& assets)
+	{
+		void* instance = data;
+		LoadMembers(in, &instance, 1, assets);
+	}
 
-		size_t memberCount = 0;
-		in.read((char*)&memberCount, sizeof(size_t));
+	void MetaType::LoadMembers(BinaryReader& in, void* const* instances, size_t count, AssetResolver& assets)
+	{
+		SD_ASSERT(plan.memberCount == members.size(), "Serialization plan out of date, call Compile after changing the members");
 
-		if (members.size() != memberCount)
+		// Without variable size members the instances take the same space, all of them are read from a single block
+		const char* block = nullptr;
+
+		if (!plan.variableSize && in.IsInPlace())
 		{
-			std::cerr << "Save metatype member count is different from current metatype member count, aborting data load" << std::endl;
-			return;
+			block = in.ReadInPlace(count * plan.fixedSize);
+			if (!block) return;
 		}
 
-		for (MemberData& m : members)
+		if (!block)
 		{
-			Types type;
-			in.read((char*)&type, sizeof(Types));
+			for (size_t i = 0; i < count; i++)
+				for (const SerializationStep& step : plan.steps)
+					LoadStep(in, step, (byte*)instances[i], assets);
 
-			if (m.type != type)
-			{
-				std::cerr << "Save member type is different from current member, aborting data load" << std::endl;
-				return;
-			}
+			return;
+		}
 
-			switch (m.type)
-			{
-			case Types::ID:
-			{
-				UUID item;
-				in.read((char*)&item, sizeof(UUID));
+		for (size_t i = 0; i < count; i++)
+		{
+			byte* data = (byte*)instances[i];
 
-				*(UUID*)&data[m.offset] = item;
-				break;
-			}
-			case Types::ID_VECTOR:
+			for (const SerializationStep& step : plan.steps)
 			{
-				size_t size;
-				in.read((char*)&size, sizeof(size_t));
-
-				std::vector<UUID> item;
-				item.reserve(size);
-
-				for (int i = 0; i < size; i++)
+				if (step.operation == SerializationStep::Operation::COPY)
 				{
-					UUID id;
-					in.read((char*)&id, sizeof(UUID));
-
-					item.push_back(id);
+					memcpy(&data[step.offset], block, step.size);
+					block += step.size;
+					continue;
 				}
 
-				*(std::vector<UUID>*)& data[m.offset] = item;
-				break;
+				UUID id;
+				memcpy(&id, block, sizeof(UUID));
+				block += sizeof(UUID);
+
+				assets.Set(&data[step.offset], step.asset->type, id);
 			}
-			case Types::STRING:
-			{
-				size_t size;
-				in.read((char*)&size, sizeof(size_t));
+		}
+	}
 
-				char buffer[1024];
-				in.read(buffer, size * sizeof(char));
+	void MetaType::LoadMembers(BinaryReader& in, byte* data, const std::vector<MemberData>& savedMembers, AssetResolver& assets)
+	{
+		SD_ASSERT(plan.memberCount == members.size(), "Serialization plan out of date, call Compile after changing the members");
 
-				*(std::string*)&data[m.offset] = buffer;
-				break;
-			}
-			case Types::FLOAT: case Types::FLOAT_NORMALIZED: case Types::FLOAT_ANGLE:
-			{
-				float item;
-				in.read((char*)&item, sizeof(float));
+		for (const MemberData& saved : savedMembers)
+		{
+			size_t index = 0;
+			while (index < members.size() && members[index].name != saved.name)
+				index++;
 
-				*(float*)&data[m.offset] = item;
-				break;
-			}
-			case Types::INT:
+			if (index == members.size())
 			{
-				int item;
-				in.read((char*)&item, sizeof(int));
-
-				*(int*)&data[m.offset] = item;
-				break;
+				SkipMember(in, saved.type);
+				continue;
 			}
-			case Types::BOOL:
-			{
-				bool item;
-				in.read((char*)&item, sizeof(bool));
 
-				*(bool*)&data[m.offset] = item;
-				break;
-			}
-			case Types::VECTOR2: case Types::VECTOR2_ANGLES:
-			{
-				glm::vec3 item;
-				in.read((char*)&item, sizeof(glm::vec2));
+			const MemberData& m = members[index];
 
-				*(glm::vec2*)&data[m.offset] = item;
-				break;
-			}
-			case Types::VECTOR3: case Types::VECTOR3_ANGLES: case Types::VECTOR3_COLOR:
+			// Rotations used to be saved as euler angles
+			if (m.type == Types::QUATERNION && saved.type == Types::VECTOR3_ANGLES)
 			{
-				glm::vec3 item;
-				in.read((char*)&item, sizeof(glm::vec3));
+				glm::vec3 angles;
+				in.Read(angles);
 
-				*(glm::vec3*)&data[m.offset] = item;
-				break;
+				*(glm::quat*)&data[m.offset] = glm::quat(angles);
+				continue;
 			}
-			case Types::VECTOR4: case Types::VECTOR4_COLOR:
-			{
-				glm::vec4 item;
-				in.read((char*)&item, sizeof(glm::vec4));
 
-				*(glm::vec4*)&data[m.offset] = item;
-				break;
-			}
-			case Types::TEXTURE:
+			if (m.type != saved.type)
 			{
-				UUID id;
-				in.read((char*)&id, sizeof(UUID));
+				SkipMember(in, saved.type);
+				continue;
+			}
 
-				if(resourceManager.IsAssetRegistered(id))
-					*(Texture**)&data[m.offset] = resourceManager.GetOrLoadAsset<Texture>(id);
-				else
-				{
-					std::cerr << "Error loading member " << m.name << " of " << name << ": Texture id not registered" << std::endl;
-					*(Texture**)&data[m.offset] = resourceManager.GetAsset<Texture>("albedo_default");
-				}
+			LoadStep(in, plan.memberSteps[index], data, assets);
+		}
+	}
 
-				break;
-			}
-			case Types::TEXTURE_VECTOR:
-			{
-				size_t size;
-				in.read((char*)&size, sizeof(size_t));
+	void MetaType::SaveStep(BinaryWriter& out, const SerializationStep& step, byte* data)
+	{
+		switch (step.operation)
+		{
+		case SerializationStep::Operation::COPY:
+			out.WriteBytes(&data[step.offset], step.size);
+			break;
+		case SerializationStep::Operation::STRING:
+			out.WriteString(*(std::string*)&data[step.offset]);
+			break;
+		case SerializationStep::Operation::ID_VECTOR:
+			out.WriteVector(*(std::vector<UUID>*)&data[step.offset]);
+			break;
+		case SerializationStep::Operation::ASSET:
+			out.Write(step.asset->GetId(*(void**)&data[step.offset]));
+			break;
+		case SerializationStep::Operation::ASSET_VECTOR:
+			step.asset->SaveVector(out, &data[step.offset]);
+			break;
+		}
+	}
 
-				std::vector<Texture*> item;
-				item.reserve(size);
+	void MetaType::LoadStep(BinaryReader& in, const SerializationStep& step, byte* data, AssetResolver& assets)
+	{
+		switch (step.operation)
+		{
+		case SerializationStep::Operation::COPY:
+			in.ReadBytes(&data[step.offset], step.size);
+			break;
+		case SerializationStep::Operation::STRING:
+			in.ReadString(*(std::string*)&data[step.offset]);
+			break;
+		case SerializationStep::Operation::ID_VECTOR:
+			in.ReadVector(*(std::vector<UUID>*)&data[step.offset]);
+			break;
+		case SerializationStep::Operation::ASSET:
+		{
+			UUID id;
+			in.Read(id);
 
-				for (int i = 0; i < size; i++)
-				{
-					UUID id;
-					in.read((char*)&id, sizeof(UUID));
-
-					if (resourceManager.IsAssetRegistered(id))
-						item.push_back(resourceManager.GetOrLoadAsset<Texture>(id));
-					else
-					{
-						std::cerr << "Error loading member " << m.name << "[" << i << "] of " << name << ": Texture id not registered" << std::endl;
-						item.push_back(resourceManager.GetAsset<Texture>("albedo_default"));
-					}
-				}
+			assets.Set(&data[step.offset], step.asset->type, id);
+			break;
+		}
+		case SerializationStep::Operation::ASSET_VECTOR:
+			step.asset->LoadVector(in, &data[step.offset], assets);
+			break;
+		}
+	}
 
-				*(std::vector<Texture*>*)& data[m.offset] = item;
-				break;
-			}
-			case Types::MESH:
-			{
-				UUID id;
-				in.read((char*)&id, sizeof(UUID));
+	void MetaType::SkipMember(BinaryReader& in, Types type)
+	{
+		size_t size = GetPlainDataSize(type);
 
-				if (resourceManager.IsAssetRegistered(id))
-					*(Mesh**)&data[m.offset] = resourceManager.GetOrLoadAsset<Mesh>(id);
-				else
-				{
-					std::cerr << "Error loading member " << m.name << " of " << name << ": Mesh id not registered" << std::endl;
-					*(Mesh**)&data[m.offset] = resourceManager.GetAsset<Mesh>("empty_mesh");
-				}
+		if (size > 0)
+		{
+			in.Skip(size);
+			return;
+		}
 
-				break;
-			}
-			case Types::MESH_VECTOR:
-			{
-				size_t size;
-				in.read((char*)&size, sizeof(size_t));
+		switch (type)
+		{
+		case Types::STRING:
+			in.Skip(in.Read<size_t>());
+			break;
+		case Types::ID_VECTOR: case Types::TEXTURE_VECTOR: case Types::MESH_VECTOR: case Types::SKINNED_MESH_VECTOR: case Types::MATERIAL_VECTOR:
+			in.Skip(in.ReadCount(sizeof(UUID)) * sizeof(UUID));
+			break;
+		case Types::TEXTURE: case Types::MESH: case Types::SKINNED_MESH: case Types::MATERIAL: case Types::CUBEMAP: case Types::ANIMATION:
+		case Types::SHADER: case Types::FONT: case Types::MESH_COLLIDER: case Types::SOUND:
+			in.Skip(sizeof(UUID));
+			break;
+		default:
+			break;
+		}
+	}
 
-				std::vector<Mesh*> item;
-				item.reserve(size);
+	uint64_t MetaType::GetSchemaHash()
+	{
+		SD_ASSERT(plan.memberCount == members.size(), "Serialization plan out of date, call Compile after changing the members");
 
-				for (int i = 0; i < size; i++)
-				{
-					UUID id;
-					in.read((char*)&id, sizeof(UUID));
-
-					if (resourceManager.IsAssetRegistered(id))
-						item.push_back(resourceManager.GetOrLoadAsset<Mesh>(id));
-					else
-					{
-						std::cerr << "Error loading member " << m.name << "[" << i << "] of " << name << ": Mesh id not registered" << std::endl;
-						item.push_back(resourceManager.GetAsset<Mesh>("empty_mesh"));
-					}
-				}
+		return plan.schemaHash;
+	}
 
-				*(std::vector<Mesh*>*)& data[m.offset] = item;
-				break;
-			}
-			case Types::SKINNED_MESH:
-			{
-				UUID id;
-				in.read((char*)&id, sizeof(UUID));
+	template <typename T>
+	static UUID GetAssetId(const void* asset)
+	{
+		return ((const T*)asset)->id;
+	}
 
-				if (resourceManager.IsAssetRegistered(id))
-					*(SkinnedMesh**)&data[m.offset] = resourceManager.GetOrLoadAsset<SkinnedMesh>(id);
-				else
-				{
-					std::cerr << "Error loading member " << m.name << " of " << name << ": Skinned mesh id not registered" << std::endl;
-					*(SkinnedMesh**)&data[m.offset] = resourceManager.GetAsset<SkinnedMesh>("empty_skinned_mesh");
-				}
+	template <typename T>
+	static void SaveAssetVector(BinaryWriter& out, const void* vector)
+	{
+		const std::vector<T*>& assets = *(const std::vector<T*>*)vector;
 
-				break;
-			}
-			case Types::SKINNED_MESH_VECTOR:
-			{
-				size_t size;
-				in.read((char*)&size, sizeof(size_t));
+		out.Write(assets.size());
 
-				std::vector<SkinnedMesh*> item;
-				item.reserve(size);
+		for (T* asset : assets)
+			out.Write(asset->id);
+	}
 
-				for (int i = 0; i < size; i++)
-				{
-					UUID id;
-					in.read((char*)&id, sizeof(UUID));
-
-					if (resourceManager.IsAssetRegistered(id))
-						item.push_back(resourceManager.GetOrLoadAsset<SkinnedMesh>(id));
-					else
-					{
-						std::cerr << "Error loading member " << m.name << "[" << i << "] of " << name << ": Skinned mesh id not registered" << std::endl;
-						item.push_back(resourceManager.GetAsset<SkinnedMesh>("empty_skinned_mesh"));
-					}
-				}
+	template <typename T, Types type>
+	static void LoadAssetVector(BinaryReader& in, void* vector, AssetResolver& assets)
+	{
+		std::vector<T*>& loaded = *(std::vector<T*>*)vector;
+		loaded.assign(in.ReadCount(sizeof(UUID)), nullptr);
 
-				*(std::vector<SkinnedMesh*>*)& data[m.offset] = item;
-				break;
-			}
-			case Types::MATERIAL:
-			{
-				UUID id;
-				in.read((char*)&id, sizeof(UUID));
+		for (T*& asset : loaded)
+		{
+			UUID id;
+			in.Read(id);
 
-				if (resourceManager.IsAssetRegistered(id))
-					*(Material**)&data[m.offset] = resourceManager.GetOrLoadAsset<Material>(id);
-				else
-				{
-					std::cerr << "Error loading member " << m.name << " of " << name << ": Material id not registered" << std::endl;
-					*(Material**)&data[m.offset] = resourceManager.GetAsset<Material>("default_material");
-				}
+			assets.Set(&asset, type, id);
+		}
+	}
 
-				break;
-			}
-			case Types::MATERIAL_VECTOR:
-			{
-				size_t size;
-				in.read((char*)&size, sizeof(size_t));
+	template <typename T>
+	static size_t GetAssetVectorSize(const void* vector)
+	{
+		return ((const std::vector<T*>*)vector)->size();
+	}
 
-				std::vector<Material*> item;
-				item.reserve(size);
+	template <typename T, Types type>
+	static const AssetSerializer* GetAssetSerializer()
+	{
+		static const AssetSerializer serializer = { type, &GetAssetId<T>, &SaveAssetVector<T>, &LoadAssetVector<T, type>, &GetAssetVectorSize<T> };
+		return &serializer;
+	}
 
-				for (int i = 0; i < size; i++)
-				{
-					UUID id;
-					in.read((char*)&id, sizeof(UUID));
-
-					if (resourceManager.IsAssetRegistered(id))
-						item.push_back(resourceManager.GetOrLoadAsset<Material>(id));
-					else
-					{
-						std::cerr << "Error loading member " << m.name << "[" << i << "] of " << name << ": Material id not registered" << std::endl;
-						item.push_back(resourceManager.GetAsset<Material>("default_material"));
-					}
-				}
+	static const AssetSerializer* GetAssetSerializer(Types type)
+	{
+		switch (type)
+		{
+		case Types::TEXTURE: case Types::TEXTURE_VECTOR: return GetAssetSerializer<Texture, Types::TEXTURE>();
+		case Types::MESH: case Types::MESH_VECTOR: return GetAssetSerializer<Mesh, Types::MESH>();
+		case Types::SKINNED_MESH: case Types::SKINNED_MESH_VECTOR: return GetAssetSerializer<SkinnedMesh, Types::SKINNED_MESH>();
+		case Types::MATERIAL: case Types::MATERIAL_VECTOR: return GetAssetSerializer<Material, Types::MATERIAL>();
+		case Types::CUBEMAP: return GetAssetSerializer<HdrCubemap, Types::CUBEMAP>();
+		case Types::ANIMATION: return GetAssetSerializer<Animation, Types::ANIMATION>();
+		case Types::SHADER: return GetAssetSerializer<Shader, Types::SHADER>();
+		case Types::FONT: return GetAssetSerializer<Font, Types::FONT>();
+		case Types::MESH_COLLIDER: return GetAssetSerializer<MeshCollider, Types::MESH_COLLIDER>();
+		case Types::SOUND: return GetAssetSerializer<Sound, Types::SOUND>();
+		default: return nullptr;
+		}
+	}
 
-				*(std::vector<Material*>*)& data[m.offset] = item;
-				break;
-			}
-			case Types::CUBEMAP:
-			{
-				UUID id;
-				in.read((char*)&id, sizeof(UUID));
+	void MetaType::Compile()
+	{
+		plan = SerializationPlan();
+		plan.memberCount = members.size();
 
-				if (resourceManager.IsAssetRegistered(id))
-					*(HdrCubemap**)&data[m.offset] = resourceManager.GetOrLoadAsset<HdrCubemap>(id);
-				else
-				{
-					std::cerr << "Error loading member " << m.name << " of " << name << ": Cubemap id not registered" << std::endl;
-					*(HdrCubemap**)&data[m.offset] = resourceManager.GetAsset<HdrCubemap>("default_cubemap");
-				}
+		// FNV-1a of the member names and types
+		plan.schemaHash = 14695981039346656037ull;
 
-				break;
-			}
-			case Types::ANIMATION:
+		auto hash = [this](const void* data, size_t size)
+		{
+			for (size_t i = 0; i < size; i++)
 			{
-				UUID id;
-				in.read((char*)&id, sizeof(UUID));
+				plan.schemaHash ^= ((const byte*)data)[i];
+				plan.schemaHash *= 1099511628211ull;
+			}
+		};
 
-				if (resourceManager.IsAssetRegistered(id))
-					*(Animation**)&data[m.offset] = resourceManager.GetOrLoadAsset<Animation>(id);
-				else
-				{
-					std::cerr << "Error loading member " << m.name << " of " << name << ": Animation id not registered" << std::endl;
-					*(Animation**)&data[m.offset] = resourceManager.GetAsset<Animation>("default_animation");
-				}
+		for (MemberData& m : members)
+		{
+			hash(m.name.c_str(), m.name.size() + 1);
+			hash(&m.type, sizeof(Types));
 
-				break;
-			}
-			case Types::SHADER:
-			{
-				UUID id;
-				in.read((char*)&id, sizeof(UUID));
+			SerializationStep step;
+			step.offset = m.offset;
+			step.size = (unsigned int)GetPlainDataSize(m.type);
+			step.asset = GetAssetSerializer(m.type);
 
-				if (resourceManager.IsAssetRegistered(id))
-					*(Shader**)&data[m.offset] = resourceManager.GetOrLoadAsset<Shader>(id);
-				else
-				{
-					std::cerr << "Error loading member " << m.name << " of " << name << ": Shader id not registered" << std::endl;
-					*(Shader**)&data[m.offset] = resourceManager.GetAsset<Shader>("default_shader");
-				}
-				break;
-			}
-			case Types::FONT:
-			{
-				UUID id;
-				in.read((char*)&id, sizeof(UUID));
+			if (m.type == Types::STRING)
+				step.operation = SerializationStep::Operation::STRING;
+			else if (m.type == Types::ID_VECTOR)
+				step.operation = SerializationStep::Operation::ID_VECTOR;
+			else if (m.type == Types::TEXTURE_VECTOR || m.type == Types::MESH_VECTOR || m.type == Types::SKINNED_MESH_VECTOR || m.type == Types::MATERIAL_VECTOR)
+				step.operation = SerializationStep::Operation::ASSET_VECTOR;
+			else if (step.asset)
+				step.operation = SerializationStep::Operation::ASSET;
+			else
+				step.operation = SerializationStep::Operation::COPY;
 
-				if (resourceManager.IsAssetRegistered(id))
-					*(Font**)&data[m.offset] = resourceManager.GetOrLoadAsset<Font>(id);
-				else
-				{
-					std::cerr << "Error loading member " << m.name << " of " << name << ": Font id not registered" << std::endl;
-					*(Font**)&data[m.offset] = resourceManager.GetAsset<Font>("empty_font");
-				}
-				break;
-			}
-			case Types::MESH_COLLIDER:
-			{
-				UUID id;
-				in.read((char*)&id, sizeof(UUID));
+			plan.memberSteps.push_back(step);
 
-				if (resourceManager.IsAssetRegistered(id))
-					*(MeshCollider**)&data[m.offset] = resourceManager.GetOrLoadAsset<MeshCollider>(id);
-				else
-				{
-					std::cerr << "Error loading member " << m.name << " of " << name << ": Mesh Collider id not registered" << std::endl;
-					*(MeshCollider**)&data[m.offset] = resourceManager.GetAsset<MeshCollider>("empty_mesh_collider");
-				}
-				break;
-			}
-			case Types::SOUND:
+			switch (step.operation)
 			{
-				UUID id;
-				in.read((char*)&id, sizeof(UUID));
-
-				if (resourceManager.IsAssetRegistered(id))
-					*(Sound**)&data[m.offset] = resourceManager.GetOrLoadAsset<Sound>(id);
-				else
-				{
-					std::cerr << "Error loading member " << m.name << " of " << name << ": Sound id not registered" << std::endl;
-					*(Sound**)&data[m.offset] = resourceManager.GetAsset<Sound>("empty_sound");
-				}
+			case SerializationStep::Operation::COPY:
+				plan.fixedSize += step.size;
 				break;
-			}
-			case Types::UNKNOWN:
+			case SerializationStep::Operation::ASSET:
+				plan.fixedSize += sizeof(UUID);
 				break;
+			default:
+				plan.variableSize = true;
+				break;
+			}
+
+			// Unknown members are not saved
+			if (step.operation == SerializationStep::Operation::COPY && step.size == 0) continue;
+
+			SerializationStep* previous = plan.steps.empty() ? nullptr : &plan.steps.back();
+
+			if (previous && previous->operation == SerializationStep::Operation::COPY && step.operation == SerializationStep::Operation::COPY
+				&& previous->offset + previous->size == step.offset)
+			{
+				previous->size += step.size;
+				continue;
 			}
+
+			plan.steps.push_back(step);
 		}
+	}
 
-		if (OnChange) OnChange(data);
+	size_t MetaType::GetPlainDataSize(Types type)
+	{
+		switch (type)
+		{
+		case Types::INT: return sizeof(int);
+		case Types::FLOAT: case Types::FLOAT_NORMALIZED: case Types::FLOAT_ANGLE: return sizeof(float);
+		case Types::BOOL: return sizeof(bool);
+		case Types::ID: return sizeof(UUID);
+		case Types::VECTOR2: case Types::VECTOR2_ANGLES: return sizeof(glm::vec2);
+		case Types::VECTOR3: case Types::VECTOR3_ANGLES: case Types::VECTOR3_COLOR: return sizeof(glm::vec3);
+		case Types::VECTOR4: case Types::VECTOR4_COLOR: return sizeof(glm::vec4);
+		case Types::QUATERNION: return sizeof(glm::quat);
+		default: return 0;
+		}
 	}
 
 	size_t MetaType::GetSerializedDataSize(byte* data)
 	{
+		SD_ASSERT(plan.memberCount == members.size(), "Serialization plan out of date, call Compile after changing the members");
+
 		size_t res = 0;
 
 		res += sizeof(size_t); // Name Size
 		res += (name.size() + 1) * sizeof(char); // Name
 		res += sizeof(size_t); // Member Count
+		res += members.size() * sizeof(Types); // Types
+		res += plan.fixedSize; // Plain values and asset ids
 
-		for (MemberData& m : members)
-		{
-			res += sizeof(Types); // Type
+		if (!plan.variableSize) return res;
 
-			switch (m.type)
-			{
-			case Types::ID:
-			{
-				res += sizeof(UUID); // Item
-				break;
-			}
-			case Types::ID_VECTOR:
-			{
-				std::vector<UUID>* item = (std::vector<UUID>*) & data[m.offset];
-
-				res += sizeof(size_t); // Size
-				res += item->size() * sizeof(UUID); // Items
-				break;
-			}
-			case Types::STRING:
-			{
-				std::string* item = (std::string*)&data[m.offset];
-				size_t size = item->length() + 1;
-
-				res += sizeof(size_t); // Size
-				res += size * sizeof(char); // String
-				break;
-			}
-			case Types::FLOAT: case Types::FLOAT_NORMALIZED: case Types::FLOAT_ANGLE:
-			{
-				res += sizeof(float); // Item
-				break;
-			}
-			case Types::INT:
-			{
-				res += sizeof(int); // Item
-				break;
-			}
-			case Types::BOOL:
-			{
-				res += sizeof(bool); // Item
-				break;
-			}
-			case Types::VECTOR2: case Types::VECTOR2_ANGLES:
-			{
-				res += sizeof(glm::vec2); // Item
-				break;
-			}
-			case Types::VECTOR3: case Types::VECTOR3_ANGLES: case Types::VECTOR3_COLOR:
+		for (const SerializationStep& step : plan.steps)
+		{
+			switch (step.operation)
 			{
-				res += sizeof(glm::vec3); // Item
+			case SerializationStep::Operation::STRING:
+				res += sizeof(size_t) + ((std::string*)&data[step.offset])->length() + 1; // Size and string
 				break;
-			}
-			case Types::VECTOR4: case Types::VECTOR4_COLOR:
-			{
-				res += sizeof(glm::vec4); // Item
+			case SerializationStep::Operation::ID_VECTOR:
+				res += sizeof(size_t) + ((std::vector<UUID>*)&data[step.offset])->size() * sizeof(UUID); // Size and items
 				break;
-			}
-			case Types::TEXTURE: case Types::MESH: case Types::SKINNED_MESH: case Types::MATERIAL: case Types::CUBEMAP: case Types::ANIMATION:
-			case Types::SHADER: case Types::FONT: case Types::MESH_COLLIDER: case Types::SOUND:
-			{
-				res += sizeof(UUID); // Item
+			case SerializationStep::Operation::ASSET_VECTOR:
+				res += sizeof(size_t) + step.asset->GetVectorSize(&data[step.offset]) * sizeof(UUID); // Size and items
 				break;
-			}
-			case Types::TEXTURE_VECTOR: case Types::MESH_VECTOR: case Types::SKINNED_MESH_VECTOR: case Types::MATERIAL_VECTOR:
-			{
-				std::vector<Texture*>* item = (std::vector<Texture*>*) & data[m.offset];
-
-				res += sizeof(size_t); // Size
-				res += item->size() * sizeof(UUID); // Items
-				break;
-			}
-			case Types::UNKNOWN:
+			default:
 				break;
 			}
 		}
@@ -714,6 +482,9 @@ namespace Seidon
 		if (type == Types::VECTOR3_ANGLES)
 			return "Vec3 Angles";
 
+		if (type == Types::QUATERNION)
+			return "Quaternion";
+
 		if (type == Types::MESH_VECTOR)
 			return "Mesh Vector";
 
@@ -791,6 +562,9 @@ namespace Seidon
 		if (string == "VECTOR3_ANGLES")
 			return Types::VECTOR3_ANGLES;
 
+		if (string == "QUATERNION")
+			return Types::QUATERNION;
+
 		if (string == "MESH_VECTOR")
 			return Types::MESH_VECTOR;
 
@@ -850,4 +624,97 @@ namespace Seidon
 			memcpy(dstMember, srcMember, data.size);
 		}
 	}
+
+	void AssetResolver::Set(void* target, Types type, UUID id)
+	{
+		if (deferred)
+		{
+			references.push_back({ target, type, id });
+			return;
+		}
+
+		void* asset = Get(type, id);
+		memcpy(target, &asset, sizeof(void*));
+	}
+
+	void AssetResolver::Resolve()
+	{
+		Resolve(*this);
+	}
+
+	void AssetResolver::Resolve(AssetResolver& other)
+	{
+		for (Reference& reference : other.references)
+		{
+			void* asset = Get(reference.type, reference.id);
+			memcpy(reference.target, &asset, sizeof(void*));
+		}
+
+		other.references.clear();
+	}
+
+	void* AssetResolver::Get(Types type, UUID id)
+	{
+		auto it = resolved.find(id);
+
+		if (it != resolved.end() && it->second.first == type)
+			return it->second.second;
+
+		void* asset = Load(type, id);
+		resolved[id] = { type, asset };
+
+		return asset;
+	}
+
+	template <typename T>
+	static T* GetAssetOrDefault(UUID id, const std::string& defaultName, const char* typeName)
+	{
+		ResourceManager& resourceManager = *Application::Get()->GetResourceManager();
+
+		if (resourceManager.IsAssetRegistered(id))
+			return resourceManager.GetOrLoadAsset<T>(id);
+
+		std::cerr << "Error loading asset reference: " << typeName << " id " << (uint64_t)id << " not registered" << std::endl;
+		return resourceManager.GetAsset<T>(defaultName);
+	}
+
+	void* AssetResolver::Load(Types type, UUID id)
+	{
+		switch (type)
+		{
+		case Types::TEXTURE: return GetAssetOrDefault<Texture>(id, "albedo_default", "Texture");
+		case Types::MESH: return GetAssetOrDefault<Mesh>(id, "empty_mesh", "Mesh");
+		case Types::SKINNED_MESH: return GetAssetOrDefault<SkinnedMesh>(id, "empty_skinned_mesh", "Skinned mesh");
+		case Types::MATERIAL: return GetAssetOrDefault<Material>(id, "default_material", "Material");
+		case Types::CUBEMAP: return GetAssetOrDefault<HdrCubemap>(id, "default_cubemap", "Cubemap");
+		case Types::ANIMATION: return GetAssetOrDefault<Animation>(id, "default_animation", "Animation");
+		case Types::SHADER: return GetAssetOrDefault<Shader>(id, "default_shader", "Shader");
+		case Types::FONT: return GetAssetOrDefault<Font>(id, "empty_font", "Font");
+		case Types::MESH_COLLIDER: return GetAssetOrDefault<MeshCollider>(id, "empty_mesh_collider", "Mesh Collider");
+		case Types::SOUND: return GetAssetOrDefault<Sound>(id, "empty_sound", "Sound");
+		default: return nullptr;
+		}
+	}
+
+	void ComponentMetaType::ModifyMemberV(Entity entity, const std::string& memberName, void* newValue)
+	{
+		MetaType::ModifyMemberV(memberName, Get(entity), newValue);
+		MarkChanged(entity);
+	}
+
+	bool SystemMetaType::ConflictsWith(const SystemMetaType& other) const
+	{
+		if (!accessDeclared || !other.accessDeclared) return true;
+
+		for (const std::string& component : writtenComponents)
+		{
+			if (std::find(other.readComponents.begin(), other.readComponents.end(), component) != other.readComponents.end()) return true;
+			if (std::find(other.writtenComponents.begin(), other.writtenComponents.end(), component) != other.writtenComponents.end()) return true;
+		}
+
+		for (const std::string& component : other.writtenComponents)
+			if (std::find(readComponents.begin(), readComponents.end(), component) != readComponents.end()) return true;
+
+		return false;
+	}
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "../Core/UUID.h"
+#include "../Ecs/EnttWrappers.h"
 #include "../Audio/Sound.h"
 
 #include "../Graphics/Texture.h"
@@ -15,9 +16,12 @@
 
 #include <entt/entt.hpp>
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 #include <string>
 #include <vector>
+#include <memory>
+#include <unordered_map>
 #include <iostream>
 #include <fstream>
 
@@ -59,7 +63,8 @@ namespace Seidon
 		SHADER,
 		FONT,
 		MESH_COLLIDER,
-		SOUND
+		SOUND,
+		QUATERNION
 	};
 
 	template<typename T, typename U> 
@@ -91,6 +96,96 @@ namespace Seidon
 		}
 	};
 
+	/*
+	* Sets the asset members read by MetaType::Load and LoadMembers. Assets are resolved right away by default.
+	* A deferred resolver only records where each id goes, so that members can be read away from the main
+	* thread; Resolve then gets each distinct asset once on the main thread and writes it everywhere it's used.
+	*/
+	class AssetResolver
+	{
+	private:
+		struct Reference
+		{
+			void* target;
+			Types type;
+			UUID id;
+		};
+
+		bool deferred;
+		std::vector<Reference> references;
+
+		// By id, along with the type it was resolved as
+		std::unordered_map<UUID, std::pair<Types, void*>> resolved;
+
+	public:
+		AssetResolver(bool deferred = false) : deferred(deferred) {}
+
+		// target points to the asset pointer of the given asset type
+		void Set(void* target, Types type, UUID id);
+
+		// Resolves what this resolver recorded, or what other recorded sharing the assets already resolved here
+		void Resolve();
+		void Resolve(AssetResolver& other);
+
+		inline size_t GetReferenceCount() const { return references.size(); }
+
+	private:
+		void* Get(Types type, UUID id);
+		static void* Load(Types type, UUID id);
+	};
+
+	// Save and load of the members referencing one type of asset, see SerializationPlan
+	struct AssetSerializer
+	{
+		Types type;
+
+		UUID (*GetId)(const void* asset);
+		void (*SaveVector)(BinaryWriter& out, const void* vector);
+		void (*LoadVector)(BinaryReader& in, void* vector, AssetResolver& assets);
+		size_t (*GetVectorSize)(const void* vector);
+	};
+
+	struct SerializationStep
+	{
+		enum class Operation
+		{
+			COPY,
+			STRING,
+			ID_VECTOR,
+			ASSET,
+			ASSET_VECTOR
+		};
+
+		Operation operation;
+		unsigned int offset;
+
+		// Bytes copied by COPY steps
+		unsigned int size = 0;
+
+		// Serializer of the asset type for ASSET and ASSET_VECTOR steps
+		const AssetSerializer* asset = nullptr;
+	};
+
+	/*
+	* Serialization of a metatype built by MetaType::Compile. Plain members that follow each other both in the
+	* member list and in memory are merged in a single copy, asset members go through the serializer of their
+	* asset type, strings and vectors get a step of their own.
+	*/
+	struct SerializationPlan
+	{
+		std::vector<SerializationStep> steps;
+
+		// One step per member, for the formats that tag each member with its type
+		std::vector<SerializationStep> memberSteps;
+
+		size_t memberCount = 0;
+		uint64_t schemaHash = 0;
+
+		// Bytes written by the COPY and ASSET steps, the whole instance when there are no variable size members
+		size_t fixedSize = 0;
+		bool variableSize = false;
+	};
+
 	struct MetaType
 	{
 		std::string name;
@@ -132,6 +227,9 @@ namespace Seidon
 			if (typeid(U).hash_code() == typeid(glm::vec3).hash_code())
 				data.type = Types::VECTOR3;
 
+			if (typeid(U).hash_code() == typeid(glm::quat).hash_code())
+				data.type = Types::QUATERNION;
+
 			if (typeid(U).hash_code() == typeid(std::vector<Mesh*>).hash_code())
 				data.type = Types::MESH_VECTOR;
 
@@ -177,6 +275,8 @@ namespace Seidon
 			members.push_back(data);
 			nameToMember[data.name] = data;
 
+			Compile();
+
 			return *this;
 		}
 
@@ -192,6 +292,8 @@ namespace Seidon
 			members.push_back(data);
 			nameToMember[data.name] = data;
 
+			Compile();
+
 			return *this;
 		}
 
@@ -234,8 +336,32 @@ namespace Seidon
 		
 		size_t GetSerializedDataSize(byte* data);
 
-		void Save(std::ofstream& out, byte* data);
-		void Load(std::ifstream& in, byte* data);
+		void Save(BinaryWriter& out, byte* data);
+		void Load(BinaryReader& in, byte* data);
+
+		// Rebuilds the serialization plan, AddMember calls it. Call it after changing the members directly
+		void Compile();
+
+		/*
+		* Member values without the type name, member count and type tags, used by the columnar scene format where
+		* the schema is saved once per component type. Plain values are copied as they are in memory.
+		* The overload taking the saved members loads data saved with a different schema: members are matched
+		* by name, the ones that were removed or changed type are skipped.
+		* Only reads the metatype, with a deferred resolver different threads can load members at the same time.
+		*/
+		void SaveMembers(BinaryWriter& out, byte* data);
+		void LoadMembers(BinaryReader& in, byte* data, AssetResolver& assets);
+
+		// Same as above for count instances at once, the plan runs over the whole array
+		void SaveMembers(BinaryWriter& out, void* const* instances, size_t count);
+		void LoadMembers(BinaryReader& in, void* const* instances, size_t count, AssetResolver& assets);
+		void LoadMembers(BinaryReader& in, byte* data, const std::vector<MemberData>& savedMembers, AssetResolver& assets);
+
+		// Hash of the member names and types, equal hashes mean that LoadMembers can read the data as it is
+		uint64_t GetSchemaHash();
+
+		// Size of the values that are saved as they are in memory, 0 for strings, vectors and assets
+		static size_t GetPlainDataSize(Types type);
 
 		inline bool operator==(const MetaType& other) 
 		{ 
@@ -255,9 +381,18 @@ namespace Seidon
 
 		static Types StringToType(const std::string& string);
 		static std::string TypeToString(Types type);
+
+	private:
+		SerializationPlan plan;
+
+		static void SaveStep(BinaryWriter& out, const SerializationStep& step, byte* data);
+		static void LoadStep(BinaryReader& in, const SerializationStep& step, byte* data, AssetResolver& assets);
+		static void SkipMember(BinaryReader& in, Types type);
 	};
 
 	class Entity;
+	class Scene;
+	struct ComponentColumn;
 	struct ComponentMetaType : public MetaType
 	{
 		void* (*Add)(Entity entity);
@@ -265,9 +400,32 @@ namespace Seidon
 		void* (*Get)(Entity entity);
 		bool  (*Has)(Entity entity);
 		void  (*Copy)(Entity src, Entity dst);
+		void  (*MarkChanged)(Entity entity);
+
+		// Bulk copy of every component of the type, see Scene::CopyComponentsTo
+		void  (*CopyAll)(Scene& src, Scene& dst, const std::vector<EntityId>& entityMap);
+
+		// Used by the batch Scene::InstantiatePrefab, see Scene::InstantiateComponents
+		void  (*InstantiateAll)(Scene& prefabScene, Scene& dst, const std::vector<EntityId>& prefabEntities,
+			const std::vector<EntityId>& instances);
+
+		// Used by Scene::Snapshot and Scene::Restore
+		std::shared_ptr<const ComponentColumn> (*SnapshotAll)(Scene& scene);
+		void  (*ClearAll)(Scene& scene);
+		void  (*RestoreAll)(Scene& scene, const ComponentColumn& column);
+
+		// Used by the columnar scene format. CreateColumn makes a column of count default components and writes
+		// their addresses to components, InsertAll moves the components of a column into the scene
+		void  (*GetAll)(Scene& scene, std::vector<EntityId>& entities, std::vector<void*>& components);
+		std::shared_ptr<ComponentColumn> (*CreateColumn)(size_t count, std::vector<void*>& components);
+		void  (*InsertAll)(Scene& scene, ComponentColumn& column);
+
+		using MetaType::ModifyMemberV;
+
+		// Also marks the component as changed in the entity's scene
+		void ModifyMemberV(Entity entity, const std::string& memberName, void* newValue);
 	};
 
-	class Scene;
 	class System;
 	struct SystemMetaType : public MetaType
 	{
@@ -277,5 +435,61 @@ namespace Seidon
 		bool  (*Has)(Scene& scene);
 		void  (*Copy)(Scene& src, Scene& dst);
 		System* (*Instantiate)();
+
+		/*
+		* Component access used by the scene to schedule systems concurrently. Systems that don't
+		* declare anything are exclusive: they run alone on the main thread. Two declared systems
+		* run in parallel unless one of them writes a component the other reads or writes.
+		* Written components count as changed after every update of the system, undeclared systems
+		* have to mark the components they change through Scene::MarkComponentChanged.
+		*/
+		std::vector<std::string> readComponents;
+		std::vector<std::string> writtenComponents;
+		bool accessDeclared = false;
+		bool mainThreadOnly = false;
+
+		// The scene runs Scene::UpdateTransforms right before the system, within its exclusive access to the transforms
+		bool updateTransformsBefore = false;
+
+		// Systems run sorted by execution order first, registration order second
+		int executionOrder = 0;
+
+		template<typename... Types>
+		SystemMetaType& Reads()
+		{
+			(readComponents.push_back(typeid(Types).name()), ...);
+			accessDeclared = true;
+
+			return *this;
+		}
+
+		template<typename... Types>
+		SystemMetaType& Writes()
+		{
+			(writtenComponents.push_back(typeid(Types).name()), ...);
+			accessDeclared = true;
+
+			return *this;
+		}
+
+		inline SystemMetaType& RunOnMainThread()
+		{
+			mainThreadOnly = true;
+			return *this;
+		}
+
+		inline SystemMetaType& UpdateTransformsBefore()
+		{
+			updateTransformsBefore = true;
+			return *this;
+		}
+
+		inline SystemMetaType& SetExecutionOrder(int order)
+		{
+			executionOrder = order;
+			return *this;
+		}
+
+		bool ConflictsWith(const SystemMetaType& other) const;
 	};
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Audio/Audio.h"
 #include "Core/Core.h"
 #include "Debug/Debug.h"
+#include "Debug/Profiler.h"
 #include "Ecs/Ecs.h"
 #include "Extensions/Extensions.h"
 #include "Graphics/Graphics.h"
@@ -0,0 +1,226 @@
+#include "BinaryReader.h"
+#include "MappedFile.h"
+
+#include <iostream>
+#include <algorithm>
+
+namespace Seidon
+{
+	BinaryReader::BinaryReader(const std::string& path)
+	{
+		file = std::make_unique<std::ifstream>(path, std::ios::in | std::ios::binary | std::ios::ate);
+
+		if (!file->is_open())
+		{
+			std::cerr << "Couldn't open " << path << std::endl;
+			good = false;
+			return;
+		}
+
+		size = (size_t)file->tellg();
+		file->seekg(0);
+
+		stream = file.get();
+		buffer.resize(BLOCK_SIZE);
+	}
+
+	BinaryReader::BinaryReader(std::istream& stream)
+		: stream(&stream)
+	{
+		std::streampos start = stream.tellg();
+
+		if (start != std::streampos(-1) && stream.seekg(0, std::ios::end))
+		{
+			size = (size_t)(stream.tellg() - start);
+			stream.seekg(start);
+		}
+		else
+			stream.clear();
+
+		buffer.resize(BLOCK_SIZE);
+	}
+
+	BinaryReader::BinaryReader(const char* data, size_t size)
+		: begin(data), current(data), end(data + size), size(size)
+	{
+	}
+
+	BinaryReader::BinaryReader(const std::shared_ptr<const MappedFile>& mappedFile)
+		: mappedFile(mappedFile)
+	{
+		if (!mappedFile->IsOpen())
+		{
+			good = false;
+			size = 0;
+			return;
+		}
+
+		begin = current = mappedFile->GetData();
+		end = begin + mappedFile->GetSize();
+		size = mappedFile->GetSize();
+	}
+
+	void BinaryReader::ReadBytes(void* data, size_t size)
+	{
+		char* destination = (char*)data;
+
+		while (size > 0 && good)
+		{
+			size_t available = end - current;
+
+			if (available == 0)
+			{
+				// Large reads go straight to the destination instead of through the buffer
+				if (stream && size >= BLOCK_SIZE)
+				{
+					stream->read(destination, size);
+
+					size_t read = stream->gcount();
+					windowOffset += read;
+					destination += read;
+					size -= read;
+
+					if (size > 0) Fail("Unexpected end of data");
+					break;
+				}
+
+				if (!Refill())
+				{
+					Fail("Unexpected end of data");
+					break;
+				}
+
+				continue;
+			}
+
+			size_t count = std::min(available, size);
+			memcpy(destination, current, count);
+
+			current += count;
+			destination += count;
+			size -= count;
+		}
+
+		if (size > 0)
+			memset(destination, 0, size);
+	}
+
+	void BinaryReader::Skip(size_t size)
+	{
+		while (size > 0 && good)
+		{
+			size_t available = end - current;
+
+			if (available == 0 && !Refill())
+			{
+				Fail("Unexpected end of data");
+				return;
+			}
+
+			size_t count = std::min((size_t)(end - current), size);
+			current += count;
+			size -= count;
+		}
+	}
+
+	const char* BinaryReader::ReadInPlace(size_t size)
+	{
+		if (!good || stream) return nullptr;
+
+		if ((size_t)(end - current) < size)
+		{
+			Fail("Unexpected end of data");
+			return nullptr;
+		}
+
+		const char* data = current;
+		current += size;
+
+		return data;
+	}
+
+	size_t BinaryReader::ReadCount(size_t minElementSize)
+	{
+		size_t count = Read<size_t>();
+
+		return CheckCount(count, minElementSize) ? count : 0;
+	}
+
+	void BinaryReader::ReadString(std::string& string)
+	{
+		ReadString(string, Read<size_t>());
+	}
+
+	void BinaryReader::ReadString(std::string& string, size_t length)
+	{
+		if (!good || length == 0)
+		{
+			string.clear();
+			return;
+		}
+
+		if (length > MAX_STRING_LENGTH || length > GetRemainingSize())
+		{
+			Fail("String length out of range");
+			string.clear();
+			return;
+		}
+
+		string.resize(length);
+		ReadBytes(string.data(), length);
+
+		// Saved with the terminating null, anything after the first null is dropped like when reading into a C string
+		string.resize(strnlen(string.c_str(), length));
+	}
+
+	std::string BinaryReader::ReadString()
+	{
+		std::string string;
+		ReadString(string);
+
+		return string;
+	}
+
+	size_t BinaryReader::GetRemainingSize() const
+	{
+		if (size == SIZE_MAX) return SIZE_MAX;
+
+		size_t position = GetPosition();
+		return position < size ? size - position : 0;
+	}
+
+	bool BinaryReader::Refill()
+	{
+		if (!stream) return false;
+
+		windowOffset += end - begin;
+
+		stream->read(buffer.data(), buffer.size());
+		size_t read = stream->gcount();
+
+		begin = current = buffer.data();
+		end = begin + read;
+
+		return read > 0;
+	}
+
+	bool BinaryReader::CheckCount(size_t count, size_t elementSize)
+	{
+		if (!good) return false;
+
+		size_t remaining = GetRemainingSize();
+		if (remaining == SIZE_MAX || count <= remaining / std::max(elementSize, (size_t)1)) return true;
+
+		Fail("Element count out of range");
+		return false;
+	}
+
+	void BinaryReader::Fail(const char* message)
+	{
+		if (good)
+			std::cerr << "Error reading binary data at offset " << GetPosition() << ": " << message << std::endl;
+
+		good = false;
+		current = end;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <istream>
+#include <fstream>
+#include <cstring>
+#include <type_traits>
+
+namespace Seidon
+{
+	class MappedFile;
+
+	/*
+	* Reader of the binary asset formats. Files and streams are read in blocks of BLOCK_SIZE through an internal
+	* buffer, memory buffers and mapped files are read in place. Reading past the end of the data or reading a
+	* length that can't be right fails the reader instead of overrunning anything: every later read returns zeroes,
+	* so callers only have to check IsGood() once they are done.
+	*/
+	class BinaryReader
+	{
+	public:
+		static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+		// Longer strings can only come from corrupted data
+		static constexpr size_t MAX_STRING_LENGTH = 1024 * 1024;
+
+	private:
+		std::unique_ptr<std::ifstream> file;
+		std::istream* stream = nullptr;
+		std::shared_ptr<const MappedFile> mappedFile;
+
+		std::vector<char> buffer;
+
+		// Bytes that can be read without going back to the source, the whole data when reading in place
+		const char* begin = nullptr;
+		const char* current = nullptr;
+		const char* end = nullptr;
+
+		// Source offset of begin, and the total size of the source (SIZE_MAX if the stream can't tell)
+		size_t windowOffset = 0;
+		size_t size = SIZE_MAX;
+
+		bool good = true;
+
+	public:
+		BinaryReader(const std::string& path);
+		BinaryReader(std::istream& stream);
+		BinaryReader(const char* data, size_t size);
+		BinaryReader(const std::shared_ptr<const MappedFile>& mappedFile);
+
+		BinaryReader(const BinaryReader&) = delete;
+		BinaryReader& operator=(const BinaryReader&) = delete;
+
+		void ReadBytes(void* data, size_t size);
+		void Skip(size_t size);
+
+		// Next size bytes without copying them, only for readers working in place (nullptr otherwise)
+		const char* ReadInPlace(size_t size);
+
+		template <typename T>
+		void Read(T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be read directly");
+
+			if (end - current >= (ptrdiff_t)sizeof(T))
+			{
+				memcpy(&value, current, sizeof(T));
+				current += sizeof(T);
+				return;
+			}
+
+			ReadBytes(&value, sizeof(T));
+		}
+
+		template <typename T>
+		T Read()
+		{
+			T value{};
+			Read(value);
+
+			return value;
+		}
+
+		template <typename T>
+		void ReadArray(T* data, size_t count)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be read directly");
+
+			if (!CheckCount(count, sizeof(T))) return;
+
+			ReadBytes(data, count * sizeof(T));
+		}
+
+		// Element count followed by the elements, as written by BinaryWriter::WriteVector
+		template <typename T>
+		void ReadVector(std::vector<T>& vector)
+		{
+			vector.resize(ReadCount(sizeof(T)));
+			ReadArray(vector.data(), vector.size());
+		}
+
+		// Element count of a variable size array, checked against the remaining data knowing that each element
+		// takes at least minElementSize bytes. 0 if the count can't be right
+		size_t ReadCount(size_t minElementSize);
+
+		// Length including the terminating null followed by the characters, as written by BinaryWriter::WriteString
+		void ReadString(std::string& string);
+		std::string ReadString();
+
+		// Characters of a string whose length was already read
+		void ReadString(std::string& string, size_t length);
+
+		inline bool IsGood() const { return good; }
+		inline bool IsInPlace() const { return !stream; }
+		inline size_t GetPosition() const { return windowOffset + (current - begin); }
+
+		// File the reader works on in place, data returned by ReadInPlace stays valid as long as it is kept alive
+		inline const std::shared_ptr<const MappedFile>& GetMappedFile() const { return mappedFile; }
+
+		// SIZE_MAX when the size of the source is unknown
+		size_t GetRemainingSize() const;
+
+	private:
+		bool Refill();
+		bool CheckCount(size_t count, size_t elementSize);
+		void Fail(const char* message);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "BinaryWriter.h"
+
+#include <iostream>
+#include <cstring>
+
+namespace Seidon
+{
+	BinaryWriter::BinaryWriter(const std::string& path)
+	{
+		file = std::make_unique<std::ofstream>(path, std::ios::out | std::ios::binary);
+
+		if (!file->is_open())
+		{
+			std::cerr << "Couldn't open " << path << " for writing" << std::endl;
+			good = false;
+		}
+
+		stream = file.get();
+		buffer.resize(BLOCK_SIZE);
+	}
+
+	BinaryWriter::BinaryWriter(std::ostream& stream)
+		: stream(&stream)
+	{
+		buffer.resize(BLOCK_SIZE);
+	}
+
+	BinaryWriter::BinaryWriter(std::vector<char>& memory)
+		: memory(&memory)
+	{
+	}
+
+	BinaryWriter::~BinaryWriter()
+	{
+		Flush();
+	}
+
+	void BinaryWriter::WriteBytes(const void* data, size_t size)
+	{
+		const char* source = (const char*)data;
+
+		if (memory)
+		{
+			memory->insert(memory->end(), source, source + size);
+			return;
+		}
+
+		if (buffered + size > buffer.size())
+			Flush();
+
+		// Large writes go straight to the stream instead of through the buffer
+		if (size >= buffer.size())
+		{
+			stream->write(source, size);
+			flushed += size;
+
+			if (!*stream) good = false;
+			return;
+		}
+
+		memcpy(buffer.data() + buffered, source, size);
+		buffered += size;
+	}
+
+	void BinaryWriter::WriteString(const std::string& string)
+	{
+		size_t length = string.length() + 1;
+
+		Write(length);
+		WriteBytes(string.c_str(), length);
+	}
+
+	void BinaryWriter::Flush()
+	{
+		if (!stream || buffered == 0) return;
+
+		stream->write(buffer.data(), buffered);
+		flushed += buffered;
+		buffered = 0;
+
+		if (!*stream) good = false;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <ostream>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+namespace Seidon
+{
+	/*
+	* Writer of the binary asset formats, counterpart of BinaryReader. Writes to files and streams are gathered
+	* in blocks of BLOCK_SIZE, writes to memory are appended to the given vector.
+	*/
+	class BinaryWriter
+	{
+	public:
+		static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+	private:
+		std::unique_ptr<std::ofstream> file;
+		std::ostream* stream = nullptr;
+		std::vector<char>* memory = nullptr;
+
+		std::vector<char> buffer;
+		size_t buffered = 0;
+		size_t flushed = 0;
+
+		bool good = true;
+
+	public:
+		BinaryWriter(const std::string& path);
+		BinaryWriter(std::ostream& stream);
+		BinaryWriter(std::vector<char>& memory);
+		~BinaryWriter();
+
+		BinaryWriter(const BinaryWriter&) = delete;
+		BinaryWriter& operator=(const BinaryWriter&) = delete;
+
+		void WriteBytes(const void* data, size_t size);
+
+		template <typename T>
+		void Write(const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be written directly");
+
+			if (!memory && buffered + sizeof(T) <= buffer.size())
+			{
+				memcpy(buffer.data() + buffered, &value, sizeof(T));
+				buffered += sizeof(T);
+				return;
+			}
+
+			WriteBytes(&value, sizeof(T));
+		}
+
+		template <typename T>
+		void WriteArray(const T* data, size_t count)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be written directly");
+
+			WriteBytes(data, count * sizeof(T));
+		}
+
+		template <typename T>
+		void WriteVector(const std::vector<T>& vector)
+		{
+			Write(vector.size());
+			WriteArray(vector.data(), vector.size());
+		}
+
+		void WriteString(const std::string& string);
+
+		// Hands the buffered bytes to the stream, also done on destruction
+		void Flush();
+
+		inline bool IsGood() const { return good; }
+		inline size_t GetPosition() const { return memory ? memory->size() : flushed + buffered; }
+	};
+}
\ No newline at end of file
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace Seidon
+{
+    /*
+    * Pool of BlockSize bytes blocks for objects allocated at a high rate from any thread, like jobs and queue nodes.
+    * Each thread allocates from and releases to its own free list without locking. Blocks often get released by
+    * another thread than the one that allocated them, so threads that release more than they allocate hand
+    * BATCH_SIZE blocks at a time over to a shared list, which the others refill from.
+    */
+    template<size_t BlockSize>
+    class BlockPool
+    {
+    public:
+        static constexpr size_t BATCH_SIZE = 64;
+        static constexpr size_t MAX_SHARED_BATCHES = 64;
+
+    private:
+        union Block
+        {
+            Block* next;
+            alignas(std::max_align_t) unsigned char data[BlockSize];
+        };
+
+        struct SharedList
+        {
+            std::mutex mutex;
+
+            // Heads of chains of BATCH_SIZE blocks
+            std::vector<Block*> batches;
+        };
+
+        // Trivially destructible, so it stays usable while the other thread locals of the thread are destroyed
+        struct LocalList
+        {
+            Block* head;
+            size_t size;
+            bool released;
+        };
+
+        struct LocalRelease
+        {
+            ~LocalRelease()
+            {
+                LocalList& list = GetLocalList();
+
+                FreeChain(list.head);
+                list.head = nullptr;
+                list.size = 0;
+                list.released = true;
+            }
+        };
+
+        // Never destroyed, threads can still release blocks during static destruction
+        static SharedList& GetSharedList()
+        {
+            static SharedList* list = new SharedList();
+            return *list;
+        }
+
+        static LocalList& GetLocalList()
+        {
+            static thread_local LocalList list = {};
+
+            // Frees the blocks of the thread when it exits
+            static thread_local LocalRelease release;
+            (void)release;
+
+            return list;
+        }
+
+        static void FreeChain(Block* head)
+        {
+            while (head)
+            {
+                Block* next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+        }
+
+    public:
+        static void* Allocate()
+        {
+            LocalList& list = GetLocalList();
+            if (list.released) return ::operator new(sizeof(Block));
+
+            if (!list.head)
+            {
+                SharedList& shared = GetSharedList();
+                std::unique_lock<std::mutex> lock(shared.mutex);
+
+                if (!shared.batches.empty())
+                {
+                    list.head = shared.batches.back();
+                    list.size = BATCH_SIZE;
+                    shared.batches.pop_back();
+                }
+            }
+
+            if (!list.head) return ::operator new(sizeof(Block));
+
+            Block* block = list.head;
+            list.head = block->next;
+            list.size--;
+
+            return block;
+        }
+
+        static void Release(void* memory)
+        {
+            LocalList& list = GetLocalList();
+            if (list.released)
+            {
+                ::operator delete(memory);
+                return;
+            }
+
+            Block* block = (Block*)memory;
+            block->next = list.head;
+            list.head = block;
+            list.size++;
+
+            if (list.size < 2 * BATCH_SIZE) return;
+
+            // Keeps one batch for the thread, the other one goes to the threads that allocate more than they release
+            Block* batch = list.head;
+            Block* last = batch;
+            for (size_t i = 1; i < BATCH_SIZE; i++)
+                last = last->next;
+
+            list.head = last->next;
+            list.size -= BATCH_SIZE;
+            last->next = nullptr;
+
+            SharedList& shared = GetSharedList();
+            {
+                std::unique_lock<std::mutex> lock(shared.mutex);
+
+                if (shared.batches.size() < MAX_SHARED_BATCHES)
+                {
+                    shared.batches.push_back(batch);
+                    return;
+                }
+            }
+
+            FreeChain(batch);
+        }
+    };
+
+    // Allocator for std::allocate_shared, so that the object and its control block come from one pooled block
+    template<typename T>
+    class PoolAllocator
+    {
+    public:
+        using value_type = T;
+
+        PoolAllocator() = default;
+
+        template<typename U>
+        PoolAllocator(const PoolAllocator<U>&) {}
+
+        T* allocate(size_t count)
+        {
+            static_assert(alignof(T) <= alignof(std::max_align_t), "Pooled blocks are only aligned to max_align_t");
+
+            if (count == 1) return (T*)BlockPool<sizeof(T)>::Allocate();
+            return (T*)::operator new(count * sizeof(T));
+        }
+
+        void deallocate(T* memory, size_t count)
+        {
+            if (count == 1) BlockPool<sizeof(T)>::Release(memory);
+            else ::operator delete(memory);
+        }
+
+        template<typename U>
+        bool operator==(const PoolAllocator<U>&) const { return true; }
+
+        template<typename U>
+        bool operator!=(const PoolAllocator<U>&) const { return false; }
+    };
+}
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <mutex>
 #include <thread>
 #include <condition_variable>
+#include <utility>
 
 namespace Seidon
 {
@@ -27,7 +28,7 @@ namespace Seidon
         {
             {
                 std::unique_lock<std::mutex> lock(mutex);
-                queue.push(item);
+                queue.push(std::move(item));
             }
             emptyWaitCondition.notify_one();
         }
@@ -39,7 +40,7 @@ namespace Seidon
             while (queue.size() == 0)
                 emptyWaitCondition.wait(lock);
 
-            T res = queue.front();
+            T res = std::move(queue.front());
             queue.pop();
             return res;
         }
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Seidon
+{
+    /*
+    * Shared free list of fixed size blocks, used by InlineTask for captures that don't fit inline.
+    * At most MAX_FREE_BLOCKS are kept around, the rest goes back to the allocator.
+    */
+    class TaskBlockPool
+    {
+    public:
+        static constexpr size_t BLOCK_SIZE = 256;
+        static constexpr size_t MAX_FREE_BLOCKS = 1024;
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        struct FreeList
+        {
+            std::mutex mutex;
+            FreeBlock* head = nullptr;
+            size_t size = 0;
+
+            ~FreeList()
+            {
+                while (head)
+                {
+                    FreeBlock* next = head->next;
+                    ::operator delete(head);
+                    head = next;
+                }
+            }
+        };
+
+        static FreeList& GetFreeList()
+        {
+            static FreeList list;
+            return list;
+        }
+
+    public:
+        static void* Allocate()
+        {
+            FreeList& list = GetFreeList();
+            {
+                std::unique_lock<std::mutex> lock(list.mutex);
+
+                if (list.head)
+                {
+                    FreeBlock* block = list.head;
+                    list.head = block->next;
+                    list.size--;
+                    return block;
+                }
+            }
+
+            return ::operator new(BLOCK_SIZE);
+        }
+
+        static void Release(void* block)
+        {
+            FreeList& list = GetFreeList();
+            {
+                std::unique_lock<std::mutex> lock(list.mutex);
+
+                if (list.size < MAX_FREE_BLOCKS)
+                {
+                    FreeBlock* freeBlock = (FreeBlock*)block;
+                    freeBlock->next = list.head;
+                    list.head = freeBlock;
+                    list.size++;
+                    return;
+                }
+            }
+
+            ::operator delete(block);
+        }
+    };
+
+    /*
+    * Move-only replacement for std::function<void(void)>. Callables up to INLINE_SIZE bytes are stored
+    * inside the object, bigger ones in a TaskBlockPool block (or on the heap past BLOCK_SIZE).
+    */
+    class InlineTask
+    {
+    public:
+        static constexpr size_t INLINE_SIZE = 64 - sizeof(void*);
+
+    private:
+        struct Operations
+        {
+            void (*invoke)(void* storage);
+            void (*move)(void* dst, void* src);
+            void (*destroy)(void* storage);
+        };
+
+        template<typename F>
+        struct InlineOperations
+        {
+            static void Invoke(void* storage) { (*(F*)storage)(); }
+
+            static void Move(void* dst, void* src)
+            {
+                new (dst) F(std::move(*(F*)src));
+                ((F*)src)->~F();
+            }
+
+            static void Destroy(void* storage) { ((F*)storage)->~F(); }
+
+            static constexpr Operations operations = { &Invoke, &Move, &Destroy };
+        };
+
+        template<typename F>
+        struct PooledOperations
+        {
+            static void Invoke(void* storage) { (**(F**)storage)(); }
+
+            static void Move(void* dst, void* src) { *(F**)dst = *(F**)src; }
+
+            static void Destroy(void* storage)
+            {
+                F* function = *(F**)storage;
+                function->~F();
+
+                if constexpr (sizeof(F) <= TaskBlockPool::BLOCK_SIZE)
+                    TaskBlockPool::Release(function);
+                else
+                    ::operator delete(function);
+            }
+
+            static constexpr Operations operations = { &Invoke, &Move, &Destroy };
+        };
+
+        alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+        const Operations* operations = nullptr;
+
+    public:
+        InlineTask() = default;
+
+        template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InlineTask>>>
+        InlineTask(F&& function)
+        {
+            using Function = std::decay_t<F>;
+            static_assert(alignof(Function) <= alignof(std::max_align_t), "Over-aligned callables are not supported");
+
+            if constexpr (sizeof(Function) <= INLINE_SIZE && std::is_nothrow_move_constructible_v<Function>)
+            {
+                new (storage) Function(std::forward<F>(function));
+                operations = &InlineOperations<Function>::operations;
+            }
+            else
+            {
+                void* memory = sizeof(Function) <= TaskBlockPool::BLOCK_SIZE ? TaskBlockPool::Allocate() : ::operator new(sizeof(Function));
+
+                *(Function**)storage = new (memory) Function(std::forward<F>(function));
+                operations = &PooledOperations<Function>::operations;
+            }
+        }
+
+        InlineTask(InlineTask&& other) noexcept
+        {
+            MoveFrom(other);
+        }
+
+        InlineTask& operator=(InlineTask&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                MoveFrom(other);
+            }
+
+            return *this;
+        }
+
+        InlineTask(const InlineTask&) = delete;
+        InlineTask& operator=(const InlineTask&) = delete;
+
+        ~InlineTask()
+        {
+            Reset();
+        }
+
+        inline void operator()() { operations->invoke(storage); }
+        inline explicit operator bool() const { return operations != nullptr; }
+
+        inline void Reset()
+        {
+            if (!operations) return;
+
+            operations->destroy(storage);
+            operations = nullptr;
+        }
+
+    private:
+        inline void MoveFrom(InlineTask& other)
+        {
+            if (!other.operations) return;
+
+            other.operations->move(storage, other.storage);
+            operations = other.operations;
+            other.operations = nullptr;
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "MappedFile.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Seidon
+{
+#ifdef _WIN32
+	MappedFile::MappedFile(const std::string& path)
+	{
+		fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+		if (fileHandle == INVALID_HANDLE_VALUE)
+		{
+			fileHandle = nullptr;
+			std::cerr << "Couldn't open " << path << std::endl;
+			return;
+		}
+
+		LARGE_INTEGER fileSize;
+		GetFileSizeEx(fileHandle, &fileSize);
+		size = (size_t)fileSize.QuadPart;
+
+		open = true;
+
+		// Empty files can't be mapped, they are open with no data
+		if (size == 0) return;
+
+		mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mappingHandle)
+			data = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+		if (!data)
+		{
+			std::cerr << "Couldn't map " << path << std::endl;
+			size = 0;
+			open = false;
+		}
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (data) UnmapViewOfFile(data);
+		if (mappingHandle) CloseHandle(mappingHandle);
+		if (fileHandle) CloseHandle(fileHandle);
+	}
+#else
+	MappedFile::MappedFile(const std::string& path)
+	{
+		descriptor = ::open(path.c_str(), O_RDONLY);
+
+		if (descriptor < 0)
+		{
+			std::cerr << "Couldn't open " << path << std::endl;
+			return;
+		}
+
+		struct stat status;
+		fstat(descriptor, &status);
+		size = (size_t)status.st_size;
+
+		open = true;
+
+		if (size == 0) return;
+
+		void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+		if (mapping == MAP_FAILED)
+		{
+			std::cerr << "Couldn't map " << path << std::endl;
+			size = 0;
+			open = false;
+			return;
+		}
+
+		data = (const char*)mapping;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (data) munmap((void*)data, size);
+		if (descriptor >= 0) close(descriptor);
+	}
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+
+namespace Seidon
+{
+	// Read-only view of a whole file mapped in memory, the pages are only read from disk when touched
+	class MappedFile
+	{
+	private:
+		const char* data = nullptr;
+		size_t size = 0;
+		bool open = false;
+
+#ifdef _WIN32
+		void* fileHandle = nullptr;
+		void* mappingHandle = nullptr;
+#else
+		int descriptor = -1;
+#endif
+
+	public:
+		MappedFile(const std::string& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		inline bool IsOpen() const { return open; }
+		inline const char* GetData() const { return data; }
+		inline size_t GetSize() const { return size; }
+	};
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+#include "BlockPool.h"
+
+namespace Seidon
+{
+    /*
+    * Lock-free queue with many producers and a single consumer (Vyukov's intrusive MPSC design).
+    * Producers only swap the head pointer, so pushing never blocks. TryPop must only be called
+    * from the consumer thread. Nodes come from a BlockPool, they are allocated by the producers and freed by the consumer.
+    */
+    template<typename T>
+    class MpscQueue {
+    private:
+        struct Node
+        {
+            T value;
+            std::atomic<Node*> next{ nullptr };
+        };
+
+        std::atomic<Node*> head;
+        Node* tail;
+
+        std::atomic<int> size{ 0 };
+
+        using NodePool = BlockPool<sizeof(Node)>;
+
+        static inline Node* CreateNode() { return new (NodePool::Allocate()) Node(); }
+
+        static inline void DestroyNode(Node* node)
+        {
+            node->~Node();
+            NodePool::Release(node);
+        }
+
+    public:
+        MpscQueue()
+        {
+            Node* stub = CreateNode();
+            head.store(stub, std::memory_order_relaxed);
+            tail = stub;
+        }
+
+        ~MpscQueue()
+        {
+            T item;
+            while (TryPop(item));
+
+            DestroyNode(tail);
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        inline int GetSize() const { return size.load(std::memory_order_relaxed); }
+        inline bool IsEmpty() const { return tail->next.load(std::memory_order_acquire) == nullptr; }
+
+        inline void Push(T item)
+        {
+            Node* node = CreateNode();
+            node->value = std::move(item);
+
+            size.fetch_add(1, std::memory_order_relaxed);
+
+            Node* previous = head.exchange(node, std::memory_order_acq_rel);
+            previous->next.store(node, std::memory_order_release);
+        }
+
+        inline bool TryPop(T& res)
+        {
+            Node* next = tail->next.load(std::memory_order_acquire);
+
+            if (!next)
+                return false;
+
+            res = std::move(next->value);
+
+            // The popped node becomes the new stub
+            DestroyNode(tail);
+            tail = next;
+
+            size.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    };
+}
\ No newline at end of file
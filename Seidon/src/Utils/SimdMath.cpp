@@ -0,0 +1,165 @@
+#include "SimdMath.h"
+
+namespace Seidon
+{
+	static inline glm::mat4 ComposeTransform(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+	{
+		glm::mat3 axes = glm::mat3_cast(rotation);
+
+		return glm::mat4(
+			glm::vec4(axes[0] * scale.x, 0.0f),
+			glm::vec4(axes[1] * scale.y, 0.0f),
+			glm::vec4(axes[2] * scale.z, 0.0f),
+			glm::vec4(position, 1.0f)
+		);
+	}
+
+#ifdef SD_SIMD_SSE
+	// Writes the columns held by x, y, z, w (one lane per matrix) to the same column of 4 consecutive matrices
+	static inline void StoreColumns(glm::mat4* out, int column, __m128 x, __m128 y, __m128 z, __m128 w)
+	{
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+
+		_mm_storeu_ps(&out[0][column][0], x);
+		_mm_storeu_ps(&out[1][column][0], y);
+		_mm_storeu_ps(&out[2][column][0], z);
+		_mm_storeu_ps(&out[3][column][0], w);
+	}
+
+	void ComposeTransforms(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* out, size_t count)
+	{
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 two = _mm_set1_ps(2.0f);
+		const __m128 zero = _mm_setzero_ps();
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const glm::vec3* p = positions + i;
+			const glm::vec3* s = scales + i;
+
+			// One quaternion component of the 4 transforms per register
+			__m128 x = _mm_loadu_ps(&rotations[i].x);
+			__m128 y = _mm_loadu_ps(&rotations[i + 1].x);
+			__m128 z = _mm_loadu_ps(&rotations[i + 2].x);
+			__m128 w = _mm_loadu_ps(&rotations[i + 3].x);
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+
+			__m128 xx = _mm_mul_ps(x, x);
+			__m128 yy = _mm_mul_ps(y, y);
+			__m128 zz = _mm_mul_ps(z, z);
+			__m128 xy = _mm_mul_ps(x, y);
+			__m128 xz = _mm_mul_ps(x, z);
+			__m128 yz = _mm_mul_ps(y, z);
+			__m128 wx = _mm_mul_ps(w, x);
+			__m128 wy = _mm_mul_ps(w, y);
+			__m128 wz = _mm_mul_ps(w, z);
+
+			__m128 scaleX = _mm_setr_ps(s[0].x, s[1].x, s[2].x, s[3].x);
+			__m128 scaleY = _mm_setr_ps(s[0].y, s[1].y, s[2].y, s[3].y);
+			__m128 scaleZ = _mm_setr_ps(s[0].z, s[1].z, s[2].z, s[3].z);
+
+			// Same terms as glm::mat3_cast, each rotation column multiplied by its scale
+			__m128 m00 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), scaleX);
+			__m128 m01 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), scaleX);
+			__m128 m02 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), scaleX);
+
+			__m128 m10 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), scaleY);
+			__m128 m11 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), scaleY);
+			__m128 m12 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), scaleY);
+
+			__m128 m20 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), scaleZ);
+			__m128 m21 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), scaleZ);
+			__m128 m22 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), scaleZ);
+
+			__m128 px = _mm_setr_ps(p[0].x, p[1].x, p[2].x, p[3].x);
+			__m128 py = _mm_setr_ps(p[0].y, p[1].y, p[2].y, p[3].y);
+			__m128 pz = _mm_setr_ps(p[0].z, p[1].z, p[2].z, p[3].z);
+
+			StoreColumns(out + i, 0, m00, m01, m02, zero);
+			StoreColumns(out + i, 1, m10, m11, m12, zero);
+			StoreColumns(out + i, 2, m20, m21, m22, zero);
+			StoreColumns(out + i, 3, px, py, pz, one);
+		}
+
+		for (; i < count; i++)
+			out[i] = ComposeTransform(positions[i], rotations[i], scales[i]);
+	}
+
+	void TransformAabbs(const Aabb* boxes, const glm::mat4* matrices, Aabb* out, size_t count)
+	{
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const glm::mat4& matrix = matrices[i];
+
+			__m128 min = _mm_setr_ps(boxes[i].min.x, boxes[i].min.y, boxes[i].min.z, 0.0f);
+			__m128 max = _mm_setr_ps(boxes[i].max.x, boxes[i].max.y, boxes[i].max.z, 0.0f);
+
+			__m128 center = _mm_mul_ps(_mm_add_ps(min, max), half);
+			__m128 extent = _mm_mul_ps(_mm_sub_ps(max, min), half);
+
+			__m128 column0 = _mm_loadu_ps(&matrix[0][0]);
+			__m128 column1 = _mm_loadu_ps(&matrix[1][0]);
+			__m128 column2 = _mm_loadu_ps(&matrix[2][0]);
+			__m128 column3 = _mm_loadu_ps(&matrix[3][0]);
+
+			// Center transformed as a point, extent by the absolute values of the 3x3 part
+			__m128 newCenter = _mm_add_ps(column3, _mm_mul_ps(column0, _mm_shuffle_ps(center, center, _MM_SHUFFLE(0, 0, 0, 0))));
+			newCenter = _mm_add_ps(newCenter, _mm_mul_ps(column1, _mm_shuffle_ps(center, center, _MM_SHUFFLE(1, 1, 1, 1))));
+			newCenter = _mm_add_ps(newCenter, _mm_mul_ps(column2, _mm_shuffle_ps(center, center, _MM_SHUFFLE(2, 2, 2, 2))));
+
+			__m128 newExtent = _mm_mul_ps(_mm_andnot_ps(signMask, column0), _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(0, 0, 0, 0)));
+			newExtent = _mm_add_ps(newExtent, _mm_mul_ps(_mm_andnot_ps(signMask, column1), _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(1, 1, 1, 1))));
+			newExtent = _mm_add_ps(newExtent, _mm_mul_ps(_mm_andnot_ps(signMask, column2), _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(2, 2, 2, 2))));
+
+			float newMin[4];
+			float newMax[4];
+			_mm_storeu_ps(newMin, _mm_sub_ps(newCenter, newExtent));
+			_mm_storeu_ps(newMax, _mm_add_ps(newCenter, newExtent));
+
+			out[i].min = glm::vec3(newMin[0], newMin[1], newMin[2]);
+			out[i].max = glm::vec3(newMax[0], newMax[1], newMax[2]);
+		}
+	}
+#else
+	static inline Aabb TransformAabb(const Aabb& box, const glm::mat4& matrix)
+	{
+		glm::vec3 center = (box.min + box.max) * 0.5f;
+		glm::vec3 extent = (box.max - box.min) * 0.5f;
+
+		glm::vec3 newCenter = matrix * glm::vec4(center, 1.0f);
+		glm::vec3 newExtent = glm::abs(glm::vec3(matrix[0])) * extent.x
+			+ glm::abs(glm::vec3(matrix[1])) * extent.y
+			+ glm::abs(glm::vec3(matrix[2])) * extent.z;
+
+		return { newCenter - newExtent, newCenter + newExtent };
+	}
+
+	void ComposeTransforms(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* out, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+			out[i] = ComposeTransform(positions[i], rotations[i], scales[i]);
+	}
+
+	void TransformAabbs(const Aabb* boxes, const glm::mat4* matrices, Aabb* out, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+			out[i] = TransformAabb(boxes[i], matrices[i]);
+	}
+#endif
+
+	void MultiplyMatrices(const glm::mat4* a, const glm::mat4* b, glm::mat4* out, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+			out[i] = MultiplyMatrix(a[i], b[i]);
+	}
+
+	void MultiplyHierarchy(const glm::mat4* local, const int* parents, glm::mat4* out, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+			out[i] = parents[i] < 0 ? local[i] : MultiplyMatrix(out[parents[i]], local[i]);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define SD_SIMD_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace Seidon
+{
+	struct Aabb
+	{
+		glm::vec3 min = { 0.0f, 0.0f, 0.0f };
+		glm::vec3 max = { 0.0f, 0.0f, 0.0f };
+	};
+
+	/*
+	* Batch transform math on plain arrays, 4 transforms at a time with SSE (the x64 baseline) and
+	* plain glm elsewhere. Results match glm up to float rounding. Arrays don't need any alignment.
+	*/
+
+	// out[i] = translate(positions[i]) * rotate(rotations[i]) * scale(scales[i])
+	void ComposeTransforms(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* out, size_t count);
+
+	// out[i] = a[i] * b[i], out can be a or b
+	void MultiplyMatrices(const glm::mat4* a, const glm::mat4* b, glm::mat4* out, size_t count);
+
+	// out[i] = out[parents[i]] * local[i], or local[i] when parents[i] is negative. Parents must come before their children
+	void MultiplyHierarchy(const glm::mat4* local, const int* parents, glm::mat4* out, size_t count);
+
+	// Smallest boxes containing boxes[i] transformed by matrices[i]
+	void TransformAabbs(const Aabb* boxes, const glm::mat4* matrices, Aabb* out, size_t count);
+
+	// Single matrix product, for loops that depend on the previous result and can't be batched
+	inline glm::mat4 MultiplyMatrix(const glm::mat4& a, const glm::mat4& b)
+	{
+#ifdef SD_SIMD_SSE
+		__m128 a0 = _mm_loadu_ps(&a[0][0]);
+		__m128 a1 = _mm_loadu_ps(&a[1][0]);
+		__m128 a2 = _mm_loadu_ps(&a[2][0]);
+		__m128 a3 = _mm_loadu_ps(&a[3][0]);
+
+		glm::mat4 result;
+		for (int i = 0; i < 4; i++)
+		{
+			__m128 column = _mm_mul_ps(a0, _mm_set1_ps(b[i][0]));
+			column = _mm_add_ps(column, _mm_mul_ps(a1, _mm_set1_ps(b[i][1])));
+			column = _mm_add_ps(column, _mm_mul_ps(a2, _mm_set1_ps(b[i][2])));
+			column = _mm_add_ps(column, _mm_mul_ps(a3, _mm_set1_ps(b[i][3])));
+
+			_mm_storeu_ps(&result[i][0], column);
+		}
+
+		return result;
+#else
+		return a * b;
+#endif
+	}
+}
\ No newline at end of file
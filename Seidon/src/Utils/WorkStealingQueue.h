@@ -0,0 +1,62 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+
+namespace Seidon
+{
+    /*
+    * Double ended queue owned by a single worker thread. The owner pushes and pops
+    * from the back (LIFO, cache friendly), other workers steal from the front (FIFO).
+    * Each worker has its own instance, so the lock is only contended when stealing.
+    */
+    template<typename T>
+    class WorkStealingQueue {
+    private:
+        std::deque<T> queue;
+        mutable std::mutex mutex;
+
+    public:
+        inline int GetSize() const
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            return queue.size();
+        }
+
+        inline bool IsEmpty() const
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            return queue.empty();
+        }
+
+        inline void Push(T item)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queue.push_back(std::move(item));
+        }
+
+        inline bool TryPop(T& res)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            if (queue.empty())
+                return false;
+
+            res = std::move(queue.back());
+            queue.pop_back();
+            return true;
+        }
+
+        inline bool TrySteal(T& res)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            if (queue.empty())
+                return false;
+
+            res = std::move(queue.front());
+            queue.pop_front();
+            return true;
+        }
+    };
+}
\ No newline at end of file
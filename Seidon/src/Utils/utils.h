@@ -1,6 +1,14 @@
 #pragma once
 
 #include "BlockingQueue.h"
+#include "WorkStealingQueue.h"
+#include "MpscQueue.h"
+#include "InlineTask.h"
+#include "BlockPool.h"
+#include "MappedFile.h"
+#include "BinaryReader.h"
+#include "BinaryWriter.h"
 #include "MatrixDecompose.h"
+#include "SimdMath.h"
 #include "AssetImporter.h"
 #include "StringUtils.h"
\ No newline at end of file